@@ -0,0 +1,78 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures Parser::Complete on a large grammar. The target is under 1ms per query for 5,000
+// options.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const int kOptionCount = 5000;
+
+// Every this many options takes one of a fixed set of values
+const int kChoiceInterval = 10;
+
+// Holds the values of the grammar's parameters
+struct Values {
+    std::vector<int> options = std::vector<int>(kOptionCount);
+    std::string file;
+};
+
+// Builds a grammar of |kOptionCount| long form options followed by a required positional file
+ahoy::Parser LargeGrammar(Values* values) {
+    std::vector<ahoy::Parameter> options;
+    options.reserve(kOptionCount);
+    for (int i = 0; i < kOptionCount; i++) {
+        const std::string name = "option-" + std::to_string(i);
+        if (i % kChoiceInterval == 0) {
+            options.emplace_back(&values->options[i], ahoy::LongForms({name}),
+                    ahoy::Description("Option " + std::to_string(i)),
+                    ahoy::Choices({ { "low", 1 }, { "medium", 2 }, { "high", 3 } }));
+        } else {
+            options.emplace_back(&values->options[i], ahoy::LongForms({name}),
+                    ahoy::Description("Option " + std::to_string(i)));
+        }
+    }
+    const std::vector<ahoy::Parameter>& const_options = options;
+    return ahoy::Parser()
+            .withOptions(const_options)
+            .then(ahoy::Parameter(&values->file, ahoy::Name("file"), ahoy::Required()));
+}
+
+// Completes the last of |args|, which excludes the program name
+void Complete(benchmark::State& state, const std::vector<const char*>& args) {
+    Values values;
+    const ahoy::Parser parser = LargeGrammar(&values);
+
+    std::vector<const char*> argv{ "program" };
+    argv.insert(argv.end(), args.begin(), args.end());
+    const int argc = static_cast<int>(argv.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Complete(argc, argv.data(), argc - 1));
+    }
+}
+
+void BM_CompleteForm(benchmark::State& state) {
+    Complete(state, { "--option-1", "3", "--option-2=4", "--option-49" });
+}
+BENCHMARK(BM_CompleteForm)->Unit(benchmark::kMicrosecond);
+
+void BM_CompleteChoice(benchmark::State& state) {
+    Complete(state, { "--option-1", "3", "--option-2=4", "--option-40", "m" });
+}
+BENCHMARK(BM_CompleteChoice)->Unit(benchmark::kMicrosecond);
+
+void BM_CompleteChoiceWithForm(benchmark::State& state) {
+    Complete(state, { "--option-1", "3", "--option-2=4", "--option-40=" });
+}
+BENCHMARK(BM_CompleteChoiceWithForm)->Unit(benchmark::kMicrosecond);
+
+} // namespace
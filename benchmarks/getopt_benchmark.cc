@@ -0,0 +1,122 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures scanning the same argv with glibc's getopt_long and with ahoy_getopt_long, for a table
+// the size of a typical GNU tool's and for one with a few hundred long options.
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/getopt.h"
+
+namespace {
+
+// The long options of a file copying tool, each also with a short form if its value is below 128
+const std::vector<std::pair<const char*, int>> kOptions{
+    { "verbose", 'v' }, { "quiet", 'q' }, { "checksum", 'c' }, { "archive", 'a' },
+    { "recursive", 'r' }, { "relative", 'R' }, { "backup", 'b' }, { "backup-dir", 1000 },
+    { "suffix", 1001 }, { "update", 'u' }, { "inplace", 1002 }, { "append", 1003 },
+    { "dirs", 'd' }, { "links", 'l' }, { "copy-links", 'L' }, { "hard-links", 'H' },
+    { "perms", 'p' }, { "executability", 'E' }, { "owner", 'o' }, { "group", 'g' },
+    { "devices", 1004 }, { "specials", 1005 }, { "times", 't' }, { "dry-run", 'n' },
+    { "whole-file", 'W' }, { "one-file-system", 'x' }, { "block-size", 'B' }, { "rsh", 'e' },
+    { "rsync-path", 1006 }, { "existing", 1007 }, { "ignore-existing", 1008 },
+    { "remove-source-files", 1009 }, { "delete", 1010 }, { "delete-before", 1011 },
+    { "delete-during", 1012 }, { "delete-after", 1013 }, { "delete-excluded", 1014 },
+    { "max-delete", 1015 }, { "max-size", 1016 }, { "min-size", 1017 }, { "partial", 1018 },
+    { "partial-dir", 1019 }, { "timeout", 1020 }, { "compress", 'z' }, { "compress-level", 1021 },
+    { "exclude", 1022 }, { "exclude-from", 1023 }, { "include", 1024 }, { "include-from", 1025 },
+    { "files-from", 1026 }, { "port", 1027 }, { "stats", 1028 }, { "progress", 1029 },
+    { "log-file", 1030 }, { "password-file", 1031 }, { "bwlimit", 1032 }, { "help", 'h' },
+};
+
+// The options of kOptions that take a value
+const std::vector<std::string> kValued{ "backup-dir", "suffix", "block-size", "rsh", "rsync-path",
+                                        "max-delete", "max-size", "min-size", "partial-dir",
+                                        "timeout", "compress-level", "exclude", "exclude-from",
+                                        "include", "include-from", "files-from", "port",
+                                        "log-file", "password-file", "bwlimit" };
+
+const char kOptstring[] = "vqcarRbudlLHpEogtnWxB:e:zh";
+
+// A struct option table built from kOptions, padded with |extra| more options that are never
+// passed, and the strings it points to
+class Table {
+  public:
+    explicit Table(const std::size_t extra) : names_(), options_() {
+        for (const auto& option : kOptions) {
+            names_.push_back(option.first);
+        }
+        for (std::size_t i = 0; i < extra; i++) {
+            names_.push_back("generated-option-" + std::to_string(i));
+        }
+        for (std::size_t i = 0; i < names_.size(); i++) {
+            const bool valued = std::find(kValued.begin(), kValued.end(), names_[i]) !=
+                    kValued.end();
+            const int val = i < kOptions.size() ? kOptions[i].second : static_cast<int>(2000 + i);
+            options_.push_back({ names_[i].c_str(), valued ? required_argument : no_argument,
+                                 nullptr, val });
+        }
+        options_.push_back({ nullptr, 0, nullptr, 0 });
+    }
+
+    const struct option* options() const {
+        return options_.data();
+    }
+
+  private:
+    std::vector<std::string> names_;
+    std::vector<struct option> options_;
+};
+
+// A command line mixing long options, with and without '=', abbreviations, groups of short options
+// and operands that getopt_long moves to the end
+const std::vector<std::string> kArgs{
+    "rsync", "-avz", "--progress", "--delete-after", "--exclude=*.o", "--exclude", "*.tmp",
+    "--include-from=rules.txt", "src/", "--partial-dir=.partial", "--timeout", "30",
+    "--bwlimit=1000", "-e", "ssh -p 2222", "--max-size=10m", "--stats", "--compress-level=9",
+    "--checksum", "--hard-links", "--one-file", "--dry", "--log-file=/tmp/rsync.log", "-H",
+    "--backup", "--backup-dir=old", "--suffix=.bak", "--port=873", "--files-from", "list.txt",
+    "--ignore-existing", "--delete-excluded", "--whole-file", "dest:/backup/",
+};
+
+// Scans kArgs with |getopt| after resetting |optind|, for a table padded by |state.range(0)|
+template<typename GetoptLong>
+void Scan(benchmark::State& state, GetoptLong getopt, int* const index) {
+    const Table table(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::string> args(kArgs);
+    std::vector<char*> argv;
+    for (std::string& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    const int argc = static_cast<int>(kArgs.size());
+
+    for (auto _ : state) {
+        *index = 0;
+        int options = 0;
+        while (getopt(argc, argv.data(), kOptstring, table.options(), nullptr) != -1) {
+            options++;
+        }
+        benchmark::DoNotOptimize(options);
+    }
+    state.SetItemsProcessed(state.iterations() * argc);
+}
+
+void BM_GlibcGetoptLong(benchmark::State& state) {
+    Scan(state, &getopt_long, &optind);
+}
+BENCHMARK(BM_GlibcGetoptLong)->Arg(0)->Arg(256);
+
+void BM_AhoyGetoptLong(benchmark::State& state) {
+    Scan(state, &ahoy_getopt_long, &ahoy_optind);
+}
+BENCHMARK(BM_AhoyGetoptLong)->Arg(0)->Arg(256);
+
+} // namespace
@@ -0,0 +1,76 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures parsing a command line against a tool with 64 options and a subcommand, where the few
+// options that are actually used were declared last, before and after reordering the options by
+// how often they matched. The subcommand keeps the grammar from being flat, so its options are
+// tried one after another rather than looked up by form.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const int kOptionCount = 64;
+
+// The options, of which the last four are used by every command line
+struct Tool {
+    std::unique_ptr<std::string[]> values;
+    std::string command;
+    ahoy::Parser parser;
+
+    Tool() : values(new std::string[kOptionCount]), command(), parser() {
+        std::vector<ahoy::Parameter> options;
+        for (int i = 0; i < kOptionCount; i++) {
+            options.push_back(ahoy::Parameter(&values[i],
+                                              ahoy::LongForms({ "option-" + std::to_string(i) })));
+        }
+        const std::vector<ahoy::Parameter>& const_options = options;
+        parser.withOptions(const_options).then(ahoy::Parameter(&command, ahoy::Name("command")));
+    }
+};
+
+const std::vector<const char*>& Arguments() {
+    static const std::vector<const char*> argv{
+        "program", "--option-60", "a", "--option-61", "b", "--option-62", "c", "--option-63", "d",
+        "run" };
+    return argv;
+}
+
+void Parse(benchmark::State& state, const ahoy::Parser& parser) {
+    const std::vector<const char*>& argv = Arguments();
+    const int argc = static_cast<int>(argv.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(argc, argv.data()));
+    }
+}
+
+void BM_ParseDeclaredOrder(benchmark::State& state) {
+    Tool tool;
+    Parse(state, tool.parser);
+}
+BENCHMARK(BM_ParseDeclaredOrder);
+
+void BM_ParseCounted(benchmark::State& state) {
+    Tool tool;
+    tool.parser.withHitCounters(true);
+    Parse(state, tool.parser);
+}
+BENCHMARK(BM_ParseCounted);
+
+void BM_ParseReordered(benchmark::State& state) {
+    Tool tool;
+    tool.parser.withHitCounters(true);
+    const std::vector<const char*>& argv = Arguments();
+    tool.parser.Parse(static_cast<int>(argv.size()), argv.data());
+    tool.parser.Reorder();
+    Parse(state, tool.parser);
+}
+BENCHMARK(BM_ParseReordered);
+
+} // namespace
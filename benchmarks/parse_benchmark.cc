@@ -0,0 +1,97 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures Parser::Parse on a flat grammar of options and on a nested grammar of a positional
+// parameter with chained options. Built twice, against //:ahoy and //:ahoy_header_only, to compare
+// calling the conversions in assign.cc with inlining them into the parse loop. The Cached cases
+// parse the same arguments with Parser::withParseCache, so every parse after the first is a hit.
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const char kProgram[] = "./program";
+
+// Holds the values of both grammars' parameters
+struct Values {
+    bool verbose = false;
+    int iterations = 0;
+    long long offset = 0;
+    unsigned int threads = 0;
+    double ratio = 0;
+    std::string name;
+    std::string file;
+};
+
+// Builds a grammar of options only, each of a different type
+ahoy::Parser FlatGrammar(Values* v) {
+    return ahoy::Parser().withOptions(
+            ahoy::Parameter(&v->verbose, ahoy::ShortForms({"v"}), ahoy::Flag()),
+            ahoy::Parameter(&v->iterations, ahoy::LongForms({"iterations"})),
+            ahoy::Parameter(&v->offset, ahoy::LongForms({"offset"})),
+            ahoy::Parameter(&v->threads, ahoy::LongForms({"threads"})),
+            ahoy::Parameter(&v->ratio, ahoy::LongForms({"ratio"})),
+            ahoy::Parameter(&v->name, ahoy::LongForms({"name"})));
+}
+
+// Builds a grammar of a required file followed by options that are each only available after the
+// previous one
+ahoy::Parser NestedGrammar(Values* v) {
+    return ahoy::Parser().then(
+            ahoy::Parameter(&v->file, ahoy::Required()).withOptions(
+                ahoy::Parameter(&v->iterations, ahoy::LongForms({"iterations"})).withOptions(
+                    ahoy::Parameter(&v->offset, ahoy::LongForms({"offset"})).withOptions(
+                        ahoy::Parameter(&v->ratio, ahoy::LongForms({"ratio"})).withOptions(
+                            ahoy::Parameter(&v->verbose, ahoy::LongForms({"verbose"}),
+                                    ahoy::Flag()))))));
+}
+
+// Parses |args|, which exclude the program name, with the grammar built by |grammar|, caching
+// the results if |cache| is set
+void Parse(benchmark::State& state, ahoy::Parser grammar(Values*),
+        const std::vector<const char*>& args, const bool cache = false) {
+    Values values;
+    ahoy::Parser parser = grammar(&values);
+    if (cache) {
+        parser.withParseCache(16);
+    }
+
+    std::vector<const char*> argv{ kProgram };
+    argv.insert(argv.end(), args.begin(), args.end());
+    const int argc = static_cast<int>(argv.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(argc, argv.data()));
+    }
+}
+
+void BM_ParseFlat(benchmark::State& state) {
+    Parse(state, &FlatGrammar, { "-v", "--iterations=30", "--offset", "-12", "--threads=8",
+            "--ratio", "0.25", "--name=benchmark" });
+}
+BENCHMARK(BM_ParseFlat);
+
+void BM_ParseNested(benchmark::State& state) {
+    Parse(state, &NestedGrammar, { "file.txt", "--iterations=30", "--offset", "-12", "--ratio=0.25",
+            "--verbose" });
+}
+BENCHMARK(BM_ParseNested);
+
+void BM_ParseFlatCached(benchmark::State& state) {
+    Parse(state, &FlatGrammar, { "-v", "--iterations=30", "--offset", "-12", "--threads=8",
+            "--ratio", "0.25", "--name=benchmark" }, true);
+}
+BENCHMARK(BM_ParseFlatCached);
+
+void BM_ParseNestedCached(benchmark::State& state) {
+    Parse(state, &NestedGrammar, { "file.txt", "--iterations=30", "--offset", "-12",
+            "--ratio=0.25", "--verbose" }, true);
+}
+BENCHMARK(BM_ParseNestedCached);
+
+} // namespace
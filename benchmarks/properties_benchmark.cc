@@ -0,0 +1,63 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures parsing 10,000 -Dname=value properties, as passed to JVM-style launchers, into
+// ahoy::Properties that either copy the keys and values or borrow them from argv.
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const int kPropertyCount = 10000;
+
+// Parses |kPropertyCount| properties and a few other options, borrowing from argv if |borrow|
+void ParseProperties(benchmark::State& state, const bool borrow) {
+    ahoy::Properties properties;
+    bool verbose = false;
+    std::string main_class;
+    ahoy::Parser parser;
+    if (borrow) {
+        parser.withOptions(ahoy::Parameter(&properties, ahoy::ShortForms({"D"}),
+                                           ahoy::BorrowArgv()),
+                           ahoy::Parameter(&verbose, ahoy::ShortForms({"verbose"}), ahoy::Flag()),
+                           ahoy::Parameter(&main_class, ahoy::ShortForms({"main"})));
+    } else {
+        parser.withOptions(ahoy::Parameter(&properties, ahoy::ShortForms({"D"})),
+                           ahoy::Parameter(&verbose, ahoy::ShortForms({"verbose"}), ahoy::Flag()),
+                           ahoy::Parameter(&main_class, ahoy::ShortForms({"main"})));
+    }
+
+    std::vector<std::string> args{ "program", "-verbose", "-main", "com.example.Main" };
+    for (int i = 0; i < kPropertyCount; i++) {
+        args.push_back("-Dcom.example.property." + std::to_string(i) + "=value-" +
+                       std::to_string(i));
+    }
+    std::vector<const char*> argv;
+    for (const std::string& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+    const int argc = static_cast<int>(argv.size());
+
+    for (auto _ : state) {
+        properties.clear();
+        benchmark::DoNotOptimize(parser.Parse(argc, argv.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * kPropertyCount);
+}
+
+void BM_ParsePropertiesCopied(benchmark::State& state) {
+    ParseProperties(state, false);
+}
+BENCHMARK(BM_ParsePropertiesCopied)->Unit(benchmark::kMicrosecond);
+
+void BM_ParsePropertiesBorrowed(benchmark::State& state) {
+    ParseProperties(state, true);
+}
+BENCHMARK(BM_ParsePropertiesBorrowed)->Unit(benchmark::kMicrosecond);
+
+} // namespace
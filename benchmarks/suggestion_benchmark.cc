@@ -0,0 +1,51 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures the cost of suggesting forms for an unmatched argument on a grammar of 5,000 forms. The
+// difference between the two benchmarks is the time spent on suggestions.
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const int kOptionCount = 5000;
+
+// Builds a grammar of |kOptionCount| long form options
+ahoy::Parser LargeGrammar(std::vector<int>* values) {
+    std::vector<ahoy::Parameter> options;
+    options.reserve(kOptionCount);
+    for (int i = 0; i < kOptionCount; i++) {
+        options.emplace_back(&(*values)[i], ahoy::LongForms({"option-" + std::to_string(i)}));
+    }
+    const std::vector<ahoy::Parameter>& const_options = options;
+    return ahoy::Parser().withOptions(const_options);
+}
+
+// Parses a mistyped form, collecting suggestions if |suggest| is set
+void Mistyped(benchmark::State& state, const bool suggest) {
+    std::vector<int> values(kOptionCount);
+    const ahoy::Parser parser = LargeGrammar(&values);
+    const char* const argv[] = { "program", "--option-1", "3", "--optoin-4321" };
+
+    ahoy::ParseResult result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(4, argv, nullptr, suggest ? &result : nullptr));
+    }
+}
+
+void BM_MistypedWithoutSuggestions(benchmark::State& state) {
+    Mistyped(state, false);
+}
+BENCHMARK(BM_MistypedWithoutSuggestions)->Unit(benchmark::kMicrosecond);
+
+void BM_MistypedWithSuggestions(benchmark::State& state) {
+    Mistyped(state, true);
+}
+BENCHMARK(BM_MistypedWithSuggestions)->Unit(benchmark::kMicrosecond);
+
+} // namespace
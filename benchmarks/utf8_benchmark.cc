@@ -0,0 +1,72 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures parsing a single 4 MiB string argument, like one read from a response file, with and
+// without ahoy::ValidateUtf8. The difference between the benchmarks is the cost of validation.
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const std::size_t kArgumentSize = 4 << 20;
+
+// Builds a valid argument of |kArgumentSize| bytes. Every |stride| bytes, an ASCII character is
+// replaced by the two byte encoding of U+00E9, or none are if |stride| is 0.
+std::string Argument(const std::size_t stride) {
+    std::string argument;
+    argument.reserve(kArgumentSize);
+    while (argument.size() + 2 <= kArgumentSize) {
+        if (stride != 0 && argument.size() % stride == 0) {
+            argument += "\xC3\xA9";
+        } else {
+            argument += static_cast<char>('a' + argument.size() % 26);
+        }
+    }
+    return argument;
+}
+
+// Parses --value with an argument that has a non-ASCII character every |stride| bytes
+void Parse(benchmark::State& state, const bool validate, const std::size_t stride) {
+    std::string value;
+    ahoy::Parser parser;
+    if (validate) {
+        parser.withOptions(ahoy::Parameter(&value, ahoy::LongForms({"value"}),
+                                           ahoy::ValidateUtf8()));
+    } else {
+        parser.withOptions(ahoy::Parameter(&value, ahoy::LongForms({"value"})));
+    }
+
+    const std::string argument = Argument(stride);
+    const char* const argv[] = { "program", "--value", argument.c_str() };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(3, argv));
+    }
+    state.SetBytesProcessed(state.iterations() * argument.size());
+}
+
+void BM_StringAscii(benchmark::State& state) {
+    Parse(state, false, 0);
+}
+BENCHMARK(BM_StringAscii)->Unit(benchmark::kMicrosecond);
+
+void BM_ValidateUtf8Ascii(benchmark::State& state) {
+    Parse(state, true, 0);
+}
+BENCHMARK(BM_ValidateUtf8Ascii)->Unit(benchmark::kMicrosecond);
+
+void BM_ValidateUtf8Text(benchmark::State& state) {
+    // Like accented prose, with a non-ASCII character every 64 bytes
+    Parse(state, true, 64);
+}
+BENCHMARK(BM_ValidateUtf8Text)->Unit(benchmark::kMicrosecond);
+
+void BM_ValidateUtf8Dense(benchmark::State& state) {
+    Parse(state, true, 4);
+}
+BENCHMARK(BM_ValidateUtf8Dense)->Unit(benchmark::kMicrosecond);
+
+} // namespace
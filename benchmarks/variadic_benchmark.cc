@@ -0,0 +1,70 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Measures parsing 200,000 positional values, as passed to tools through xargs or response files,
+// into a repeated positional parameter that matches them one at a time and into an ahoy::Variadic
+// one that converts them all at once.
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ahoy/ahoy_all.h"
+
+namespace {
+
+const int kValueCount = 200000;
+
+// Parses |kValueCount| values into a std::vector<T>, as one ahoy::Variadic if |variadic|
+template<typename T>
+void ParsePositionals(benchmark::State& state, const bool variadic) {
+    std::vector<T> values;
+    bool verbose = false;
+    ahoy::Parser parser;
+    if (variadic) {
+        parser.withOptions(ahoy::Parameter(&verbose, ahoy::ShortForms({"v"}), ahoy::Flag()),
+                           ahoy::Parameter(&values, ahoy::Name("values"), ahoy::Variadic()));
+    } else {
+        parser.withOptions(ahoy::Parameter(&verbose, ahoy::ShortForms({"v"}), ahoy::Flag()),
+                           ahoy::Parameter(&values, ahoy::Name("values")));
+    }
+
+    std::vector<std::string> args{ "program", "-v" };
+    for (int i = 0; i < kValueCount; i++) {
+        args.push_back(std::to_string(i * 7919));
+    }
+    std::vector<const char*> argv;
+    for (const std::string& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+    const int argc = static_cast<int>(argv.size());
+
+    for (auto _ : state) {
+        values.clear();
+        benchmark::DoNotOptimize(parser.Parse(argc, argv.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * kValueCount);
+}
+
+void BM_ParseRepeatedInts(benchmark::State& state) {
+    ParsePositionals<long>(state, false);
+}
+BENCHMARK(BM_ParseRepeatedInts)->Unit(benchmark::kMillisecond);
+
+void BM_ParseVariadicInts(benchmark::State& state) {
+    ParsePositionals<long>(state, true);
+}
+BENCHMARK(BM_ParseVariadicInts)->Unit(benchmark::kMillisecond);
+
+void BM_ParseRepeatedStrings(benchmark::State& state) {
+    ParsePositionals<std::string>(state, false);
+}
+BENCHMARK(BM_ParseRepeatedStrings)->Unit(benchmark::kMillisecond);
+
+void BM_ParseVariadicStrings(benchmark::State& state) {
+    ParsePositionals<std::string>(state, true);
+}
+BENCHMARK(BM_ParseVariadicStrings)->Unit(benchmark::kMillisecond);
+
+} // namespace
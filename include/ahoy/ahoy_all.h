@@ -6,8 +6,16 @@
 #ifndef AHOY_AHOY_ALL_H
 #define AHOY_AHOY_ALL_H
 
+#include <ahoy/argv_span.h>
+#include <ahoy/completion.h>
+#include <ahoy/constraint.h>
+#include <ahoy/flag.h>
 #include <ahoy/options.h>
 #include <ahoy/parameter.h>
+#include <ahoy/parse_result.h>
 #include <ahoy/parser.h>
+#include <ahoy/path.h>
+#include <ahoy/properties.h>
+#include <ahoy/reloader.h>
 
 #endif // AHOY_AHOY_ALL_H
@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_ARGV_SPAN_H
+#define AHOY_AHOY_ARGV_SPAN_H
+
+#include <cstddef>
+
+namespace ahoy {
+
+// A view of a run of the arguments passed to main(), pointing into argv itself rather than copying
+// the arguments. See Parser::withPassthrough.
+class ArgvSpan {
+  public:
+    // An empty span
+    ArgvSpan();
+
+    // The |size| arguments starting at |args|
+    ArgvSpan(char const * const * const args, const std::size_t size);
+
+    ArgvSpan(const ArgvSpan&) = default;
+    ArgvSpan& operator=(const ArgvSpan&) = default;
+
+    virtual ~ArgvSpan();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    // The argument at |index|, which must be less than size()
+    const char* operator[](const std::size_t index) const;
+
+    char const * const * begin() const;
+    char const * const * end() const;
+
+    // The arguments for passing on to execv and friends. As the arguments of main() end with a
+    // null pointer, a span that runs to the end of them is null-terminated without any copying.
+    // The caller must not write through the pointers.
+    char* const* argv() const;
+
+  private:
+    char const * const * args_;
+    std::size_t size_;
+};
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_ARGV_SPAN_H
@@ -0,0 +1,55 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_COMPLETION_H
+#define AHOY_AHOY_COMPLETION_H
+
+#include <ostream>
+#include <string>
+
+namespace ahoy {
+
+// What a Completion offers
+enum class CompletionKind {
+    // A form of a parameter, like --verbose, to insert as is
+    FORM,
+    // A value accepted by a parameter with ahoy::Choices, to insert as is. It includes the form
+    // when completing a value written like --mode=fast.
+    CHOICE,
+    // A hint that a free-form value is expected, holding the parameter's name or type. It is meant
+    // to be shown rather than inserted.
+    VALUE,
+};
+
+// Writes a string form of |kind| to the ostream
+std::ostream& operator<<(std::ostream& os, const CompletionKind& kind);
+
+// A candidate for the argument being completed, as returned by Parser::Complete
+class Completion {
+  public:
+    Completion(const CompletionKind kind, const std::string& value, const std::string& description);
+    virtual ~Completion();
+
+    CompletionKind kind() const;
+
+    // The text of the candidate
+    const std::string& value() const;
+
+    // The description of the parameter the candidate is for
+    const std::string& description() const;
+
+    bool operator ==(const Completion& other) const;
+    bool operator !=(const Completion& other) const;
+
+  private:
+    CompletionKind kind_;
+    std::string value_;
+    std::string description_;
+};
+
+// Writes a string form of |completion| to the ostream
+std::ostream& operator<<(std::ostream& os, const Completion& completion);
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_COMPLETION_H
@@ -0,0 +1,78 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_CONSTRAINT_H
+#define AHOY_AHOY_CONSTRAINT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ahoy {
+
+// How a Constraint relates the parameters it names
+enum class ConstraintKind {
+    // At most one of the parameters may be present
+    EXCLUSIVE,
+    // At least one of the parameters must be present
+    AT_LEAST_ONE,
+    // If the dependent parameter is present, all of the parameters must be too
+    REQUIRES,
+};
+
+// Writes a string form of |kind| to the ostream
+std::ostream& operator<<(std::ostream& os, const ConstraintKind& kind);
+
+// A rule about which parameters may be present together, checked after the arguments were parsed.
+// Parameters are referred to by their ahoy::Name, and a name shared by several parameters refers to
+// all of them. A parameter is present if it matched an argument or took its value from the
+// environment. Use the subclasses below with Parser::withConstraints.
+class Constraint {
+  public:
+    Constraint(const ConstraintKind kind,
+               const std::vector<std::string>& names,
+               const std::string& dependent = std::string());
+    virtual ~Constraint();
+
+    ConstraintKind kind() const;
+
+    // The names of the parameters the constraint is about
+    const std::vector<std::string>& names() const;
+
+    // For ConstraintKind::REQUIRES, the name of the parameter that requires the others
+    const std::string& dependent() const;
+
+    bool operator ==(const Constraint& other) const;
+    bool operator !=(const Constraint& other) const;
+
+  private:
+    ConstraintKind kind_;
+    std::vector<std::string> names_;
+    std::string dependent_;
+};
+
+// Writes a string form of |constraint| to the ostream, like Exclusive(tcp, unix)
+std::ostream& operator<<(std::ostream& os, const Constraint& constraint);
+
+// At most one of the named parameters may be present, like --tcp and --unix
+class Exclusive : public Constraint {
+  public:
+    explicit Exclusive(const std::vector<std::string>& names);
+};
+
+// At least one of the named parameters must be present
+class AtLeastOne : public Constraint {
+  public:
+    explicit AtLeastOne(const std::vector<std::string>& names);
+};
+
+// If |dependent| is present, all of the parameters named |required| must be too, like --tls-key
+// requiring --tls-cert
+class Requires : public Constraint {
+  public:
+    Requires(const std::string& dependent, const std::vector<std::string>& required);
+};
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_CONSTRAINT_H
@@ -0,0 +1,130 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_FLAG_H
+#define AHOY_AHOY_FLAG_H
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "ahoy/parse_result.h"
+#include "ahoy/internal/flag_registry.h"
+#include "ahoy/internal/type.h"
+
+// Defines a flag named |name| of type |Type| in any translation unit, like
+// AHOY_FLAG(int, port, 8080, "The port to listen on"), which ahoy::ParseFlags sets from --port=9000
+// or --port 9000. It must be used at namespace scope and defines AHOY_FLAGS_<name>, whose Get
+// method returns the flag's value. bool flags are set to true by --<name> and take no value.
+//
+// Nothing runs before main() to register the flag. Its value is constant-initialized and a pointer
+// to its constexpr descriptor is placed in the ahoy_flags section, which ParseFlags reads through
+// the __start_ and __stop_ symbols the linker defines for it. Flags are only found in the module
+// ParseFlags is linked into, and flags in static libraries are only linked in if the library is
+// linked as a whole, e.g. with alwayslink = True in Bazel. The section requires an ELF target, so
+// AHOY_FLAG is not defined for others.
+#if defined(__ELF__)
+#define AHOY_FLAG(Type, name, default_value, help) \
+    ::ahoy::FlagValue<Type> AHOY_FLAGS_##name(default_value); \
+    static constexpr ::ahoy::internal::FlagDescriptor ahoy_flag_descriptor_##name = \
+            ::ahoy::FlagValue<Type>::Describe(#name, help, &AHOY_FLAGS_##name); \
+    __attribute__((used, section("ahoy_flags"))) \
+    static const ::ahoy::internal::FlagDescriptor* const ahoy_flag_entry_##name = \
+            &ahoy_flag_descriptor_##name
+#endif
+
+// Declares a flag defined with AHOY_FLAG in another translation unit of the same namespace
+#define AHOY_DECLARE_FLAG(Type, name) \
+    extern ::ahoy::FlagValue<Type> AHOY_FLAGS_##name
+
+namespace ahoy {
+
+// The value of a flag defined with AHOY_FLAG, which any thread may read without locking while
+// ParseFlags publishes new values. bools, numbers and std::chrono durations are held in a
+// std::atomic, and std::strings as below.
+//
+// Flags have no virtual destructor, or any other, so they are constant-initialized and never
+// destroyed.
+template<typename T>
+class FlagValue {
+    typedef internal::TypeOf<T> TypeOfFlag;
+
+    static_assert(TypeOfFlag::value != internal::Type::INVALID,
+                  "Flags may only be bools, numbers, std::strings or std::chrono durations.");
+    static_assert(sizeof(T) <= sizeof(std::uint64_t),
+                  "Flags may not be larger than 8 bytes, like long double.");
+
+  public:
+    constexpr explicit FlagValue(const T default_value) : value_(default_value) {}
+
+    FlagValue(const FlagValue&) = delete;
+    FlagValue& operator=(const FlagValue&) = delete;
+
+    // The current value of the flag, which is its default until ParseFlags sets it
+    T Get() const {
+        return value_.load(std::memory_order_acquire);
+    }
+
+    // Describes |flag| to the registry. This is intended to be called by AHOY_FLAG only.
+    static constexpr internal::FlagDescriptor Describe(const char* const name,
+                                                       const char* const help,
+                                                       FlagValue* const flag) {
+        return { name, help, TypeOfFlag::value, flag, &Load, &Store };
+    }
+
+  private:
+    static void Load(const void* const flag, void* const staging) {
+        new (staging) T(static_cast<const FlagValue*>(flag)->Get());
+    }
+
+    static void Store(void* const flag, const void* const staging) {
+        static_cast<FlagValue*>(flag)->value_.store(*static_cast<const T*>(staging),
+                                                    std::memory_order_release);
+    }
+
+    std::atomic<T> value_;
+};
+
+// std::string flags hold a pointer to their current value, so they can still be constant
+// initialized and read with a single atomic load. The string of the default is only created on
+// first read. Strings replaced by ParseFlags are never freed, so references returned by Get stay
+// valid, which suits flags that are parsed once or a few times.
+template<>
+class FlagValue<std::string> {
+  public:
+    constexpr explicit FlagValue(const char* const default_value) :
+            default_(default_value), value_(nullptr) {}
+
+    FlagValue(const FlagValue&) = delete;
+    FlagValue& operator=(const FlagValue&) = delete;
+
+    // The current value of the flag, which is its default until ParseFlags sets it
+    const std::string& Get() const;
+
+    // Describes |flag| to the registry. This is intended to be called by AHOY_FLAG only.
+    static constexpr internal::FlagDescriptor Describe(const char* const name,
+                                                       const char* const help,
+                                                       FlagValue* const flag) {
+        return { name, help, internal::Type::STRING, flag, &Load, &Store };
+    }
+
+  private:
+    static void Load(const void* flag, void* staging);
+    static void Store(void* flag, const void* staging);
+
+    const char* const default_;
+    mutable std::atomic<const std::string*> value_;
+};
+
+// Parses the arguments from the main() function into the flags defined with AHOY_FLAG anywhere in
+// the program, like Parser::Parse. The first call builds the grammar of the flags. Flags keep their
+// current values unless they are passed in, and no flag changes if parsing fails. Calls are
+// serialized with each other but never block threads reading flags.
+bool ParseFlags(const int argc, char const * const argv[], std::string* program_name = nullptr,
+                ParseResult* result = nullptr);
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_FLAG_H
@@ -0,0 +1,46 @@
+/* Copyright (c) 2018 Dustin Toff */
+/* Licensed under Apache License v2.0 */
+
+/* A C API with the behavior of GNU getopt_long, for migrating programs written against it onto
+ * ahoy one call at a time. Replace getopt_long, optind, optarg, opterr and optopt with their ahoy_
+ * counterparts and the results are the same, including the permutation of argv, the error messages
+ * and the codes returned, but each option table is compiled once and cached by its address, so
+ * long options are found with a binary search rather than by comparing them against every option.
+ *
+ * Like getopt_long, this keeps its state in globals, so only one thread may scan at a time.
+ * Setting ahoy_optind to 0 starts a new scan. The "W;" extension of glibc is not supported. */
+
+#ifndef AHOY_AHOY_GETOPT_H
+#define AHOY_AHOY_GETOPT_H
+
+#include <getopt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The value of the option just returned, or null if it has none */
+extern char* ahoy_optarg;
+
+/* The index in argv of the next argument to scan, which starts at 1 */
+extern int ahoy_optind;
+
+/* If nonzero, the default, errors are printed to stderr */
+extern int ahoy_opterr;
+
+/* The option character that caused the last error */
+extern int ahoy_optopt;
+
+/* Returns the next option in argv like getopt_long: the character of a short option, 0 or the val
+ * of a long option depending on its flag, '?' or ':' on errors, 1 for other arguments when
+ * |optstring| starts with '-', and -1 once there are no more options, with ahoy_optind at the first
+ * argument that is not one. The table for |optstring| and |longopts| is looked up when a scan
+ * starts or the table passed in changes, and compiled if it is new or its contents changed. */
+int ahoy_getopt_long(int argc, char* const argv[], const char* optstring,
+                     const struct option* longopts, int* longindex);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* AHOY_AHOY_GETOPT_H */
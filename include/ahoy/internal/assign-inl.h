@@ -0,0 +1,911 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// The definitions of the conversions declared in assign.h. They are compiled once in assign.cc, or
+// included by assign.h itself when AHOY_HEADER_ONLY is defined so they can be inlined into their
+// callers.
+
+#ifndef AHOY_AHOY_INTERNAL_ASSIGN_INL_H
+#define AHOY_AHOY_INTERNAL_ASSIGN_INL_H
+
+#include "ahoy/internal/assign.h"
+#include "ahoy/internal/utf8.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <climits>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ahoy {
+namespace internal {
+namespace assign_internal {
+
+// Converts returns a lowercase version of the string passed in
+AHOY_INLINE std::string ToLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+}
+
+// Checks if a string looks like it could be a negative number
+AHOY_INLINE bool is_negative(const std::string& value) {
+    return value.size() > 0 && value[0] == '-';
+}
+
+template<typename T>
+bool assign(T func(const std::string&, std::size_t*, int), T* const pointer,
+        const std::string& value) {
+    std::size_t leftover;
+    // std::sto*** methods can parse strings partially, but this requires complete parsing
+    *pointer = func(value, &leftover, 10);
+    return leftover == value.size();
+}
+
+template<typename T>
+bool assign(T func(const std::string&, std::size_t*), T* const pointer, const std::string& value) {
+    std::size_t leftover;
+    // std::sto*** methods can parse strings partially, but this requires complete parsing
+    *pointer = func(value, &leftover);
+    return leftover == value.size();
+}
+
+// Accumulates the decimal digits starting at |*it| into |*result|, advancing |*it| past them.
+// Returns false if there are no digits or if the number does not fit in a uint64_t.
+AHOY_INLINE bool parse_digits(const char** it, const char* const end, std::uint64_t* result) {
+    const char* const begin = *it;
+    std::uint64_t number = 0;
+    for (; *it != end && **it >= '0' && **it <= '9'; (*it)++) {
+        const std::uint64_t digit = **it - '0';
+        if (number > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        number = number * 10 + digit;
+    }
+    *result = number;
+    return *it != begin;
+}
+
+// Gets the multiplier of a byte size suffix in the range [|suffix|, |end|), like "", "B", "k",
+// "MB" or "GiB". Returns 0 if the suffix is not recognized.
+AHOY_INLINE std::uint64_t byte_multiplier(const char* suffix, const char* const end) {
+    int exponent = 0;
+    if (suffix != end && *suffix != 'B') {
+        switch (*suffix) {
+            case 'k':
+            case 'K':
+                exponent = 1;
+                break;
+            case 'M':
+                exponent = 2;
+                break;
+            case 'G':
+                exponent = 3;
+                break;
+            case 'T':
+                exponent = 4;
+                break;
+            case 'P':
+                exponent = 5;
+                break;
+            case 'E':
+                exponent = 6;
+                break;
+            default:
+                return 0;
+        }
+        suffix++;
+    }
+
+    std::uint64_t base = 1000;
+    if (exponent > 0 && suffix != end && *suffix == 'i') {
+        base = 1024;
+        suffix++;
+    }
+    if (suffix != end && *suffix == 'B') {
+        suffix++;
+    }
+    if (suffix != end) {
+        return 0;
+    }
+
+    std::uint64_t multiplier = 1;
+    for (int i = 0; i < exponent; i++) {
+        multiplier *= base;
+    }
+    return multiplier;
+}
+
+// Gets the length in nanoseconds of the duration unit at |*it|, advancing |*it| past it. Returns 0
+// if no unit is recognized.
+AHOY_INLINE std::uint64_t duration_unit(const char** it, const char* const end) {
+    const char* unit = *it;
+    if (unit == end) {
+        return 0;
+    }
+
+    std::uint64_t nanoseconds;
+    switch (*unit++) {
+        case 'n':
+            nanoseconds = 1;
+            break;
+        case 'u':
+            nanoseconds = 1000;
+            break;
+        case '\xC2': // First byte of the UTF-8 encoding of the micro sign, µ
+            if (unit == end || *unit++ != '\xB5') {
+                return 0;
+            }
+            nanoseconds = 1000;
+            break;
+        case 'm':
+            if (unit == end || *unit != 's') {
+                *it = unit;
+                return 60ull * 1000 * 1000 * 1000;
+            }
+            nanoseconds = 1000 * 1000;
+            break;
+        case 's':
+            *it = unit;
+            return 1000 * 1000 * 1000;
+        case 'h':
+            *it = unit;
+            return 60ull * 60 * 1000 * 1000 * 1000;
+        case 'd':
+            *it = unit;
+            return 24ull * 60 * 60 * 1000 * 1000 * 1000;
+        default:
+            return 0;
+    }
+
+    // The sub-second units all end with an 's'
+    if (unit == end || *unit++ != 's') {
+        return 0;
+    }
+    *it = unit;
+    return nanoseconds;
+}
+
+// Parses durations like "250ms" or "1h30m" in a single pass, rejecting values that overflow or
+// cannot be represented exactly by |Duration|
+template<typename Duration>
+bool assign_duration(Duration * const pointer, const std::string& value) {
+    typedef typename Duration::period Period;
+    const std::uint64_t period_nanoseconds = Period::num * (1000 * 1000 * 1000 / Period::den);
+    const std::uint64_t max = std::numeric_limits<typename Duration::rep>::max();
+
+    const char* it = value.data();
+    const char* const end = it + value.size();
+    std::uint64_t total = 0;
+    bool first = true;
+    do {
+        std::uint64_t count;
+        if (!parse_digits(&it, end, &count)) {
+            return false;
+        }
+
+        // A bare number is in the units of the storage type
+        std::uint64_t unit_nanoseconds = period_nanoseconds;
+        if (it != end || !first) {
+            unit_nanoseconds = duration_unit(&it, end);
+            if (unit_nanoseconds == 0) {
+                return false;
+            }
+        }
+
+        std::uint64_t units;
+        if (unit_nanoseconds >= period_nanoseconds) {
+            const std::uint64_t ratio = unit_nanoseconds / period_nanoseconds;
+            if (count > max / ratio) {
+                return false;
+            }
+            units = count * ratio;
+        } else {
+            const std::uint64_t ratio = period_nanoseconds / unit_nanoseconds;
+            if (count % ratio != 0) {
+                return false;
+            }
+            units = count / ratio;
+        }
+
+        if (units > max - total) {
+            return false;
+        }
+        total += units;
+        first = false;
+    } while (it != end);
+
+    *pointer = Duration(static_cast<typename Duration::rep>(total));
+    return true;
+}
+
+// Stores |value| in |pointer| if it fits in T
+template<typename T>
+bool assign_choice(void * const pointer, const long long value) {
+    if (std::numeric_limits<T>::is_signed) {
+        if (value < static_cast<long long>(std::numeric_limits<T>::min()) ||
+                value > static_cast<long long>(std::numeric_limits<T>::max())) {
+            return false;
+        }
+    } else if (value < 0 || static_cast<unsigned long long>(value) >
+                   static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
+        return false;
+    }
+    *static_cast<T*>(pointer) = static_cast<T>(value);
+    return true;
+}
+
+// Adds |count| to the T at |pointer| if the sum fits in T
+template<typename T>
+bool assign_count(void * const pointer, const unsigned long long count) {
+    T* const value = static_cast<T*>(pointer);
+    const unsigned long long max = std::numeric_limits<T>::max();
+    // Negative counts only occur if the parameter had a negative default, which is left alone
+    if (*value >= 0 && (count > max || static_cast<unsigned long long>(*value) > max - count)) {
+        return false;
+    }
+    *value = static_cast<T>(*value + static_cast<T>(count));
+    return true;
+}
+
+// Converts |value| with |assign| and appends the result to the std::vector<T> at |pointer|
+template<typename T>
+bool assign_append(bool assign(T*, const std::string&), void * const pointer,
+                   const std::string& value) {
+    T element;
+    if (!assign(&element, value)) {
+        return false;
+    }
+    static_cast<std::vector<T>*>(pointer)->push_back(std::move(element));
+    return true;
+}
+
+// The fewest values AssignAppendAll converts on a thread of its own. Below this, starting a thread
+// costs more than it saves.
+const std::size_t kAppendAllChunk = 16384;
+
+// The most threads AssignAppendAll converts on, including the calling one
+const std::size_t kAppendAllThreads = 8;
+
+// Converts |values| with |assign| straight into |count| new elements at the end of the
+// std::vector<T> at |pointer|, spreading chunks of them over threads if there are enough
+template<typename T>
+bool assign_append_all(bool assign(T*, const std::string&), void * const pointer,
+                       const std::string * const values, const std::size_t count) {
+    std::vector<T>* const vector = static_cast<std::vector<T>*>(pointer);
+    const std::size_t offset = vector->size();
+    vector->resize(offset + count);
+    T* const elements = vector->data() + offset;
+
+    // Set by the first value that does not convert, which stops every thread early
+    std::atomic<bool> failed(false);
+    const auto convert = [assign, elements, values, &failed](const std::size_t begin,
+                                                             const std::size_t end) {
+        for (std::size_t i = begin; i < end && !failed.load(std::memory_order_relaxed); i++) {
+            if (!assign(&elements[i], values[i])) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const std::size_t hardware = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    const std::size_t threads = std::min({ count / kAppendAllChunk, hardware, kAppendAllThreads });
+    if (threads > 1) {
+        const std::size_t chunk = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        // The calling thread converts the first chunk and whatever chunks no thread was started for
+        std::size_t begin = chunk;
+        try {
+            for (; begin < count; begin += chunk) {
+                workers.emplace_back(convert, begin, std::min(begin + chunk, count));
+            }
+        } catch (const std::system_error&) {
+        }
+        convert(0, chunk);
+        convert(begin, count);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    } else {
+        convert(0, count);
+    }
+
+    if (failed.load()) {
+        vector->resize(offset);
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+void reserve_append(void * const pointer, const std::size_t count) {
+    std::vector<T>* const vector = static_cast<std::vector<T>*>(pointer);
+    vector->reserve(vector->size() + count);
+}
+
+// The number of elements in the std::vector<T> at |pointer|
+template<typename T>
+std::size_t appended_size(void * const pointer) {
+    return static_cast<std::vector<T>*>(pointer)->size();
+}
+
+// Removes the elements after the first |size| from the std::vector<T> at |pointer|
+template<typename T>
+void truncate_appended(void * const pointer, const std::size_t size) {
+    std::vector<T>* const vector = static_cast<std::vector<T>*>(pointer);
+    if (size < vector->size()) {
+        vector->erase(vector->begin() + size, vector->end());
+    }
+}
+
+// Returns true if |value| is one of the |count| strings in |words|
+AHOY_INLINE bool is_one_of(const std::string& value, const char* const* words,
+        const std::size_t count) {
+    return std::find(words, words + count, value) != words + count;
+}
+
+} // namespace assign_internal
+
+AHOY_INLINE bool AssignBool(bool * const pointer, const std::string& value) {
+    static const char* const kTrues[] = { "true", "t", "yes", "y", "on", "1" };
+    static const char* const kFalses[] = { "false", "f", "no", "n", "off", "0" };
+    const std::string lower_value = assign_internal::ToLower(value);
+    if (assign_internal::is_one_of(lower_value, kTrues, sizeof(kTrues) / sizeof(kTrues[0]))) {
+        *pointer = true;
+    } else if (assign_internal::is_one_of(lower_value, kFalses,
+                                          sizeof(kFalses) / sizeof(kFalses[0]))) {
+        *pointer = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+AHOY_INLINE bool AssignBool(bool * const pointer, const bool value) {
+    *pointer = value;
+    return true;
+}
+
+AHOY_INLINE bool AssignChar(char * const pointer, const std::string& value) {
+    if (value.size() != 1) {
+        return false;
+    }
+
+    *pointer = value[0];
+    return true;
+}
+
+AHOY_INLINE bool AssignChar(char * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignUChar(unsigned char * const pointer, const std::string& value) {
+    if (value.size() != 1) {
+        return false;
+    }
+
+    *pointer = value[0];
+    return true;
+}
+
+AHOY_INLINE bool AssignUChar(unsigned char * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignShort(short * const pointer, const std::string& value) {
+    try {
+        int int_value;
+        if (assign_internal::assign(&std::stoi, &int_value, value) &&
+                int_value <= SHRT_MAX && int_value >= SHRT_MIN) {
+            *pointer = int_value;
+            return true;
+        }
+        return false;
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignShort(short * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignUShort(unsigned short * const pointer, const std::string& value) {
+    try {
+        unsigned long ulong_value;
+        if (assign_internal::assign(&std::stoul, &ulong_value, value) && ulong_value <= USHRT_MAX) {
+            *pointer = ulong_value;
+            return true;
+        }
+        return false;
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignUShort(unsigned short * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignInt(int * const pointer, const std::string& value) {
+    try {
+        return assign_internal::assign(&std::stoi, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignInt(int * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignUInt(uint * const pointer, const std::string& value) {
+    try {
+        unsigned long ulong_value;
+        if (assign_internal::assign(&std::stoul, &ulong_value, value) && ulong_value <= UINT_MAX) {
+            *pointer = ulong_value;
+            return true;
+        }
+        return false;
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignUInt(uint * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignLong(long * const pointer, const std::string& value) {
+    try {
+        return assign_internal::assign(&std::stol, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignLong(long * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignULong(unsigned long * const pointer, const std::string& value) {
+    if (assign_internal::is_negative(value)) {
+        return false;
+    }
+
+    try {
+        return assign_internal::assign(&std::stoul, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignULong(unsigned long * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignLongLong(long long * const pointer, const std::string& value) {
+    try {
+        return assign_internal::assign(&std::stoll, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignLongLong(long long * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignULongLong(unsigned long long * const pointer, const std::string& value) {
+    if (assign_internal::is_negative(value)) {
+        return false;
+    }
+
+    try {
+        return assign_internal::assign(&std::stoull, pointer, value) && *pointer <= ULLONG_MAX;
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignULongLong(unsigned long long * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignFloat(float * const pointer, const std::string& value) {
+    try {
+        // return assign_internal::assign(&std::stof, pointer, value);
+        std::size_t leftover(0);
+        *pointer = std::stof(value, &leftover);
+        if (leftover != value.size()) {
+            return false;
+        }
+        return true;
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignFloat(float * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignDouble(double * const pointer, const std::string& value) {
+    try {
+        return assign_internal::assign(&std::stod, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignDouble(double * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignLongDouble(long double * const pointer, const std::string& value) {
+    try {
+        return assign_internal::assign(&std::stold, pointer, value);
+    } catch (std::invalid_argument&) {
+        return false;
+    } catch (std::out_of_range&) {
+        return false;
+    }
+}
+
+AHOY_INLINE bool AssignLongDouble(long double * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignString(std::string * const pointer, const std::string& value) {
+    *pointer = value;
+    return true;
+}
+
+AHOY_INLINE bool AssignString(std::string * const pointer, const bool value) {
+    *pointer = value ? "true" : "false";
+    return true;
+}
+
+AHOY_INLINE bool AssignUtf8String(std::string * const pointer, const std::string& value) {
+    // Checked before copying so malformed values are never stored
+    if (!ValidUtf8(value.data(), value.size())) {
+        return false;
+    }
+    *pointer = value;
+    return true;
+}
+
+AHOY_INLINE bool AssignUtf8String(std::string * const pointer, const bool value) {
+    return AssignString(pointer, value);
+}
+
+AHOY_INLINE bool AssignBytes(std::uint64_t * const pointer, const std::string& value) {
+    const char* it = value.data();
+    const char* const end = it + value.size();
+
+    std::uint64_t number;
+    if (!assign_internal::parse_digits(&it, end, &number)) {
+        return false;
+    }
+
+    const std::uint64_t multiplier = assign_internal::byte_multiplier(it, end);
+    if (multiplier == 0 || number > UINT64_MAX / multiplier) {
+        return false;
+    }
+
+    *pointer = number * multiplier;
+    return true;
+}
+
+AHOY_INLINE bool AssignBytes(std::uint64_t * const pointer, const bool value) {
+    *pointer = value ? 1 : 0;
+    return true;
+}
+
+AHOY_INLINE bool AssignNanoseconds(std::chrono::nanoseconds * const pointer,
+        const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignNanoseconds(std::chrono::nanoseconds * const pointer, const bool value) {
+    *pointer = std::chrono::nanoseconds(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignMicroseconds(std::chrono::microseconds * const pointer,
+        const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignMicroseconds(std::chrono::microseconds * const pointer, const bool value) {
+    *pointer = std::chrono::microseconds(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignMilliseconds(std::chrono::milliseconds * const pointer,
+        const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignMilliseconds(std::chrono::milliseconds * const pointer, const bool value) {
+    *pointer = std::chrono::milliseconds(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignSeconds(std::chrono::seconds * const pointer, const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignSeconds(std::chrono::seconds * const pointer, const bool value) {
+    *pointer = std::chrono::seconds(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignMinutes(std::chrono::minutes * const pointer, const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignMinutes(std::chrono::minutes * const pointer, const bool value) {
+    *pointer = std::chrono::minutes(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignHours(std::chrono::hours * const pointer, const std::string& value) {
+    return assign_internal::assign_duration(pointer, value);
+}
+
+AHOY_INLINE bool AssignHours(std::chrono::hours * const pointer, const bool value) {
+    *pointer = std::chrono::hours(value ? 1 : 0);
+    return true;
+}
+
+AHOY_INLINE bool AssignChoice(void * const pointer, const Type type, const long long value) {
+    switch (type) {
+        case Type::CHAR:
+            return assign_internal::assign_choice<char>(pointer, value);
+        case Type::U_CHAR:
+            return assign_internal::assign_choice<unsigned char>(pointer, value);
+        case Type::SHORT:
+            return assign_internal::assign_choice<short>(pointer, value);
+        case Type::U_SHORT:
+            return assign_internal::assign_choice<unsigned short>(pointer, value);
+        case Type::INT:
+            return assign_internal::assign_choice<int>(pointer, value);
+        case Type::U_INT:
+            return assign_internal::assign_choice<unsigned int>(pointer, value);
+        case Type::LONG:
+            return assign_internal::assign_choice<long>(pointer, value);
+        case Type::U_LONG:
+            return assign_internal::assign_choice<unsigned long>(pointer, value);
+        case Type::LONG_LONG:
+            return assign_internal::assign_choice<long long>(pointer, value);
+        case Type::U_LONG_LONG:
+            return assign_internal::assign_choice<unsigned long long>(pointer, value);
+        default:
+            return false;
+    }
+}
+
+AHOY_INLINE bool AssignCount(void * const pointer, const Type type,
+        const unsigned long long count) {
+    switch (type) {
+        case Type::SHORT:
+            return assign_internal::assign_count<short>(pointer, count);
+        case Type::U_SHORT:
+            return assign_internal::assign_count<unsigned short>(pointer, count);
+        case Type::INT:
+            return assign_internal::assign_count<int>(pointer, count);
+        case Type::U_INT:
+            return assign_internal::assign_count<unsigned int>(pointer, count);
+        case Type::LONG:
+            return assign_internal::assign_count<long>(pointer, count);
+        case Type::U_LONG:
+            return assign_internal::assign_count<unsigned long>(pointer, count);
+        case Type::LONG_LONG:
+            return assign_internal::assign_count<long long>(pointer, count);
+        case Type::U_LONG_LONG:
+            return assign_internal::assign_count<unsigned long long>(pointer, count);
+        default:
+            return false;
+    }
+}
+
+AHOY_INLINE bool AssignAppend(void * const pointer, const Type type, const std::string& value) {
+    switch (type) {
+        case Type::INT:
+            return assign_internal::assign_append<int>(AssignInt, pointer, value);
+        case Type::U_INT:
+            return assign_internal::assign_append<unsigned int>(AssignUInt, pointer, value);
+        case Type::LONG:
+            return assign_internal::assign_append<long>(AssignLong, pointer, value);
+        case Type::U_LONG:
+            return assign_internal::assign_append<unsigned long>(AssignULong, pointer, value);
+        case Type::LONG_LONG:
+            return assign_internal::assign_append<long long>(AssignLongLong, pointer, value);
+        case Type::U_LONG_LONG:
+            return assign_internal::assign_append<unsigned long long>(AssignULongLong, pointer,
+                    value);
+        case Type::FLOAT:
+            return assign_internal::assign_append<float>(AssignFloat, pointer, value);
+        case Type::DOUBLE:
+            return assign_internal::assign_append<double>(AssignDouble, pointer, value);
+        case Type::STRING:
+            return assign_internal::assign_append<std::string>(AssignString, pointer, value);
+        case Type::UTF8_STRING:
+            return assign_internal::assign_append<std::string>(AssignUtf8String, pointer, value);
+        default:
+            return false;
+    }
+}
+
+AHOY_INLINE bool AssignAppendAll(void * const pointer, const Type type,
+        const std::string * const values, const std::size_t count) {
+    switch (type) {
+        case Type::INT:
+            return assign_internal::assign_append_all<int>(AssignInt, pointer, values, count);
+        case Type::U_INT:
+            return assign_internal::assign_append_all<unsigned int>(AssignUInt, pointer, values,
+                    count);
+        case Type::LONG:
+            return assign_internal::assign_append_all<long>(AssignLong, pointer, values, count);
+        case Type::U_LONG:
+            return assign_internal::assign_append_all<unsigned long>(AssignULong, pointer, values,
+                    count);
+        case Type::LONG_LONG:
+            return assign_internal::assign_append_all<long long>(AssignLongLong, pointer, values,
+                    count);
+        case Type::U_LONG_LONG:
+            return assign_internal::assign_append_all<unsigned long long>(AssignULongLong, pointer,
+                    values, count);
+        case Type::FLOAT:
+            return assign_internal::assign_append_all<float>(AssignFloat, pointer, values, count);
+        case Type::DOUBLE:
+            return assign_internal::assign_append_all<double>(AssignDouble, pointer, values,
+                    count);
+        case Type::STRING:
+            return assign_internal::assign_append_all<std::string>(AssignString, pointer, values,
+                    count);
+        case Type::UTF8_STRING:
+            return assign_internal::assign_append_all<std::string>(AssignUtf8String, pointer,
+                    values, count);
+        default:
+            return false;
+    }
+}
+
+AHOY_INLINE void ReserveAppend(void * const pointer, const Type type, const std::size_t count) {
+    switch (type) {
+        case Type::INT:
+            return assign_internal::reserve_append<int>(pointer, count);
+        case Type::U_INT:
+            return assign_internal::reserve_append<unsigned int>(pointer, count);
+        case Type::LONG:
+            return assign_internal::reserve_append<long>(pointer, count);
+        case Type::U_LONG:
+            return assign_internal::reserve_append<unsigned long>(pointer, count);
+        case Type::LONG_LONG:
+            return assign_internal::reserve_append<long long>(pointer, count);
+        case Type::U_LONG_LONG:
+            return assign_internal::reserve_append<unsigned long long>(pointer, count);
+        case Type::FLOAT:
+            return assign_internal::reserve_append<float>(pointer, count);
+        case Type::DOUBLE:
+            return assign_internal::reserve_append<double>(pointer, count);
+        case Type::STRING:
+        case Type::UTF8_STRING:
+            return assign_internal::reserve_append<std::string>(pointer, count);
+        default:
+            return;
+    }
+}
+
+AHOY_INLINE std::size_t AppendedSize(void * const pointer, const Type type) {
+    switch (type) {
+        case Type::INT:
+            return assign_internal::appended_size<int>(pointer);
+        case Type::U_INT:
+            return assign_internal::appended_size<unsigned int>(pointer);
+        case Type::LONG:
+            return assign_internal::appended_size<long>(pointer);
+        case Type::U_LONG:
+            return assign_internal::appended_size<unsigned long>(pointer);
+        case Type::LONG_LONG:
+            return assign_internal::appended_size<long long>(pointer);
+        case Type::U_LONG_LONG:
+            return assign_internal::appended_size<unsigned long long>(pointer);
+        case Type::FLOAT:
+            return assign_internal::appended_size<float>(pointer);
+        case Type::DOUBLE:
+            return assign_internal::appended_size<double>(pointer);
+        case Type::STRING:
+        case Type::UTF8_STRING:
+            return assign_internal::appended_size<std::string>(pointer);
+        default:
+            return 0;
+    }
+}
+
+AHOY_INLINE void TruncateAppended(void * const pointer, const Type type, const std::size_t size) {
+    switch (type) {
+        case Type::INT:
+            return assign_internal::truncate_appended<int>(pointer, size);
+        case Type::U_INT:
+            return assign_internal::truncate_appended<unsigned int>(pointer, size);
+        case Type::LONG:
+            return assign_internal::truncate_appended<long>(pointer, size);
+        case Type::U_LONG:
+            return assign_internal::truncate_appended<unsigned long>(pointer, size);
+        case Type::LONG_LONG:
+            return assign_internal::truncate_appended<long long>(pointer, size);
+        case Type::U_LONG_LONG:
+            return assign_internal::truncate_appended<unsigned long long>(pointer, size);
+        case Type::FLOAT:
+            return assign_internal::truncate_appended<float>(pointer, size);
+        case Type::DOUBLE:
+            return assign_internal::truncate_appended<double>(pointer, size);
+        case Type::STRING:
+        case Type::UTF8_STRING:
+            return assign_internal::truncate_appended<std::string>(pointer, size);
+        default:
+            return;
+    }
+}
+
+AHOY_INLINE bool Validate(const Type type, const std::string& value) {
+    // Any value is a valid string, which also keeps the scratch space below trivial
+    if (type == Type::STRING) {
+        return true;
+    }
+    if (type == Type::UTF8_STRING) {
+        return ValidUtf8(value.data(), value.size());
+    }
+
+    // Large and aligned enough for every other Type
+    typename std::aligned_union<0, long double, unsigned long long, std::chrono::nanoseconds>::type
+            scratch;
+    return Assign(&scratch, type, value);
+}
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_ASSIGN_INL_H
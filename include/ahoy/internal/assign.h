@@ -4,10 +4,22 @@
 #ifndef AHOY_AHOY_INTERNAL_ASSIGN_H
 #define AHOY_AHOY_INTERNAL_ASSIGN_H
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "ahoy/internal/type.h"
 
+// Defining AHOY_HEADER_ONLY includes the definitions of the conversions below in every translation
+// unit that uses them so the compiler can inline them into the parse loop, at the cost of a larger
+// binary. Otherwise they are compiled once, in assign.cc.
+#ifdef AHOY_HEADER_ONLY
+#define AHOY_INLINE inline
+#else
+#define AHOY_INLINE
+#endif
+
 namespace ahoy {
 namespace internal {
 
@@ -16,58 +28,129 @@ namespace internal {
 // For chars, booleans are converted to 1 and 0 and strings are expected to be a single character
 // long.
 // For numeric types, booleans are converted to 1 and 0 and strings are parsed to numbers
+// For UTF-8 strings, strings are copied like for strings but only if they are well-formed UTF-8.
+// For byte sizes, strings are whole numbers with an optional unit suffix, like 4GiB, 10k or 512B.
+// Decimal prefixes (k, M, G, T, P, E) are powers of 1000 and binary prefixes (Ki, Mi, ...) are
+// powers of 1024.
+// For durations, strings are one or more whole numbers followed by a unit (ns, us, ms, s, m, h, d),
+// like 250ms or 1h30m. A bare number is interpreted in the unit of the storage type. Values that
+// cannot be represented exactly in the storage type, like 1500us for milliseconds, are rejected.
 //
 // Consumers should prefer using the |Assign| method at the bottom of this file instead as a general
 // assignment method.
 
-bool AssignBool(bool * const pointer, const std::string& value);
-bool AssignBool(bool * const pointer, const bool value);
+AHOY_INLINE bool AssignBool(bool * const pointer, const std::string& value);
+AHOY_INLINE bool AssignBool(bool * const pointer, const bool value);
+
+AHOY_INLINE bool AssignChar(char * const pointer, const std::string& value);
+AHOY_INLINE bool AssignChar(char * const pointer, const bool value);
+
+AHOY_INLINE bool AssignUChar(unsigned char * const pointer, const std::string& value);
+AHOY_INLINE bool AssignUChar(unsigned char * const pointer, const bool value);
+
+AHOY_INLINE bool AssignShort(short * const pointer, const std::string& value);
+AHOY_INLINE bool AssignShort(short * const pointer, const bool value);
+
+AHOY_INLINE bool AssignUShort(unsigned short * const pointer, const std::string& value);
+AHOY_INLINE bool AssignUShort(unsigned short * const pointer, const bool value);
+
+AHOY_INLINE bool AssignInt(int * const pointer, const std::string& value);
+AHOY_INLINE bool AssignInt(int * const pointer, const bool value);
+
+AHOY_INLINE bool AssignUInt(uint * const pointer, const std::string& value);
+AHOY_INLINE bool AssignUInt(uint * const pointer, const bool value);
+
+AHOY_INLINE bool AssignLong(long * const pointer, const std::string& value);
+AHOY_INLINE bool AssignLong(long * const pointer, const bool value);
+
+AHOY_INLINE bool AssignULong(unsigned long * const pointer, const std::string& value);
+AHOY_INLINE bool AssignULong(unsigned long * const pointer, const bool value);
 
-bool AssignChar(char * const pointer, const std::string& value);
-bool AssignChar(char * const pointer, const bool value);
+AHOY_INLINE bool AssignLongLong(long long * const pointer, const std::string& value);
+AHOY_INLINE bool AssignLongLong(long long * const pointer, const bool value);
 
-bool AssignUChar(unsigned char * const pointer, const std::string& value);
-bool AssignUChar(unsigned char * const pointer, const bool value);
+AHOY_INLINE bool AssignULongLong(unsigned long long * const pointer, const std::string& value);
+AHOY_INLINE bool AssignULongLong(unsigned long long * const pointer, const bool value);
 
-bool AssignShort(short * const pointer, const std::string& value);
-bool AssignShort(short * const pointer, const bool value);
+AHOY_INLINE bool AssignFloat(float * const pointer, const std::string& value);
+AHOY_INLINE bool AssignFloat(float * const pointer, const bool value);
 
-bool AssignUShort(unsigned short * const pointer, const std::string& value);
-bool AssignUShort(unsigned short * const pointer, const bool value);
+AHOY_INLINE bool AssignDouble(double * const pointer, const std::string& value);
+AHOY_INLINE bool AssignDouble(double * const pointer, const bool value);
 
-bool AssignInt(int * const pointer, const std::string& value);
-bool AssignInt(int * const pointer, const bool value);
+AHOY_INLINE bool AssignLongDouble(long double * const pointer, const std::string& value);
+AHOY_INLINE bool AssignLongDouble(long double * const pointer, const bool value);
 
-bool AssignUInt(uint * const pointer, const std::string& value);
-bool AssignUInt(uint * const pointer, const bool value);
+AHOY_INLINE bool AssignString(std::string * const pointer, const std::string& value);
+AHOY_INLINE bool AssignString(std::string * const pointer, const bool value);
 
-bool AssignLong(long * const pointer, const std::string& value);
-bool AssignLong(long * const pointer, const bool value);
+AHOY_INLINE bool AssignUtf8String(std::string * const pointer, const std::string& value);
+AHOY_INLINE bool AssignUtf8String(std::string * const pointer, const bool value);
 
-bool AssignULong(unsigned long * const pointer, const std::string& value);
-bool AssignULong(unsigned long * const pointer, const bool value);
+AHOY_INLINE bool AssignBytes(std::uint64_t * const pointer, const std::string& value);
+AHOY_INLINE bool AssignBytes(std::uint64_t * const pointer, const bool value);
 
-bool AssignLongLong(long long * const pointer, const std::string& value);
-bool AssignLongLong(long long * const pointer, const bool value);
+AHOY_INLINE bool AssignNanoseconds(std::chrono::nanoseconds * const pointer,
+        const std::string& value);
+AHOY_INLINE bool AssignNanoseconds(std::chrono::nanoseconds * const pointer, const bool value);
 
-bool AssignULongLong(unsigned long long * const pointer, const std::string& value);
-bool AssignULongLong(unsigned long long * const pointer, const bool value);
+AHOY_INLINE bool AssignMicroseconds(std::chrono::microseconds * const pointer,
+        const std::string& value);
+AHOY_INLINE bool AssignMicroseconds(std::chrono::microseconds * const pointer, const bool value);
 
-bool AssignFloat(float * const pointer, const std::string& value);
-bool AssignFloat(float * const pointer, const bool value);
+AHOY_INLINE bool AssignMilliseconds(std::chrono::milliseconds * const pointer,
+        const std::string& value);
+AHOY_INLINE bool AssignMilliseconds(std::chrono::milliseconds * const pointer, const bool value);
 
-bool AssignDouble(double * const pointer, const std::string& value);
-bool AssignDouble(double * const pointer, const bool value);
+AHOY_INLINE bool AssignSeconds(std::chrono::seconds * const pointer, const std::string& value);
+AHOY_INLINE bool AssignSeconds(std::chrono::seconds * const pointer, const bool value);
 
-bool AssignLongDouble(long double * const pointer, const std::string& value);
-bool AssignLongDouble(long double * const pointer, const bool value);
+AHOY_INLINE bool AssignMinutes(std::chrono::minutes * const pointer, const std::string& value);
+AHOY_INLINE bool AssignMinutes(std::chrono::minutes * const pointer, const bool value);
 
-bool AssignString(std::string * const pointer, const std::string& value);
-bool AssignString(std::string * const pointer, const bool value);
+AHOY_INLINE bool AssignHours(std::chrono::hours * const pointer, const std::string& value);
+AHOY_INLINE bool AssignHours(std::chrono::hours * const pointer, const bool value);
+
+// Stores |value|, the integer of a choice from ahoy::Choices, in |pointer| if it is an integer Type
+// that can represent |value|
+AHOY_INLINE bool AssignChoice(void * const pointer, const ahoy::internal::Type type,
+        const long long value);
+
+// Adds |count| to the integer of Type |type| at |pointer|, failing if the sum does not fit. This is
+// used to count repeated flags, like -vvv.
+AHOY_INLINE bool AssignCount(void * const pointer, const ahoy::internal::Type type,
+                 const unsigned long long count);
+
+// Converts |value| to the element Type |type| and appends it to the std::vector at |pointer|. Only
+// strings and numeric types other than chars are supported.
+AHOY_INLINE bool AssignAppend(void * const pointer, const ahoy::internal::Type type,
+        const std::string& value);
+
+// Converts the |count| strings at |values| to the element Type |type| and appends them to the
+// std::vector at |pointer|, which is grown once and converted into in place. Batches of more than
+// kAppendAllChunk values are split into chunks converted on several threads. If any value does not
+// convert, nothing is appended.
+AHOY_INLINE bool AssignAppendAll(void * const pointer, const ahoy::internal::Type type,
+        const std::string * const values, const std::size_t count);
+
+// Reserves room for |count| more elements in the std::vector of element Type |type| at |pointer|
+AHOY_INLINE void ReserveAppend(void * const pointer, const ahoy::internal::Type type,
+        const std::size_t count);
+
+// The number of elements in the std::vector of element Type |type| at |pointer|
+AHOY_INLINE std::size_t AppendedSize(void * const pointer, const ahoy::internal::Type type);
+
+// Removes the elements after the first |size| from the std::vector of element Type |type| at
+// |pointer|, undoing appends made since it had |size| elements
+AHOY_INLINE void TruncateAppended(void * const pointer, const ahoy::internal::Type type,
+        const std::size_t size);
+
+// Returns true if |value| converts to |type|, without storing it anywhere
+AHOY_INLINE bool Validate(const ahoy::internal::Type type, const std::string& value);
 
 // Maps a Type to an assignment method and returns the success of the assignment
 template<typename T>
-bool Assign(void * const pointer, const ahoy::internal::Type type, const T& value) {
+AHOY_INLINE bool Assign(void * const pointer, const ahoy::internal::Type type, const T& value) {
     switch (type) {
         case ahoy::internal::Type::BOOL:
             return AssignBool((bool*) pointer, value);
@@ -99,6 +182,22 @@ bool Assign(void * const pointer, const ahoy::internal::Type type, const T& valu
             return AssignLongDouble((long double*) pointer, value);
         case ahoy::internal::Type::STRING:
             return AssignString((std::string*) pointer, value);
+        case ahoy::internal::Type::UTF8_STRING:
+            return AssignUtf8String((std::string*) pointer, value);
+        case ahoy::internal::Type::BYTES:
+            return AssignBytes((std::uint64_t*) pointer, value);
+        case ahoy::internal::Type::NANOSECONDS:
+            return AssignNanoseconds((std::chrono::nanoseconds*) pointer, value);
+        case ahoy::internal::Type::MICROSECONDS:
+            return AssignMicroseconds((std::chrono::microseconds*) pointer, value);
+        case ahoy::internal::Type::MILLISECONDS:
+            return AssignMilliseconds((std::chrono::milliseconds*) pointer, value);
+        case ahoy::internal::Type::SECONDS:
+            return AssignSeconds((std::chrono::seconds*) pointer, value);
+        case ahoy::internal::Type::MINUTES:
+            return AssignMinutes((std::chrono::minutes*) pointer, value);
+        case ahoy::internal::Type::HOURS:
+            return AssignHours((std::chrono::hours*) pointer, value);
         default:
             return false;
     }
@@ -107,4 +206,8 @@ bool Assign(void * const pointer, const ahoy::internal::Type type, const T& valu
 } // namespace internal
 } // namespace ahoy
 
+#ifdef AHOY_HEADER_ONLY
+#include "ahoy/internal/assign-inl.h"
+#endif
+
 #endif // AHOY_AHOY_INTERNAL_ASSIGN_H
@@ -0,0 +1,87 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_CHOICE_TABLE_H
+#define AHOY_AHOY_INTERNAL_CHOICE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ahoy {
+namespace internal {
+
+// An immutable map from a fixed set of strings to integers, backed by a perfect hash built at
+// construction. A lookup hashes the value once, reads one displacement and one slot, and compares
+// the value against the single candidate in that slot.
+class ChoiceTable {
+  public:
+    // A choice's name as a range of the table's names and its value
+    struct Entry {
+        std::uint32_t offset;
+        std::uint32_t size;
+        long long value;
+    };
+
+    // The arrays behind a table, which may be owned by a ChoiceTable or live in a grammar snapshot
+    struct View {
+        const char* names;
+        const Entry* entries;
+        std::uint32_t entry_count;
+        // Indexed by hash to pick the displacement that makes the bucket's choices collision-free
+        const std::uint32_t* displacements;
+        std::uint32_t displacement_count;
+        // Indexed by the displaced hash, holding an index into |entries| or an empty marker
+        const std::uint32_t* slots;
+        std::uint32_t slot_count;
+        bool case_insensitive;
+
+        // Looks up |value|, returning true and setting |*result| to its integer if it is a choice
+        bool find(const char* value, const std::size_t size, long long* result) const;
+
+        // Returns false if any index in the arrays is out of range. Use this on views of untrusted
+        // memory before calling find.
+        bool valid(const std::size_t names_size) const;
+    };
+
+    // Builds a table of |choices|. If a name appears more than once, only its first value is kept.
+    // If |case_insensitive| is true, ASCII letters match regardless of case.
+    ChoiceTable(const std::vector<std::pair<std::string, long long>>& choices,
+                const bool case_insensitive);
+    virtual ~ChoiceTable();
+
+    // Looks up |value|, returning true and setting |*result| to its integer if it is a choice
+    bool find(const char* value, const std::size_t size, long long* result) const;
+    bool find(const std::string& value, long long* result) const;
+
+    // The choices in the order they were passed in, without duplicates, with their original case
+    std::vector<std::pair<std::string, long long>> choices() const;
+
+    // The number of choices in the table
+    std::size_t size() const;
+
+    bool case_insensitive() const;
+
+    // The arrays of the table, which are valid for as long as it is
+    View view() const;
+
+    // The number of bytes of memory held by the table, including itself
+    std::size_t memory_footprint() const;
+
+    bool operator ==(const ChoiceTable& other) const;
+    bool operator !=(const ChoiceTable& other) const;
+
+  private:
+    bool case_insensitive_;
+    std::string names_;
+    std::vector<Entry> entries_;
+    std::vector<std::uint32_t> displacements_;
+    std::vector<std::uint32_t> slots_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_CHOICE_TABLE_H
@@ -0,0 +1,74 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_CONSTRAINT_SET_H
+#define AHOY_AHOY_INTERNAL_CONSTRAINT_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ahoy/constraint.h"
+#include "ahoy/internal/grammar.h"
+#include "ahoy/internal/parse_state.h"
+
+namespace ahoy {
+namespace internal {
+
+// Constraints compiled against a grammar into bit masks. Each distinct name the constraints refer
+// to gets a bit, so checking a parse gathers the presence of the named nodes into a bitset once and
+// then tests each constraint with a few bitwise operations on it.
+class ConstraintSet {
+  public:
+    // Returned by check when every constraint holds
+    static const std::size_t kSatisfied;
+
+    // No constraints
+    ConstraintSet();
+
+    // Resolves the names in |constraints| to the nodes of |grammar|. A name of no node is most
+    // likely misspelled, so the constraint naming it is reported by check as always violated.
+    ConstraintSet(const std::vector<Constraint>& constraints, const Grammar& grammar);
+
+    virtual ~ConstraintSet();
+
+    bool empty() const;
+
+    // The first name in the constraints that no node of the grammar has, or an empty string if
+    // they all name some node
+    const std::string& unknown() const;
+
+    // The index of the constraint naming unknown(), or kSatisfied if there is none
+    std::size_t unknown_constraint() const;
+
+    // The index of the first constraint violated by the nodes |state| recorded as matched, or
+    // kSatisfied. A constraint naming an unknown name is violated whatever matched.
+    std::size_t check(const ParseState& state) const;
+
+  private:
+    // A constraint whose masks are ranges of |masks_| of |words_| each
+    struct Rule {
+        ConstraintKind kind;
+        std::size_t names;
+        std::size_t dependent;
+    };
+
+    // Sets the bits of |names| in the mask starting at |masks_[mask]|
+    void set(const std::vector<std::string>& names, const std::size_t mask,
+             const std::vector<std::string>& slots);
+
+    // The number of words in each mask
+    std::size_t words_;
+    // The nodes with names constraints refer to and the bits for those names
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> nodes_;
+    std::vector<std::uint64_t> masks_;
+    std::vector<Rule> rules_;
+    std::string unknown_;
+    std::size_t unknown_constraint_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_CONSTRAINT_SET_H
@@ -0,0 +1,66 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_EDIT_DISTANCE_H
+#define AHOY_AHOY_INTERNAL_EDIT_DISTANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ahoy {
+namespace internal {
+
+// Computes the Levenshtein distance from one pattern to many texts. Patterns of up to 64 bytes use
+// Myers' bit-parallel algorithm, which handles a whole column of the distance matrix per byte of
+// text, after a setup proportional to the pattern. Longer patterns fall back to the classic
+// dynamic program.
+class EditDistance {
+  public:
+    explicit EditDistance(const std::string& pattern);
+    virtual ~EditDistance();
+
+    // The number of single byte insertions, deletions and substitutions that turn the pattern into
+    // the |size| bytes at |text|
+    std::size_t distance(const char* text, std::size_t size) const;
+
+    // Sets |results[i]| to the distance to the |sizes[i]| bytes at |texts[i]| for each of the
+    // |count| texts. This is faster than calling distance for each text.
+    void distances(const char* const texts[], const std::size_t sizes[], std::size_t count,
+                   std::size_t results[]) const;
+
+    // A cheap lower bound on the distance to the |size| bytes at |text|, which counts the bytes of
+    // the text that are not in the pattern, as each needs an edit of its own
+    std::size_t lower_bound(const char* text, std::size_t size) const;
+
+    // The number of texts distances advances together
+    static const std::size_t kLanes = 4;
+
+  private:
+    // The longest pattern handled bit-parallel
+    static const std::size_t kMaxBitParallel = 64;
+
+    // A column of the distance matrix after some bytes of a text. Bit i of |positive| or |negative|
+    // is set if row i + 1 of the column is one more or one less than row i.
+    struct Column {
+        std::uint64_t positive;
+        std::uint64_t negative;
+    };
+
+    // The column after |column| for the next byte of its text, |c|
+    Column advance(const Column& column, char c) const;
+
+    std::size_t dynamic_distance(const char* text, std::size_t size) const;
+
+    const std::string pattern_;
+    // Bit i of |match_masks_[c]| is set if byte i of the pattern is c
+    std::uint64_t match_masks_[256];
+    // Whether each byte occurs in the pattern, which unlike |match_masks_| also covers long
+    // patterns
+    bool in_pattern_[256];
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_EDIT_DISTANCE_H
@@ -0,0 +1,95 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_FLAG_REGISTRY_H
+#define AHOY_AHOY_INTERNAL_FLAG_REGISTRY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "ahoy/parse_result.h"
+#include "ahoy/internal/type.h"
+
+namespace ahoy {
+
+class Parser;
+
+namespace internal {
+
+// Describes a flag defined with AHOY_FLAG. Descriptors are constant-initialized and a pointer to
+// each is placed in the ahoy_flags linker section, so defining a flag runs no code before main().
+// It is a plain struct so it can be built by a constexpr function.
+struct FlagDescriptor {
+    // The long form of the flag, without its dashes
+    const char* name;
+    const char* help;
+    // The Type values are converted to, which is always that of the flag's value type
+    Type type;
+    // The ahoy::FlagValue the flag is read from
+    void* flag;
+    // Copies the current value of |flag| into |staging|, storage for a value of the flag's type
+    // that the registry parses into
+    void (*load)(const void* flag, void* staging);
+    // Publishes the value in |staging| as the current value of |flag|
+    void (*store)(void* flag, const void* staging);
+};
+
+// Parses arguments into the flags defined with AHOY_FLAG anywhere in the program. The grammar and
+// its form index are only built on the first call to Parse, so programs that never parse pay
+// nothing for their flags.
+class FlagRegistry {
+  public:
+    // The registry of every descriptor in the ahoy_flags section of the program. It is created on
+    // first use and never destroyed, so flags may be parsed and read during static destruction.
+    static FlagRegistry& Program();
+
+    // A registry of |descriptors|, which must outlive it
+    explicit FlagRegistry(const std::vector<const FlagDescriptor*>& descriptors);
+    virtual ~FlagRegistry();
+
+    FlagRegistry(const FlagRegistry&) = delete;
+    FlagRegistry& operator=(const FlagRegistry&) = delete;
+
+    // The descriptors of the flags, sorted by name
+    const std::vector<const FlagDescriptor*>& descriptors() const;
+
+    // Parses the arguments from the main() function like Parser::Parse, starting from the current
+    // values of the flags, and publishes the values of every flag once parsing succeeded. If it
+    // fails, no flag changes. Calls are serialized, but reading flags never waits on them. Fails
+    // with ParseError::INVALID_ARGUMENTS if two flags share a name.
+    bool Parse(const int argc, char const * const argv[], std::string* program_name,
+               ParseResult* result);
+
+  private:
+    // Where a flag's value is parsed into before it is published
+    struct Staging {
+        Staging() : string(), scalar() {}
+
+        std::string string;
+        std::aligned_storage<sizeof(std::uint64_t), alignof(std::uint64_t)>::type scalar;
+    };
+
+    // The staging storage of the flag with |descriptor|
+    void* staging(const FlagDescriptor& descriptor, Staging* staging) const;
+
+    // Builds |parser_| from the descriptors, returning false if two share a name
+    bool build();
+
+    std::vector<const FlagDescriptor*> descriptors_;
+    // Serializes Parse
+    std::mutex mutex_;
+    // Built by the first call to Parse
+    bool built_;
+    bool valid_;
+    std::vector<Staging> staging_;
+    std::unique_ptr<Parser> parser_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_FLAG_REGISTRY_H
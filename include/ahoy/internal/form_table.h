@@ -0,0 +1,30 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_FORM_TABLE_H
+#define AHOY_AHOY_INTERNAL_FORM_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ahoy {
+namespace internal {
+
+// A form of a parameter of a parser generated by ahoy_cc_parser. Generated parsers hold these in
+// constant tables sorted by form, bytewise and then shortest first, like std::string.
+struct FormEntry {
+    const char* form;
+    std::uint32_t size;
+    // The index of the parameter in the generated parser
+    std::uint32_t parameter;
+};
+
+// Finds the entry of the sorted table [begin, end) whose form is exactly the |size| bytes at |arg|,
+// returning null if there is none
+const FormEntry* FindForm(const FormEntry* begin, const FormEntry* end,
+                          const char* arg, std::size_t size);
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_FORM_TABLE_H
@@ -4,9 +4,13 @@
 #ifndef AHOY_AHOY_INTERNAL_FORMAL_PARAMETER_H
 #define AHOY_AHOY_INTERNAL_FORMAL_PARAMETER_H
 
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "ahoy/options.h"
+#include "ahoy/internal/choice_table.h"
 #include "ahoy/internal/type.h"
 
 namespace ahoy {
@@ -54,6 +58,58 @@ class FormalParameter {
     bool flag() const;
     void flag(const bool flag);
 
+    // If true, the parameter's value is a byte size with an optional unit suffix, like 4GiB. This
+    // only changes the type of the parameter and so has no getter.
+    void byte_size(const bool byte_size);
+
+    // If true, the parameter's string values must be well-formed UTF-8. This only changes the type
+    // of the parameter and so has no getter.
+    void validate_utf8(const bool validate_utf8);
+
+    // The values accepted by the parameter and the integers they map to, or null if the parameter
+    // accepts any value its type can be converted from
+    const ChoiceTable* choices() const;
+    void choices(const std::vector<Choice>& choices);
+
+    // If true, choices are matched regardless of case
+    bool case_insensitive() const;
+    void case_insensitive(const bool case_insensitive);
+
+    // If true, the parameter may be passed in any number of times and each value is appended to
+    // a std::vector of the parameter's type
+    bool repeated() const;
+    void repeated(const bool repeated);
+
+    // If true, the parameter is a flag that may be passed in any number of times and adds the number
+    // of times it was passed in to an integer. Single character short forms may be combined, e.g.
+    // -vvv counts as three occurrences of -v. Setting this also sets flag.
+    bool count() const;
+    void count(const bool count);
+
+    // The environment variable whose value is used if the parameter does not match any argument, or
+    // empty if there is none
+    const std::string& env_var() const;
+    void env_var(const std::string& env_var);
+
+    // For Properties parameters, what happens when a key is passed in more than once
+    DuplicateKeyPolicy duplicate_key_policy() const;
+    void duplicate_key_policy(const DuplicateKeyPolicy duplicate_key_policy);
+
+    // If true, a Properties parameter keeps pointers into argv rather than copying its keys and
+    // values, so argv must outlive the Properties
+    bool borrow_argv() const;
+    void borrow_argv(const bool borrow_argv);
+
+    // What the filesystem path passed to the parameter must name, which is checked once the
+    // arguments were parsed
+    PathKind path_kind() const;
+    void path_kind(const PathKind path_kind);
+
+    // If true, the repeated positional parameter claims every argument from where it matches to the
+    // end of the arguments, converting them all at once
+    bool variadic() const;
+    void variadic(const bool variadic);
+
     // Shorthand for having no forms
     bool is_positional() const;
 
@@ -72,7 +128,17 @@ class FormalParameter {
     std::string marker_;
     bool required_;
     bool flag_;
+    bool repeated_;
+    bool count_;
     Type type_;
+    // Shared between copies as it is immutable and may be large
+    std::shared_ptr<const ChoiceTable> choices_;
+    bool case_insensitive_;
+    std::string env_var_;
+    DuplicateKeyPolicy duplicate_key_policy_;
+    bool borrow_argv_;
+    PathKind path_kind_;
+    bool variadic_;
 };
 
 } // namespace internal
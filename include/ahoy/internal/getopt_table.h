@@ -0,0 +1,103 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_GETOPT_TABLE_H
+#define AHOY_AHOY_INTERNAL_GETOPT_TABLE_H
+
+#include <getopt.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ahoy {
+namespace internal {
+
+// An optstring and struct option table of getopt_long compiled for ahoy_getopt_long. Short options
+// are looked up in a table indexed by character and long options by binary search over their names
+// in sorted order, where the options a prefix abbreviates are a single run.
+class GetoptTable {
+  public:
+    // How arguments that are not options are handled, chosen by the start of the optstring
+    enum class Ordering : std::uint8_t {
+        // Options are returned before the other arguments, which are moved to the end of argv
+        PERMUTE,
+        // Scanning stops at the first argument that is not an option, for a leading '+'
+        REQUIRE_ORDER,
+        // Other arguments are returned as if they were the value of an option with code 1, for a
+        // leading '-'
+        RETURN_IN_ORDER,
+    };
+
+    // Whether a short option takes a value, with NONE for characters that are not options
+    enum class Argument : std::uint8_t { NONE, NO_ARGUMENT, REQUIRED, OPTIONAL };
+
+    // Returned by find
+    static const int kNotFound = -1;
+    static const int kAmbiguous = -2;
+
+    // Compiles |optstring| and |longopts|, which may be null and otherwise ends with an option with
+    // a null name
+    GetoptTable(const char* const optstring, const struct option* const longopts);
+
+    virtual ~GetoptTable();
+
+    GetoptTable(const GetoptTable&) = delete;
+    GetoptTable& operator=(const GetoptTable&) = delete;
+
+    // Finds the compiled table for |optstring| and |longopts| in a small process-wide cache keyed
+    // by their addresses, compiling it if it is missing or the contents changed since it was
+    // compiled, as happens when a table on the stack reuses the address of another
+    static std::shared_ptr<const GetoptTable> Find(const char* const optstring,
+                                                   const struct option* const longopts);
+
+    // If true, this was compiled from an optstring equal to |optstring| and a table whose options
+    // have the same fields as those of |longopts|. Names are compared by address, not by contents.
+    bool matches(const char* const optstring, const struct option* const longopts) const;
+
+    // The ordering requested by the optstring, which is PERMUTE unless it starts with '+' or '-'
+    Ordering ordering() const;
+
+    // If true, the optstring asked for errors to be reported by returning ':' instead of printing
+    bool silent() const;
+
+    // Whether the short option |c| takes a value
+    Argument short_option(const char c) const;
+
+    // The index in the table of the long option named by the |size| bytes at |name|. An exact
+    // match wins, and otherwise |name| may abbreviate a single option. It may also abbreviate
+    // several if they all have the same has_arg, flag and val, in which case the first is used.
+    // Returns kNotFound, or kAmbiguous after setting |ambiguities| to the indexes in table order of
+    // the first option it abbreviates and each that differs from it.
+    int find(const char* const name, const std::size_t size, std::vector<int>* ambiguities) const;
+
+    // The compiled copy of the long option at |index|
+    const struct option& long_option(const int index) const;
+
+  private:
+    // A long option in the order of |names_|
+    struct Name {
+        std::string name;
+        int index;
+    };
+
+    // What the table was compiled from, with |longopts_| empty if it was null
+    std::string optstring_;
+    bool has_longopts_;
+    std::vector<struct option> longopts_;
+    Ordering ordering_;
+    bool silent_;
+    std::array<Argument, 256> shorts_;
+    // Sorted by name and then by index, so the first of equal names is the first in the table
+    std::vector<Name> names_;
+    // Indexed like the table, with names pointing into |names_|
+    std::vector<struct option> options_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_GETOPT_TABLE_H
@@ -0,0 +1,508 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_GRAMMAR_H
+#define AHOY_AHOY_INTERNAL_GRAMMAR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "ahoy/completion.h"
+#include "ahoy/parameter.h"
+#include "ahoy/properties.h"
+#include "ahoy/internal/choice_table.h"
+#include "ahoy/internal/formal_parameter.h"
+#include "ahoy/internal/parse_state.h"
+#include "ahoy/internal/path_check.h"
+#include "ahoy/internal/store_log.h"
+#include "ahoy/internal/type.h"
+
+namespace ahoy {
+namespace internal {
+
+// Whether storage of type T can hold the values of a parameter of Type |type|, which appends to a
+// std::vector if |repeated| is set
+template<typename T, typename Enable = void>
+struct Binding {
+    static bool matches(const Type type, const bool repeated) {
+        return !repeated && TypeOf<T>::value != Type::INVALID &&
+                (type == TypeOf<T>::value ||
+                    (type == Type::BYTES && std::is_same<T, std::uint64_t>::value) ||
+                    (type == Type::UTF8_STRING && std::is_same<T, std::string>::value));
+    }
+};
+
+template<typename ElementType>
+struct Binding<std::vector<ElementType>> {
+    static bool matches(const Type type, const bool repeated) {
+        return repeated && type != Type::INVALID &&
+                (type == TypeOf<ElementType>::value ||
+                    (type == Type::UTF8_STRING && std::is_same<ElementType, std::string>::value));
+    }
+};
+
+template<>
+struct Binding<Properties> {
+    static bool matches(const Type type, const bool repeated) {
+        return repeated && type == Type::PROPERTIES;
+    }
+};
+
+template<typename Enum>
+struct Binding<Enum, typename std::enable_if<std::is_enum<Enum>::value>::type> {
+    static bool matches(const Type type, const bool repeated) {
+        return !repeated && type == TypeOf<typename std::underlying_type<Enum>::type>::value;
+    }
+};
+
+// A packed, read-only copy of a tree of Parameters that arguments are parsed against. Everything
+// but the storage pointers lives in one position-independent image. In it, the nodes are one array
+// in breadth-first order, so the options and nexts of a node are one contiguous run of it. The
+// fields read while matching are kept apart from the help text, and every string is interned once
+// into a single pool and referenced by 32-bit offsets.
+//
+// The image doubles as a snapshot that can be saved, embedded in a binary or memory-mapped, and
+// then parsed against directly after binding storage to it.
+class Grammar {
+  public:
+    // The version of the snapshot format, which changes whenever the layout of the image does
+    static const std::uint32_t kSnapshotVersion = 4;
+
+    // An empty grammar, which fails to consume anything
+    Grammar();
+
+    // Packs |root| and all of the parameters that follow it
+    explicit Grammar(const Parameter& root);
+
+    // Packs a positional string root, as used for the program name, followed by |options| and
+    // |nexts|. This avoids copying the parameters into a root Parameter first.
+    Grammar(const std::vector<Parameter>& options, const std::vector<Parameter>& nexts);
+
+    virtual ~Grammar();
+
+    Grammar(const Grammar&) = default;
+    Grammar(Grammar&&) = default;
+    Grammar& operator=(const Grammar&) = default;
+    Grammar& operator=(Grammar&&) = default;
+
+    // Greedily consumes arguments starting at |start|, setting the values of the parameters
+    // matched, and returns the number of arguments consumed or -1 on failure. The root's value is
+    // stored in |root_storage| rather than the pointer it was built with, so one grammar may be
+    // reused with different holders for the program name. See Parameter::consume for the details.
+    size_t consume(const std::vector<std::string>& args,
+                   const size_t start,
+                   void* const root_storage,
+                   ParseState* const state) const;
+
+    // Finds the candidates for |args[cursor]|, or for a new argument if |cursor| is past the end,
+    // given the arguments before it. This is a single dry run of consume over those arguments that
+    // stores no values and notes every parameter tried at |cursor|, or whose value is expected
+    // there. Only forms and choices that start with the partial argument are returned. |state|
+    // limits the dry run like a parse.
+    std::vector<Completion> complete(const std::vector<std::string>& args,
+                                     const std::size_t cursor,
+                                     ParseState* const state) const;
+
+    // Finds up to |limit| forms within a small edit distance of |arg|, or of its form if it is like
+    // --name=value, nearest first. Forms equal to it are not suggested.
+    std::vector<std::string> suggest(const std::string& arg, const std::size_t limit) const;
+
+    // Looks up the environment variables of the grammar's parameters in |variables|, which is laid
+    // out like environ, returning their values indexed by node with null for nodes without one.
+    // Each variable is read once, and if the grammar has no environment variables nothing is read
+    // and the result is empty. The values point into |variables|.
+    std::vector<const char*> environment(const char* const* const variables) const;
+
+    // Reserves room in the vectors of repeated parameters for every argument that could match them
+    void reserve(const std::vector<std::string>& args, void* const root_storage) const;
+
+    // The image of the grammar as a snapshot for load
+    std::string snapshot() const;
+
+    // Replaces this grammar with a view of the snapshot in |data|, returning false and leaving the
+    // grammar unchanged if it is not a valid snapshot of this version. The snapshot is not copied,
+    // so |data| must outlive the grammar and its copies, and it must be aligned to 8 bytes. No
+    // storage is bound to a loaded grammar, so values of parameters without storage are checked but
+    // discarded.
+    bool load(const void* const data, const std::size_t size);
+
+    // Binds |storage| to every parameter other than the root named |name|, returning false if there
+    // are none or if |storage| cannot hold their values
+    template<typename T>
+    bool bind(const std::string& name, T* const storage) {
+        return bind(name, storage, &Binding<T>::matches);
+    }
+
+    // Stores the values recorded in |log| by a successful parse against this grammar, in the same
+    // order, without matching any arguments. The root's values go in |root_storage|, and borrowed
+    // Properties point into the argv of |state|, which must hold the arguments that were parsed.
+    // Returns false if a value can no longer be stored, like a Properties key that is rejected as
+    // a duplicate, leaving the values stored before it.
+    bool replay(const StoreLog& log, void* const root_storage, ParseState* const state) const;
+
+    // If true, some parameters have an ahoy::Path to check their values against
+    bool has_paths() const;
+
+    // The values to check of the parameters with an ahoy::Path that |state| recorded as matched,
+    // read back from their storage, which must be tracking matches. Every value in the storage of
+    // a repeated parameter is included, and parameters without storage are skipped.
+    std::vector<PathRequest> paths(const ParseState& state) const;
+
+    // A hash of the image, which is equal for grammars built from equal parameters. Comparing the
+    // fingerprint of a loaded snapshot against that of the grammar it was made from detects stale
+    // snapshots.
+    std::uint64_t fingerprint() const;
+
+    // The number of parameters in the grammar
+    std::size_t size() const;
+
+    // The name, description, and marker of the parameter at |node|, in breadth-first order
+    std::string name(const std::size_t node) const;
+    std::string description(const std::size_t node) const;
+    std::string marker(const std::size_t node) const;
+
+    // The number of bytes of memory held by the grammar, including itself. The image of a loaded
+    // snapshot is not held by the grammar and is not counted.
+    std::size_t memory_footprint() const;
+
+    // Reorders the options, and the nexts, of every parameter so that those with more |hits|,
+    // indexed by node, are tried first and ties keep their order. Sorted options are tried from
+    // the first again after each match, so an argument for a common option costs few attempts.
+    // Siblings are only moved when all of them match by their forms alone and no two share a form,
+    // so each argument still matches the same parameter and the result of a parse is unchanged,
+    // though fewer steps are taken. Nodes past the end of |hits| have none. The root of a flat
+    // grammar is already indexed by form and is not affected. Loading a snapshot restores the
+    // original order.
+    void reorder(const std::vector<unsigned long long>& hits);
+
+  private:
+    // The start of the image. Each count is the number of elements in a section and each section is
+    // a byte offset into the image.
+    struct Header {
+        char magic[8];
+        // Written as kByteOrder to detect images from machines of a different endianness
+        std::uint32_t byte_order;
+        std::uint32_t version;
+        // Covers every byte of the image after itself
+        std::uint64_t fingerprint;
+        std::uint32_t size;
+        std::uint32_t node_count;
+        std::uint32_t form_count;
+        std::uint32_t choice_count;
+        std::uint32_t entry_count;
+        std::uint32_t word_count;
+        std::uint32_t pool_size;
+        std::uint32_t nodes;
+        std::uint32_t help;
+        std::uint32_t forms;
+        std::uint32_t choices;
+        std::uint32_t entries;
+        std::uint32_t words;
+        std::uint32_t pool;
+    };
+
+    // A range of the pool
+    struct StringRef {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    // The fields of a parameter read while matching arguments
+    struct Node {
+        // The forms of the node are |forms_[first_form, first_form + form_count)|
+        std::uint32_t first_form;
+        std::uint32_t form_count;
+        // The options of the node, followed by its nexts, start at |nodes_[first_child]|
+        std::uint32_t first_child;
+        std::uint32_t option_count;
+        std::uint32_t next_count;
+        // One more than an index into |choices_| or 0 if the node accepts any value
+        std::uint32_t choices;
+        // The node's Type, narrowed to a byte
+        std::uint8_t type;
+        // A combination of the k*Attribute bits
+        std::uint8_t attributes;
+        // The node's PathKind, narrowed to a byte
+        std::uint8_t path;
+        // 1 if the node claims every argument from where it matches on, as every bit of
+        // |attributes| is taken
+        std::uint8_t variadic;
+    };
+
+    // The fields of a parameter only read to describe it, or once per parse
+    struct Help {
+        StringRef name;
+        StringRef description;
+        StringRef marker;
+        StringRef env_var;
+    };
+
+    // A ChoiceTable flattened into the image. Its names start at |names| in the pool, its entries
+    // are a range of |entries_| and its displacements and slots are ranges of |words_|.
+    struct PackedChoices {
+        std::uint32_t names;
+        std::uint32_t first_entry;
+        std::uint32_t entry_count;
+        std::uint32_t first_displacement;
+        std::uint32_t displacement_count;
+        std::uint32_t first_slot;
+        std::uint32_t slot_count;
+        std::uint32_t case_insensitive;
+    };
+
+    // The sections of an image while it is being built
+    struct Sections;
+
+    // A node with an environment variable, which is found by the hash of the variable's name
+    struct EnvironmentEntry {
+        std::uint64_t hash;
+        std::uint32_t node;
+        // The node whose options or nexts include |node|, or 0 for the root itself
+        std::uint32_t parent;
+    };
+
+    // A form of an option of the root of a flat grammar, which indexes the option among the root's
+    struct FlatForm {
+        StringRef form;
+        std::uint32_t option;
+    };
+
+    static const std::uint8_t kRequiredAttribute = 1 << 0;
+    static const std::uint8_t kFlagAttribute = 1 << 1;
+    static const std::uint8_t kRepeatedAttribute = 1 << 2;
+    static const std::uint8_t kCountAttribute = 1 << 3;
+    // Set when the nexts of the node contain more than one required parameter
+    static const std::uint8_t kInvalidAttribute = 1 << 4;
+    // The DuplicateKeyPolicy of a Properties node, which is LAST_WINS if neither is set
+    static const std::uint8_t kFirstWinsAttribute = 1 << 5;
+    static const std::uint8_t kRejectDuplicatesAttribute = 1 << 6;
+    // Set when a Properties node keeps pointers into argv
+    static const std::uint8_t kBorrowAttribute = 1 << 7;
+
+    // Marks left by a dry run for completion when a node was tried at the probed position, or
+    // matched a form just before it and needs its value there
+    static const std::uint8_t kProbedForm = 1 << 0;
+    static const std::uint8_t kProbedValue = 1 << 1;
+
+    // Packs |root| and the parameters that follow it into an image owned by the grammar
+    void build(const FormalParameter& root,
+               void* const root_storage,
+               const std::vector<Parameter>& options,
+               const std::vector<Parameter>& nexts);
+
+    // Adds the number of parameters and forms in the tree at |parameter| to |nodes| and |forms|
+    static void count(const Parameter& parameter, std::size_t* nodes, std::size_t* forms);
+
+    // Appends the node for a parameter and queues its options and nexts onto |parameters|
+    static void add(const FormalParameter& fp,
+                    const std::vector<Parameter>& options,
+                    const std::vector<Parameter>& nexts,
+                    std::vector<const Parameter*>* parameters,
+                    Sections* sections);
+
+    // Adds |value| to the pool unless it is already there
+    static StringRef intern(const std::string& value, Sections* sections);
+
+    // Copies |sections| into one image and points the grammar at it
+    void pack(const Sections& sections);
+
+    // Points the grammar at the image in |data| if it is valid
+    bool map(const char* const data, const std::size_t size);
+
+    // Indexes the nodes with environment variables or paths, and the options of the root by form if
+    // the grammar is flat, meaning the root has options but no nexts and none of its options have
+    // children of their own
+    void index();
+
+    // Hashes the |size| bytes of the image at |data| that follow its fingerprint
+    static std::uint64_t Fingerprint(const char* const data, const std::size_t size);
+
+    // Binds |storage| to the nodes named |name| whose Type and attributes pass |matches|
+    bool bind(const std::string& name, void* const storage,
+              bool (*matches)(const Type type, const bool repeated));
+
+    std::string str(const StringRef& ref) const;
+
+    // The choices of |node|, which must have some
+    ChoiceTable::View choices(const Node& node) const;
+
+    // Returns true if |arg| is exactly |form|
+    bool equals(const StringRef& form, const std::string& arg) const;
+
+    // Returns true if |arg| starts with |form| followed by '='
+    bool prefixes(const StringRef& form, const std::string& arg) const;
+
+    // Returns true if |arg| starts with |form| followed by anything, like -Dname=value does -D
+    bool attaches(const StringRef& form, const std::string& arg) const;
+
+    // Returns true if |node| must match an argument, as it is required and has no value from the
+    // environment to fall back to
+    bool missing(const std::uint32_t node, const ParseState* const state) const;
+
+    // Stores the values from the environment of the nodes that did not match any argument but
+    // whose parent did, returning false if any of them are invalid. Nodes in branches of the
+    // grammar that the arguments did not take are left alone. The root's value goes in
+    // |root_storage|.
+    bool assign_environment(void* const root_storage, ParseState* const state) const;
+
+    // Consumes the arguments for |node| itself, ignoring its options and nexts, and returns the
+    // number consumed or -1 on failure
+    size_t match(const std::uint32_t node,
+                 const std::vector<std::string>& args,
+                 const size_t start,
+                 void* const storage,
+                 ParseState* const state) const;
+
+    // Consumes arguments for |node|, whose value is stored in |storage|
+    size_t consume(const std::uint32_t node,
+                   const std::vector<std::string>& args,
+                   const size_t start,
+                   void* const storage,
+                   ParseState* const state) const;
+
+    // Consumes arguments for the child |node| of a node being consumed. If it fails, whatever was
+    // matched and stored below it is undone so that only the branch the arguments took counts.
+    size_t attempt(const std::uint32_t node,
+                   const std::vector<std::string>& args,
+                   const size_t start,
+                   ParseState* const state) const;
+
+    // Undoes what was recorded in |state| since |mark|
+    void rollback(const std::size_t mark, ParseState* const state) const;
+
+    // Records how to undo appending to the vector of |node| at |storage| if an attempt is underway
+    void record_append(const Node& node, void* const storage, ParseState* const state) const;
+
+    // Repeatedly tries the options of |node| that are still available at the end of what has been
+    // consumed, returning the new amount consumed. |status| holds an OptionStatus per option.
+    size_t try_options(const Node& node,
+                       std::vector<std::uint8_t>* status,
+                       const std::vector<std::string>& args,
+                       const size_t start,
+                       size_t consumed,
+                       ParseState* const state) const;
+
+    // Consumes arguments for the root of a flat grammar in a single pass. Each argument is looked
+    // up in the index and only the options it can match are tried, in the order try_options would
+    // reach them, so the result is the same as consuming the root.
+    size_t consume_flat(const std::vector<std::string>& args,
+                        const size_t start,
+                        void* const root_storage,
+                        ParseState* const state) const;
+
+    // Sets |candidates| to the options of the root of a flat grammar that could match |arg|
+    void flat_candidates(const std::string& arg, std::vector<std::uint32_t>* candidates) const;
+
+    // The storage to pass when consuming |node|, which is null for a dry run
+    void* storage_for(const std::uint32_t node, const ParseState* const state) const;
+
+    // Adds the choices of |node| prefixed by |lead| that start with |word| to |completions|, or a
+    // hint if the node takes free-form values. |seen| holds the completions added so far.
+    void complete_value(const std::uint32_t node,
+                        const std::string& lead,
+                        const std::string& word,
+                        std::unordered_set<std::string>* seen,
+                        std::vector<Completion>* completions) const;
+
+    // Adds a completion unless it was already added
+    void add_completion(const CompletionKind kind,
+                        const std::string& value,
+                        const std::uint32_t node,
+                        std::unordered_set<std::string>* seen,
+                        std::vector<Completion>* completions) const;
+
+    // Converts |value| and stores it for |node|. A null |storage| only checks the value. Stored
+    // values are recorded in the log of |state| if it has one.
+    bool assign(const Node& node, void* const storage, const std::string& value,
+                ParseState* const state) const;
+
+    // Converts every argument from |start| on and appends them to the vector of the variadic
+    // |node| at once. A null |storage| only checks the values. Stored values are recorded in the
+    // log of |state| if it has one.
+    bool assign_remaining(const Node& node, void* const storage,
+                          const std::vector<std::string>& args, const size_t start,
+                          ParseState* const state) const;
+
+    // Splits |arg| from |offset| on into a key and value at the first '=' and adds them to the
+    // Properties of |node|. If |node| borrows from argv, the Properties keeps pointers into the
+    // argument of main() at |position|, which is -1 for values that did not come from an argument.
+    // A null |storage| only checks the key.
+    bool assign_property(const Node& node,
+                         void* const storage,
+                         const std::string& arg,
+                         const std::size_t offset,
+                         const size_t position,
+                         ParseState* const state) const;
+
+    // The argument of main() that |args[position]| was copied from if |node| borrows its value from
+    // there, or null
+    const char* borrowed(const Node& node,
+                         const size_t position,
+                         const ParseState* const state) const;
+
+    // Stores that the flag |node| was present |occurrences| times, unless |storage| is null
+    bool assign_flag(const Node& node, void* const storage,
+                     const unsigned long long occurrences, ParseState* const state) const;
+
+    // Records the value just stored in |storage| for |node| in |log|
+    void log_value(const Node& node, const void* const storage, StoreLog* const log) const;
+
+    // The index of |node| in |nodes_|
+    std::uint32_t index_of(const Node& node) const;
+
+    // If true, the |count| siblings starting at |first| only match arguments equal to one of their
+    // own forms, or starting with one and '=', so they may be tried in any order. Nexts must also
+    // be optional, as trying a required next that does not match fails the parse.
+    bool reorderable(const std::uint32_t first, const std::uint32_t count, const bool nexts) const;
+
+    // The index of the child tried |position|th among the options and nexts of |node|. Dry runs for
+    // completion try them in the order of the parameters so the nodes they note are the same
+    // whatever the order.
+    std::uint32_t child(const Node& node, const std::uint32_t position,
+                        const ParseState* const state) const;
+
+    // Counts the occurrences of single character short forms combined in |arg|, like -vvv
+    unsigned long long combined_occurrences(const Node& node, const std::string& arg) const;
+
+    // Owns the image unless the grammar is a view of a snapshot owned by someone else. Copies of
+    // the grammar share it as it is never modified.
+    std::shared_ptr<const std::vector<std::uint64_t>> image_;
+    // The sections of the image, which are null for an empty grammar
+    const Header* header_;
+    const Node* nodes_;
+    const Help* help_;
+    const StringRef* forms_;
+    const PackedChoices* choices_;
+    const ChoiceTable::Entry* entries_;
+    const std::uint32_t* words_;
+    const char* pool_;
+    // Indexed like |nodes_|, kept apart as it differs between processes and is written through
+    std::vector<void*> storage_;
+    // Ordered by hash
+    std::vector<EnvironmentEntry> environment_;
+    // Set by index for grammars that consume_flat handles
+    bool flat_;
+    // The forms of the options of a flat root, ordered by their text
+    std::vector<FlatForm> flat_forms_;
+    // The options of a flat root that may match arguments other than their forms, which are those
+    // without forms and counts whose short forms can be combined
+    std::vector<std::uint32_t> flat_unindexed_;
+    // The nodes other than the root with a PathKind other than PathKind::ANY
+    std::vector<std::uint32_t> paths_;
+    // Indexed like |nodes_|, the node tried in each position among its siblings. It stays empty,
+    // meaning every node is tried in its own position, until reorder is called.
+    std::vector<std::uint32_t> order_;
+    // Indexed by node, whether reorder sorted its options, which are then tried from the first
+    // again after each match
+    std::vector<bool> sorted_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_GRAMMAR_H
@@ -0,0 +1,27 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_HASH_H
+#define AHOY_AHOY_INTERNAL_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ahoy {
+namespace internal {
+
+// Hashes |size| bytes starting at |data|. These hashes are fast but not cryptographic and must not
+// be relied upon for security. If |case_insensitive| is true, ASCII letters are hashed as if they
+// were lowercase.
+std::uint64_t HashBytes(const char* data, std::size_t size, bool case_insensitive = false);
+
+// Scrambles the bits of |value| so that every input bit affects every output bit
+std::uint64_t Mix64(std::uint64_t value);
+
+// Lowercases an ASCII letter, leaving other characters unchanged
+char ToLowerAscii(char c);
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_HASH_H
@@ -0,0 +1,54 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_HIT_COUNTERS_H
+#define AHOY_AHOY_INTERNAL_HIT_COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ahoy {
+namespace internal {
+
+// Counts how many times each node of a grammar matched an argument. Counting is a relaxed atomic
+// increment, so parses on several threads may share the counters.
+class HitCounters {
+  public:
+    // Counters for a grammar with |nodes| nodes, which are disabled if |nodes| is 0
+    explicit HitCounters(const std::size_t nodes = 0);
+
+    // Copies count as many nodes but start at zero, like a new parser would
+    HitCounters(const HitCounters& other);
+    HitCounters& operator=(const HitCounters& other);
+
+    virtual ~HitCounters();
+
+    // Shorthand for counting no nodes
+    bool disabled() const;
+
+    // The number of nodes counted
+    std::size_t size() const;
+
+    // Counts a match of |node|, ignoring nodes past the end
+    void hit(const std::size_t node);
+
+    // The number of matches of |node| so far, which is 0 for nodes past the end
+    unsigned long long hits(const std::size_t node) const;
+
+    // The matches of every node so far, indexed by node
+    std::vector<unsigned long long> counts() const;
+
+    // Sets every count back to zero
+    void clear();
+
+  private:
+    std::size_t size_;
+    std::unique_ptr<std::atomic<unsigned long long>[]> counts_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_HIT_COUNTERS_H
@@ -0,0 +1,80 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_PARSE_CACHE_H
+#define AHOY_AHOY_INTERNAL_PARSE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ahoy/internal/store_log.h"
+
+namespace ahoy {
+namespace internal {
+
+// A bounded map from the arguments of successful parses to the values they stored, which evicts the
+// least recently used entry once it is full. Entries are found by a hash of their key and the keys
+// are compared in full, so a collision is only a miss. It is safe to use from several threads.
+class ParseCache {
+  public:
+    // A cache holding up to |capacity| entries, which is disabled if |capacity| is 0
+    explicit ParseCache(const std::size_t capacity = 0);
+
+    // Copies have the same capacity but start out empty, as the entries only suit one grammar
+    ParseCache(const ParseCache& other);
+    ParseCache& operator=(const ParseCache& other);
+
+    virtual ~ParseCache();
+
+    // Shorthand for a capacity of 0
+    bool disabled() const;
+
+    std::size_t capacity() const;
+
+    // The number of entries held
+    std::size_t size() const;
+
+    // Builds the key of the |argc| arguments in |argv| and the environment variable values in
+    // |environment|, which holds a value or null per node
+    static std::string Key(const int argc, char const * const argv[],
+                           const std::vector<const char*>& environment);
+
+    // The log stored for |key|, or null if there is none, counting a hit or a miss
+    std::shared_ptr<const StoreLog> find(const std::string& key);
+
+    // Stores |log| for |key|, evicting the least recently used entry if the cache is full
+    void insert(const std::string& key, const std::shared_ptr<const StoreLog>& log);
+
+    // Removes every entry, leaving the counters alone
+    void clear();
+
+    // The number of calls to find that found an entry, and that did not
+    unsigned long long hits() const;
+    unsigned long long misses() const;
+
+  private:
+    struct Entry {
+        std::uint64_t hash;
+        std::string key;
+        std::shared_ptr<const StoreLog> log;
+    };
+
+    std::size_t capacity_;
+    // Most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index_;
+    unsigned long long hits_;
+    unsigned long long misses_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_PARSE_CACHE_H
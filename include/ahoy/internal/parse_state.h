@@ -0,0 +1,174 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_PARSE_STATE_H
+#define AHOY_AHOY_INTERNAL_PARSE_STATE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ahoy/parse_result.h"
+
+namespace ahoy {
+namespace internal {
+
+class HitCounters;
+class StoreLog;
+
+// Tracks the work done by a single call to Parser::Parse and aborts it once it exceeds its limits
+class ParseState {
+  public:
+    // Something stored during an attempt, with what it replaced so it can be undone if the attempt
+    // is abandoned
+    struct Undo {
+        enum class Kind : std::uint8_t {
+            // |node| was recorded by match
+            MATCH,
+            // The log held |before| stores
+            LOG,
+            // The vector of |node| held |before| elements
+            APPEND,
+            // The count of |node| held the bytes of |before|
+            COUNT,
+            // The properties of |node| held |before| entries
+            PROPERTY_COUNT,
+            // The entry at index |before| of the properties of |node| had |value| as its value
+            PROPERTY_VALUE,
+        };
+
+        Kind kind;
+        std::uint32_t node;
+        unsigned long long before;
+        const char* value;
+        std::size_t value_size;
+    };
+
+    // A state without limits
+    ParseState();
+
+    // A |step_budget| or |timeout| of zero disables that limit. |cancelled| may be null and is
+    // otherwise polled while parsing.
+    ParseState(const unsigned long long step_budget,
+               const std::chrono::nanoseconds timeout,
+               const std::atomic<bool>* const cancelled);
+
+    virtual ~ParseState();
+
+    ParseState(const ParseState&) = delete;
+    ParseState& operator=(const ParseState&) = delete;
+
+    // Records a step, returning false if parsing must stop because a limit was reached
+    bool step();
+
+    // If true, a limit was reached and all further steps will fail
+    bool aborted() const;
+
+    // Why parsing was aborted or ParseError::NONE if it was not
+    ParseError error() const;
+
+    // The number of steps taken so far
+    unsigned long long steps() const;
+
+    // Makes the parse a dry run that stores no values. Instead, each grammar node tried at argument
+    // |position| is marked in |probes|, which is indexed by node and must outlive the parse.
+    void probe(const std::size_t position, std::vector<std::uint8_t>* const probes);
+
+    // The marks of a dry run or null if this is a real parse
+    std::vector<std::uint8_t>* probes() const;
+
+    // The argument position probed by a dry run
+    std::size_t probe_position() const;
+
+    // Records that some parameter matched the arguments before |position|
+    void reach(const std::size_t position);
+
+    // The furthest position recorded by reach. When parsing fails, the argument there is the first
+    // one that no attempt got past.
+    std::size_t reached() const;
+
+    // Supplies the values of environment variables for the grammar, indexed by node and null for
+    // nodes without one. |values| must outlive the parse. This tracks matches for every node with
+    // a value.
+    void environment(const std::vector<const char*>* const values);
+
+    // The value of the environment variable of |node|, or null if it has none
+    const char* variable(const std::size_t node) const;
+
+    // Makes match record the nodes of a grammar with |nodes| nodes, which it otherwise ignores
+    void track(const std::size_t nodes);
+
+    // Records that |node| matched an argument, or took its value from the environment
+    void match(const std::size_t node);
+
+    // If true, |node| was recorded by match while it was tracked
+    bool matched(const std::size_t node) const;
+
+    // Supplies the arguments of main() that the parsed arguments were copied from, in the same
+    // order, so parameters can keep pointers into them. |argv| must outlive the parse.
+    void argv(char const * const * const argv);
+
+    // The arguments passed to argv, or null if the parsed arguments did not come from main()
+    char const * const * argv() const;
+
+    // Makes the parse record every value it stores in |log|, which must outlive the parse. Null
+    // stops recording.
+    void log(StoreLog* const log);
+
+    // Where stored values are recorded, or null if they are not
+    StoreLog* log() const;
+
+    // Makes hit count the nodes that match arguments in |counters|, which must outlive the parse.
+    // Null stops counting.
+    void counters(HitCounters* const counters);
+
+    // Counts a match of |node| if counters were supplied and this is not a dry run
+    void hit(const std::size_t node);
+
+    // Starts an attempt to match a node that may still fail after some of the parameters below it
+    // matched, returning a mark for undo. Until the attempt ends, matches and stores are recorded
+    // so they can be undone. Attempts nest.
+    std::size_t attempt();
+
+    // Ends the innermost attempt, keeping what it stored. What it stored is only forgotten once
+    // no attempt remains that could still be undone.
+    void commit();
+
+    // If true, an attempt is underway and stores must be recorded with record
+    bool attempting() const;
+
+    // Records how to undo a store made during an attempt
+    void record(const Undo& undo);
+
+    // Removes the last record made after |mark| and returns true, or returns false if there are no
+    // more. Matches and the log are undone here, and other records are returned in |undo| for the
+    // grammar, which knows their types, to undo.
+    bool pop(const std::size_t mark, Undo* const undo);
+
+  private:
+    const unsigned long long step_budget_;
+    const bool has_deadline_;
+    const std::chrono::steady_clock::time_point deadline_;
+    const std::atomic<bool>* const cancelled_;
+    unsigned long long steps_;
+    ParseError error_;
+    std::size_t probe_position_;
+    std::vector<std::uint8_t>* probes_;
+    std::size_t reached_;
+    const std::vector<const char*>* environment_;
+    // A bit per tracked node
+    std::vector<bool> matched_;
+    char const * const * argv_;
+    StoreLog* log_;
+    HitCounters* counters_;
+    // The attempts underway and what they recorded, oldest first
+    std::size_t attempts_;
+    std::vector<Undo> undos_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_PARSE_STATE_H
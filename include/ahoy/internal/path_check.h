@@ -0,0 +1,38 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_PATH_CHECK_H
+#define AHOY_AHOY_INTERNAL_PATH_CHECK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ahoy/path.h"
+
+namespace ahoy {
+namespace internal {
+
+// A value of the parameter at |node| to check against the filesystem
+struct PathRequest {
+    std::uint32_t node;
+    PathKind kind;
+    std::string path;
+};
+
+// Why |path| does not satisfy |kind|, like "does not exist", or empty if it does. This blocks on
+// the filesystem, which may take a long time for network mounts.
+std::string CheckPath(const std::string& path, const PathKind kind);
+
+// Checks every request, returning the reasons from CheckPath indexed like |requests|. The checks
+// are spread over up to |threads| threads, including the calling one, so slow filesystems are
+// waited on concurrently. With one thread or one request, or if no more threads can be started,
+// the checks run on the calling thread.
+std::vector<std::string> CheckPaths(const std::vector<PathRequest>& requests,
+                                    const std::size_t threads);
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_PATH_CHECK_H
@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_STORE_LOG_H
+#define AHOY_AHOY_INTERNAL_STORE_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ahoy {
+namespace internal {
+
+// The values a parse stored in the storage of its parameters, in the order it stored them, so a
+// parse of the same arguments can store them again without matching the arguments
+class StoreLog {
+  public:
+    // How a Store changed the storage of its node
+    enum class Kind : std::uint8_t {
+        // Overwrote it with |data|
+        VALUE,
+        // Converted |data| and appended it to a std::vector
+        APPEND,
+        // Added |occurrences| to an integer
+        COUNT,
+        // Added the key and value in |data| to a Properties
+        PROPERTY,
+    };
+
+    // Positions of Kind::PROPERTY stores that copied their argument rather than borrowing it
+    static const std::uint32_t kNoPosition = 0xFFFFFFFF;
+
+    struct Store {
+        std::uint32_t node;
+        Kind kind;
+        // For Kind::PROPERTY, where the key starts in |data|, and the index in argv of the argument
+        // it points into or kNoPosition
+        std::uint32_t offset;
+        std::uint32_t position;
+        unsigned long long occurrences;
+        // For Kind::VALUE, the bytes of the converted value, or the string for string storage.
+        // Otherwise the text that was converted.
+        std::string data;
+    };
+
+    StoreLog();
+    virtual ~StoreLog();
+
+    void value(const std::uint32_t node, const std::string& data);
+    void append(const std::uint32_t node, const std::string& text);
+    void count(const std::uint32_t node, const unsigned long long occurrences);
+    void property(const std::uint32_t node, const std::string& arg, const std::uint32_t offset,
+                  const std::uint32_t position);
+
+    // Every store in the order it was made
+    const std::vector<Store>& stores() const;
+
+    // Drops the stores after the first |size|, which were made by an abandoned branch of a parse
+    void truncate(const std::size_t size);
+
+  private:
+    std::vector<Store> stores_;
+};
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_STORE_LOG_H
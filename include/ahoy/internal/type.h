@@ -4,7 +4,11 @@
 #ifndef AHOY_AHOY_INTERNAL_TYPE_H
 #define AHOY_AHOY_INTERNAL_TYPE_H
 
+#include <chrono>
+#include <cstddef>
 #include <ostream>
+#include <string>
+#include <type_traits>
 
 namespace ahoy {
 namespace internal {
@@ -27,8 +31,50 @@ enum class Type {
     DOUBLE,
     LONG_DOUBLE,
     STRING,
+    BYTES,
+    NANOSECONDS,
+    MICROSECONDS,
+    MILLISECONDS,
+    SECONDS,
+    MINUTES,
+    HOURS,
+    PROPERTIES,
+    UTF8_STRING,
 };
 
+// Maps storage types to their Type, e.g. TypeOf<int>::value is Type::INT. Other types map to
+// Type::INVALID. std::uint64_t maps to its integer Type rather than Type::BYTES and std::string to
+// Type::STRING rather than Type::UTF8_STRING.
+template<typename T> struct TypeOf : std::integral_constant<Type, Type::INVALID> {};
+template<> struct TypeOf<bool> : std::integral_constant<Type, Type::BOOL> {};
+template<> struct TypeOf<char> : std::integral_constant<Type, Type::CHAR> {};
+template<> struct TypeOf<unsigned char> : std::integral_constant<Type, Type::U_CHAR> {};
+template<> struct TypeOf<short> : std::integral_constant<Type, Type::SHORT> {};
+template<> struct TypeOf<unsigned short> : std::integral_constant<Type, Type::U_SHORT> {};
+template<> struct TypeOf<int> : std::integral_constant<Type, Type::INT> {};
+template<> struct TypeOf<unsigned int> : std::integral_constant<Type, Type::U_INT> {};
+template<> struct TypeOf<long> : std::integral_constant<Type, Type::LONG> {};
+template<> struct TypeOf<unsigned long> : std::integral_constant<Type, Type::U_LONG> {};
+template<> struct TypeOf<long long> : std::integral_constant<Type, Type::LONG_LONG> {};
+template<> struct TypeOf<unsigned long long> : std::integral_constant<Type, Type::U_LONG_LONG> {};
+template<> struct TypeOf<float> : std::integral_constant<Type, Type::FLOAT> {};
+template<> struct TypeOf<double> : std::integral_constant<Type, Type::DOUBLE> {};
+template<> struct TypeOf<long double> : std::integral_constant<Type, Type::LONG_DOUBLE> {};
+template<> struct TypeOf<std::string> : std::integral_constant<Type, Type::STRING> {};
+template<> struct TypeOf<std::chrono::nanoseconds> :
+        std::integral_constant<Type, Type::NANOSECONDS> {};
+template<> struct TypeOf<std::chrono::microseconds> :
+        std::integral_constant<Type, Type::MICROSECONDS> {};
+template<> struct TypeOf<std::chrono::milliseconds> :
+        std::integral_constant<Type, Type::MILLISECONDS> {};
+template<> struct TypeOf<std::chrono::seconds> : std::integral_constant<Type, Type::SECONDS> {};
+template<> struct TypeOf<std::chrono::minutes> : std::integral_constant<Type, Type::MINUTES> {};
+template<> struct TypeOf<std::chrono::hours> : std::integral_constant<Type, Type::HOURS> {};
+
+// The number of bytes in the storage of a single value of |type|, or 0 if its storage is not
+// trivially copyable, like std::string, or it has none
+std::size_t SizeOf(const Type type);
+
 // Writes a string form of |type| to the ostream
 std::ostream& operator<<(std::ostream& os, const Type& type);
 
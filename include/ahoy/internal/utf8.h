@@ -0,0 +1,21 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_INTERNAL_UTF8_H
+#define AHOY_AHOY_INTERNAL_UTF8_H
+
+#include <cstddef>
+
+namespace ahoy {
+namespace internal {
+
+// Returns true if the |size| bytes at |data| are well-formed UTF-8 as defined by RFC 3629, which
+// rejects overlong encodings, surrogates and code points past U+10FFFF. Runs of ASCII are skipped
+// 16 bytes at a time with SSE2 where it is available and 8 bytes at a time otherwise, so mostly
+// ASCII text is checked at close to the speed of copying it.
+bool ValidUtf8(const char* data, std::size_t size);
+
+} // namespace internal
+} // namespace ahoy
+
+#endif // AHOY_AHOY_INTERNAL_UTF8_H
@@ -4,8 +4,15 @@
 #ifndef AHOY_AHOY_OPTION_H
 #define AHOY_AHOY_OPTION_H
 
+#include <initializer_list>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ahoy/path.h"
+#include "ahoy/properties.h"
 
 // "Private" macro to declare and define Parser option classes
 #define _AHOY_OPTIONS_OPTION_CLASS(ClassName, ValueType) \
@@ -21,6 +28,36 @@
         explicit ClassName(const ValueType& value = default_value): Option(value) {} \
     }
 
+// "Private" macro to declare Parser option classes whose values are containers. Their constructors
+// and destructors are defined in options.cc, so constructing one compiles to a call rather than to
+// a copy of the container at every call site.
+#define _AHOY_OPTIONS_OUT_OF_LINE_OPTION_CLASS(ClassName, ValueType) \
+    class ClassName : public ::ahoy::internal::Option<ValueType> { \
+      public: \
+        explicit ClassName(const ValueType& value); \
+        virtual ~ClassName(); \
+    }
+
+// Like _AHOY_OPTIONS_OUT_OF_LINE_OPTION_CLASS for strings, which may also be constructed from a
+// string literal without building a std::string at the call site, like ahoy::Name("name")
+#define _AHOY_OPTIONS_STRING_OPTION_CLASS(ClassName) \
+    class ClassName : public ::ahoy::internal::Option<std::string> { \
+      public: \
+        explicit ClassName(const std::string& value); \
+        explicit ClassName(const char* value); \
+        virtual ~ClassName(); \
+    }
+
+// Like _AHOY_OPTIONS_OUT_OF_LINE_OPTION_CLASS for forms, which may also be constructed from a list
+// of string literals without building a std::set at the call site, like ahoy::LongForms({"help"})
+#define _AHOY_OPTIONS_FORMS_OPTION_CLASS(ClassName) \
+    class ClassName : public ::ahoy::internal::Option<std::set<std::string>> { \
+      public: \
+        explicit ClassName(const std::set<std::string>& value); \
+        explicit ClassName(std::initializer_list<const char*> values); \
+        virtual ~ClassName(); \
+    }
+
 namespace ahoy {
 namespace internal {
 
@@ -35,6 +72,8 @@ class Option {
   protected:
     explicit Option(const T& value) : value_(value) {}
 
+    explicit Option(T&& value) : value_(std::move(value)) {}
+
     virtual ~Option() {}
 
   private:
@@ -43,18 +82,51 @@ class Option {
 
 } // namespace internal
 
+// A value accepted by ahoy::Choices and the integer or enum it maps to
+class Choice {
+  public:
+    template<typename T>
+    Choice(const std::string& name, const T value) :
+            name_(name), value_(static_cast<long long>(value)) {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                      "Choices may only map to integers or enums.");
+    }
+
+    const std::string& name() const {
+        return name_;
+    }
+
+    long long value() const {
+        return value_;
+    }
+
+  private:
+    std::string name_;
+    long long value_;
+};
+
 // These are the named arguments for ahoy::Parser's add parameter methods.
 // Example usage:
 // ahoy::Description("My description")
 // ahoy::ShortForms({"form-1", "form-2"})
 // ahoy::Flag()
-_AHOY_OPTIONS_OPTION_CLASS(Description, std::string); // Human readable description of the argument
-_AHOY_OPTIONS_OPTION_CLASS(Name, std::string); // Human readable name of the argument
-_AHOY_OPTIONS_OPTION_CLASS(Forms, std::set<std::string>); // Exact argument form for customizability
-_AHOY_OPTIONS_OPTION_CLASS(ShortForms, std::set<std::string>); // Short arguments, like -h or -v
-_AHOY_OPTIONS_OPTION_CLASS(LongForms, std::set<std::string>); // Long arguments, like --help or --verbose
+_AHOY_OPTIONS_STRING_OPTION_CLASS(Description); // Human readable description of the argument
+_AHOY_OPTIONS_STRING_OPTION_CLASS(Name); // Human readable name of the argument
+_AHOY_OPTIONS_FORMS_OPTION_CLASS(Forms); // Exact argument form for customizability
+_AHOY_OPTIONS_FORMS_OPTION_CLASS(ShortForms); // Short arguments, like -h or -v
+_AHOY_OPTIONS_FORMS_OPTION_CLASS(LongForms); // Long arguments, like --help or --verbose
 _AHOY_OPTIONS_OPTION_CLASS_DEFAULT(Required, bool, true); // Advances option, indicating the option must be set
 _AHOY_OPTIONS_OPTION_CLASS_DEFAULT(Flag, bool, true); // Like marker, but sets the value to true if present
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(ByteSize, bool, true); // Parses a std::uint64_t as a size, like 4GiB
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(ValidateUtf8, bool, true); // Rejects strings that are not UTF-8
+_AHOY_OPTIONS_OUT_OF_LINE_OPTION_CLASS(Choices, std::vector<Choice>); // Fixed set of values, like {{"fast", 1}}
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(CaseInsensitive, bool, true); // Matches Choices regardless of case
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(Count, bool, true); // Counts repeats of a flag, like -v -v or -vvv
+_AHOY_OPTIONS_STRING_OPTION_CLASS(EnvVar); // Environment variable to fall back on
+_AHOY_OPTIONS_OPTION_CLASS(OnDuplicateKey, DuplicateKeyPolicy); // Handles repeated Properties keys
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(BorrowArgv, bool, true); // Properties point into argv, not copies
+_AHOY_OPTIONS_OPTION_CLASS_DEFAULT(Variadic, bool, true); // Vector positional taking all the rest
+_AHOY_OPTIONS_OPTION_CLASS(Path, PathKind); // Checks a path on the filesystem after parsing
 
 } // namespace ahoy
 
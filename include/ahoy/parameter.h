@@ -4,28 +4,114 @@
 #ifndef AHOY_AHOY_PARAMETER_H
 #define AHOY_AHOY_PARAMETER_H
 
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "ahoy/options.h"
 #include "ahoy/internal/formal_parameter.h"
+#include "ahoy/internal/parse_state.h"
 #include "ahoy/internal/static_assert_helper.h"
 
 #define _AHOY_PARAMETER_STATIC_ASSERT_NOT_BOTH(a, b) \
     static_assert(!ahoy::internal::does_contain_type_2<b, a, Options...>::value, \
                   "Parameter may not be both " #a " and " #b ".")
 
+#define _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(option, type) \
+    static_assert(!ahoy::internal::does_contain_type_1<option, Options...>::value || \
+                      std::is_same<PointerType, type>::value, \
+                  #option " may only be used with " #type " parameters.")
+
 // Validates the varargs of options
 template <typename... Options>
 class OptionChecker {
     _AHOY_PARAMETER_STATIC_ASSERT_NOT_BOTH(ahoy::Flag, ahoy::Required);
 };
 
-// These macros generate methods in the form
+// Validates the varargs of options against the type of the parameter's storage
+template <typename PointerType, typename... Options>
+class TypedOptionChecker {
+    _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(ahoy::ByteSize, std::uint64_t);
+    _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(ahoy::ValidateUtf8, std::string);
+    _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(ahoy::Path, std::string);
+    _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(ahoy::OnDuplicateKey, ahoy::Properties);
+    _AHOY_PARAMETER_STATIC_ASSERT_ONLY_FOR(ahoy::BorrowArgv, ahoy::Properties);
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Variadic, Options...>::value,
+                  "ahoy::Variadic may only be used with std::vector parameters.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Choices, Options...>::value ||
+                      (std::is_integral<PointerType>::value &&
+                          !std::is_same<PointerType, bool>::value) ||
+                      std::is_enum<PointerType>::value,
+                  "ahoy::Choices may only be used with integer or enum parameters.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::CaseInsensitive, Options...>::value ||
+                      ahoy::internal::does_contain_type_1<ahoy::Choices, Options...>::value,
+                  "ahoy::CaseInsensitive may only be used with ahoy::Choices.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Count, Options...>::value ||
+                      (std::is_integral<PointerType>::value &&
+                          !std::is_same<PointerType, bool>::value &&
+                          !std::is_same<PointerType, char>::value &&
+                          !std::is_same<PointerType, unsigned char>::value),
+                  "ahoy::Count may only be used with integer parameters.");
+};
+
+// Validates the varargs of options for parameters that append to a std::vector
+template <typename ElementType, typename... Options>
+class TypedOptionChecker<std::vector<ElementType>, Options...> {
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Flag, Options...>::value,
+                  "Repeated parameters may not be flags.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Count, Options...>::value,
+                  "Repeated parameters may not be counts.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Choices, Options...>::value,
+                  "Repeated parameters may not have choices.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::CaseInsensitive, Options...>::value,
+                  "ahoy::CaseInsensitive may only be used with ahoy::Choices.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::ByteSize, Options...>::value,
+                  "Repeated parameters may not be byte sizes.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::ValidateUtf8, Options...>::value ||
+                      std::is_same<ElementType, std::string>::value,
+                  "ahoy::ValidateUtf8 may only be used with std::string parameters.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Path, Options...>::value ||
+                      std::is_same<ElementType, std::string>::value,
+                  "ahoy::Path may only be used with std::string parameters.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::OnDuplicateKey, Options...>::value &&
+                      !ahoy::internal::does_contain_type_1<ahoy::BorrowArgv, Options...>::value,
+                  "ahoy::OnDuplicateKey and ahoy::BorrowArgv may only be used with "
+                  "ahoy::Properties parameters.");
+    _AHOY_PARAMETER_STATIC_ASSERT_NOT_BOTH(ahoy::Variadic, ahoy::Forms);
+    _AHOY_PARAMETER_STATIC_ASSERT_NOT_BOTH(ahoy::Variadic, ahoy::ShortForms);
+    _AHOY_PARAMETER_STATIC_ASSERT_NOT_BOTH(ahoy::Variadic, ahoy::LongForms);
+};
+
+// Validates the varargs of options for parameters that fill in ahoy::Properties
+template <typename... Options>
+class TypedOptionChecker<ahoy::Properties, Options...> {
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Flag, Options...>::value,
+                  "Properties parameters may not be flags.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Count, Options...>::value,
+                  "Properties parameters may not be counts.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Choices, Options...>::value,
+                  "Properties parameters may not have choices.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Path, Options...>::value,
+                  "ahoy::Path may only be used with std::string parameters.");
+    static_assert(!ahoy::internal::does_contain_type_1<ahoy::Variadic, Options...>::value,
+                  "ahoy::Variadic may only be used with std::vector parameters.");
+};
+
+// Declares the function that applies an option of OptionClass to the FormalParameter of a
+// Parameter being constructed. There is one of these for each option class and none of them are
+// templates, so the constructors only call them, once per option, however many combinations of
+// options a program uses.
+#define _AHOY_PARSER_BUILD_FORMAL_PARAMETER(OptionClass) \
+    static void BuildFormalNamedParameter(internal::FormalParameter* fp, \
+                                          const OptionClass& option_value);
+
+// These macros generate constructors in the form
 //
 // template<Options... options>
-// Parser& BuildFormalNamedParameter(bool*, Options...);
+// explicit Parameter(bool*, const Options&...);
 //
 // The first argument is a pointer to memory to hold the parameters value once parsed. The type
 // will enforce characteristics of arguments when parsing. e.g. a parameter whose type is int*
@@ -33,32 +119,44 @@ class OptionChecker {
 // interpreted as an int.
 //
 // The rest of the arguments are options to define the type of the parameter.
-// e.g. parser.AddPostionalParam(&param, ahoy::Required(), ahoy::Name("Param Name"));
+// e.g. ahoy::Parameter(&param, ahoy::Required(), ahoy::Name("Param Name"));
 //
-// They return a reference to the original Parser for method chaining.
-#define _AHOY_PARSER_BUILD_FORMAL_PARAMETER(OptionClass, formal_parameter_value) \
+// Only the checks of the options are templates. The rest of the work is done by the non-template
+// constructor they delegate to and by BuildFormalNamedParameter, so each call site compiles to a
+// call per option rather than to a chain of templates for its combination of options.
+#define _AHOY_PARAMETER_CTR(PointerType, InternalType) \
     template<class ...Options> \
-    static void BuildFormalNamedParameter(internal::FormalParameter* fp, \
-                                          const OptionClass& option_value, \
-                                          Options... options) { \
-        fp->formal_parameter_value(option_value.get()); \
-        BuildFormalNamedParameter(fp, options...); \
+    explicit Parameter(PointerType* storage, const Options&... options) : \
+            Parameter(static_cast<void*>(storage), InternalType, false) { \
+        OptionChecker<Options...>{}; \
+        TypedOptionChecker<PointerType, Options...>{}; \
+        _AHOY_PARAMETER_BUILD_OPTIONS(options); \
     }
 
-#define _AHOY_PARAMETER_CTR(PointerType, InternalType) \
+// Like _AHOY_PARAMETER_CTR, but for parameters that may be repeated, appending each value to a
+// std::vector
+#define _AHOY_PARAMETER_REPEATED_CTR(ElementType, InternalType) \
     template<class ...Options> \
-    explicit Parameter(PointerType* storage, Options... options) { \
+    explicit Parameter(std::vector<ElementType>* storage, const Options&... options) : \
+            Parameter(static_cast<void*>(storage), InternalType, true) { \
         OptionChecker<Options...>{}; \
-        fp_.type(InternalType); \
-        BuildFormalNamedParameter(&fp_, options...); \
-        storage_ = storage; \
+        TypedOptionChecker<std::vector<ElementType>, Options...>{}; \
+        _AHOY_PARAMETER_BUILD_OPTIONS(options); \
     }
 
+// Applies each of the pack of |options| to |fp_| in order
+#define _AHOY_PARAMETER_BUILD_OPTIONS(options) \
+    const int built[] = { 0, (BuildFormalNamedParameter(&fp_, options), 0)... }; \
+    static_cast<void>(built)
+
 namespace ahoy {
 namespace internal {
 
 typedef long long size_t;
 
+class FlagRegistry;
+class Grammar;
+
 } // namespace internal
 
 class Parameter {
@@ -78,6 +176,49 @@ class Parameter {
     _AHOY_PARAMETER_CTR(double, internal::Type::DOUBLE);
     _AHOY_PARAMETER_CTR(long double, internal::Type::LONG_DOUBLE);
     _AHOY_PARAMETER_CTR(std::string, internal::Type::STRING);
+    _AHOY_PARAMETER_CTR(std::chrono::nanoseconds, internal::Type::NANOSECONDS);
+    _AHOY_PARAMETER_CTR(std::chrono::microseconds, internal::Type::MICROSECONDS);
+    _AHOY_PARAMETER_CTR(std::chrono::milliseconds, internal::Type::MILLISECONDS);
+    _AHOY_PARAMETER_CTR(std::chrono::seconds, internal::Type::SECONDS);
+    _AHOY_PARAMETER_CTR(std::chrono::minutes, internal::Type::MINUTES);
+    _AHOY_PARAMETER_CTR(std::chrono::hours, internal::Type::HOURS);
+
+    // Each occurrence of these parameters appends its value to the vector's existing contents
+    _AHOY_PARAMETER_REPEATED_CTR(int, internal::Type::INT);
+    _AHOY_PARAMETER_REPEATED_CTR(unsigned int, internal::Type::U_INT);
+    _AHOY_PARAMETER_REPEATED_CTR(long, internal::Type::LONG);
+    _AHOY_PARAMETER_REPEATED_CTR(unsigned long, internal::Type::U_LONG);
+    _AHOY_PARAMETER_REPEATED_CTR(long long, internal::Type::LONG_LONG);
+    _AHOY_PARAMETER_REPEATED_CTR(unsigned long long, internal::Type::U_LONG_LONG);
+    _AHOY_PARAMETER_REPEATED_CTR(float, internal::Type::FLOAT);
+    _AHOY_PARAMETER_REPEATED_CTR(double, internal::Type::DOUBLE);
+    _AHOY_PARAMETER_REPEATED_CTR(std::string, internal::Type::STRING);
+
+    // Each occurrence of these parameters, like -Dname=value, adds a key and value to the map. The
+    // forms are prefixes that the key may follow directly, as in -Dname=value, or after an '=',
+    // as in --define=name=value, or in the next argument, as in -D name=value. A key without a
+    // value, like -Dname, maps to an empty value.
+    template<class ...Options>
+    explicit Parameter(Properties* storage, const Options&... options) :
+            Parameter(static_cast<void*>(storage), internal::Type::PROPERTIES, true) {
+        OptionChecker<Options...>{};
+        TypedOptionChecker<Properties, Options...>{};
+        _AHOY_PARAMETER_BUILD_OPTIONS(options);
+    }
+
+    // Enums are stored as their underlying integer type and require ahoy::Choices to map values
+    template<typename Enum, class ...Options,
+             typename = typename std::enable_if<std::is_enum<Enum>::value>::type>
+    explicit Parameter(Enum* storage, const Options&... options) :
+            Parameter(static_cast<void*>(storage),
+                      internal::TypeOf<typename std::underlying_type<Enum>::type>::value,
+                      false) {
+        static_assert(ahoy::internal::does_contain_type_1<ahoy::Choices, Options...>::value,
+                      "Enum parameters require ahoy::Choices.");
+        OptionChecker<Options...>{};
+        TypedOptionChecker<Enum, Options...>{};
+        _AHOY_PARAMETER_BUILD_OPTIONS(options);
+    }
 
     virtual ~Parameter();
 
@@ -111,21 +252,48 @@ class Parameter {
     // This is intended be consumed by Parser only
     // Greedily consumes arguments and sets this and dependent parameter values, returning true if
     // succesful. If unsuccessful, the value stored by the pointer passed in may be modified.
+    // If |state| is set, each attempt to match a parameter is counted as a step against its limits
+    // and consumption fails once it is aborted. This packs the parameters into an internal::Grammar
+    // on every call, which Parser avoids by packing its grammar once.
     internal::size_t consume(const std::vector<std::string>& args,
-                             internal::size_t start = 0) const;
+                             internal::size_t start = 0,
+                             internal::ParseState* state = nullptr) const;
+
+    // This is intended be consumed by Parser only
+    // Reserves room in the vectors of this and dependent repeated parameters for every argument
+    // that could match them, so collecting many occurrences does not repeatedly grow the vectors.
+    void reserve(const std::vector<std::string>& args) const;
+
+    // If true, the parameter may match more than once
+    bool repeats() const;
 
   private:
-    // Validate parameter configuration
-    bool is_valid() const;
-
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Forms, forms)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::LongForms, long_forms)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::ShortForms, short_forms)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Name, name)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Description, description)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Required, required)
-    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Flag, flag)
-    static void BuildFormalNamedParameter(internal::FormalParameter*);
+    // Packs parameters for parsing
+    friend class internal::Grammar;
+    // Builds parameters for flags, whose storage is only known by its Type
+    friend class internal::FlagRegistry;
+
+    // Starts a parameter of |type| stored in |storage| without any options, which the template
+    // constructors then apply. They pass a void* so they do not match themselves.
+    Parameter(void* const storage, const internal::Type type, const bool repeated);
+
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Forms)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::LongForms)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::ShortForms)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Name)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Description)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Required)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Flag)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::ByteSize)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::ValidateUtf8)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Choices)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::CaseInsensitive)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Count)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::EnvVar)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::OnDuplicateKey)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::BorrowArgv)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Path)
+    _AHOY_PARSER_BUILD_FORMAL_PARAMETER(ahoy::Variadic)
 
     void* storage_;
     internal::FormalParameter fp_;
@@ -0,0 +1,85 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_PARSE_RESULT_H
+#define AHOY_AHOY_PARSE_RESULT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ahoy/path.h"
+
+namespace ahoy {
+
+// The reason a call to Parser::Parse failed
+enum class ParseError {
+    NONE,
+    // The arguments did not match the parser's parameters
+    INVALID_ARGUMENTS,
+    // An argument matched none of the parser's parameters. See ParseResult::unmatched.
+    UNMATCHED_ARGUMENT,
+    // Parsing took more steps than allowed by Parser::withStepBudget
+    STEP_BUDGET_EXCEEDED,
+    // Parsing took longer than allowed by Parser::withTimeout
+    DEADLINE_EXCEEDED,
+    // Parsing was cancelled through the flag passed to Parser::withCancellation
+    CANCELLED,
+    // The arguments matched but broke a constraint. See ParseResult::violation.
+    CONSTRAINT_VIOLATION,
+    // The arguments matched but some values of parameters with ahoy::Path were rejected by the
+    // filesystem. See ParseResult::path_failures.
+    INVALID_PATH,
+};
+
+// Writes a string form of |error| to the ostream
+std::ostream& operator<<(std::ostream& os, const ParseError& error);
+
+// Details about a call to Parser::Parse
+class ParseResult {
+  public:
+    ParseResult();
+    virtual ~ParseResult();
+
+    // Shorthand for the error being ParseError::NONE
+    bool success() const;
+
+    // Why parsing failed, if it did
+    ParseError error() const;
+    void error(const ParseError error);
+
+    // The number of steps taken while parsing. Each step is an attempt to match a parameter at a
+    // position in the arguments.
+    unsigned long long steps() const;
+    void steps(const unsigned long long steps);
+
+    // For ParseError::UNMATCHED_ARGUMENT, the first argument that could not be matched
+    const std::string& unmatched() const;
+    void unmatched(const std::string& unmatched);
+
+    // For ParseError::UNMATCHED_ARGUMENT, the forms closest to the unmatched argument, nearest
+    // first, for "did you mean" messages. This is empty if none are close.
+    const std::vector<std::string>& suggestions() const;
+    void suggestions(const std::vector<std::string>& suggestions);
+
+    // For ParseError::CONSTRAINT_VIOLATION, the constraint that was broken, written like
+    // Exclusive(tcp, unix)
+    const std::string& violation() const;
+    void violation(const std::string& violation);
+
+    // For ParseError::INVALID_PATH, every path that was rejected, in the order of the parameters
+    const std::vector<PathFailure>& path_failures() const;
+    void path_failures(const std::vector<PathFailure>& path_failures);
+
+  private:
+    ParseError error_;
+    unsigned long long steps_;
+    std::string unmatched_;
+    std::vector<std::string> suggestions_;
+    std::string violation_;
+    std::vector<PathFailure> path_failures_;
+};
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_PARSE_RESULT_H
@@ -4,11 +4,23 @@
 #ifndef AHOY_AHOY_PARSER_H
 #define AHOY_AHOY_PARSER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ahoy/argv_span.h"
+#include "ahoy/completion.h"
+#include "ahoy/constraint.h"
 #include "ahoy/parameter.h"
+#include "ahoy/parse_result.h"
+#include "ahoy/internal/constraint_set.h"
+#include "ahoy/internal/grammar.h"
+#include "ahoy/internal/hit_counters.h"
+#include "ahoy/internal/parse_cache.h"
 
 namespace ahoy {
 
@@ -16,6 +28,8 @@ namespace ahoy {
 class Parser {
   public:
     Parser();
+    Parser(const Parser&) = default;
+    Parser& operator=(const Parser&) = default;
     virtual ~Parser();
 
     Parser& withOptions(const std::vector<Parameter>& parameters);
@@ -32,12 +46,120 @@ class Parser {
         return then({ std::forward<Parameter>(parameters)... });
     }
 
+    // Sets rules about which parameters may be present together, like ahoy::Exclusive({"tcp",
+    // "unix"}), which Parse checks once the arguments matched, failing with
+    // ParseError::CONSTRAINT_VIOLATION if one is broken. This keeps such rules out of the grammar,
+    // so it can stay flat rather than encoding them with nested Required parameters. A name that
+    // no parameter has makes every parse fail with ParseError::CONSTRAINT_VIOLATION, without
+    // storing any values, and with a violation naming it.
+    Parser& withConstraints(const std::vector<Constraint>& constraints);
+
+    template <typename... C>
+    Parser& withConstraints(C&&... constraints) {
+        return withConstraints({ Constraint(std::forward<C>(constraints))... });
+    }
+
+    // Sets the number of threads that check the values of parameters with ahoy::Path once the
+    // arguments were parsed. The checks block on the filesystem, so spreading them over a few
+    // threads overlaps the waits when there are many paths or they are on slow mounts. The calling
+    // thread is one of them, and 1 checks every path on it. The default is 4.
+    Parser& withPathCheckThreads(const std::size_t threads);
+
+    // Caches the values stored by up to |capacity| distinct successful parses, keyed by a hash of
+    // their arguments and of the environment variables their parameters read. Parsing the same
+    // arguments again stores the recorded values straight into the parameters' storage without
+    // matching the arguments, which suits programs that parse the same few argument lists many
+    // times, like dispatchers. The least recently used entry is evicted once the cache is full.
+    // A capacity of 0, the default, disables the cache.
+    //
+    // Values are stored again exactly as the recorded parse stored them, so repeated parameters
+    // append to their vectors again. Hits take no steps. Grammars with ahoy::Path parameters are
+    // never cached, as the filesystem may change between parses, and changing the options or
+    // constraints empties the cache. Copies of the parser start with an empty cache.
+    Parser& withParseCache(const std::size_t capacity);
+
+    // The number of parses answered from the cache, and of parses that looked in the cache and did
+    // not find their arguments
+    unsigned long long cache_hits() const;
+    unsigned long long cache_misses() const;
+
+    // Counts how many times each parameter matches an argument in the parses that follow, for
+    // Reorder and Profile. Counting is a relaxed atomic increment per match, and parses answered
+    // from the cache are not counted. Disabled by default. Enabling it again, or changing the
+    // options, resets the counts, and copies of the parser start from zero.
+    Parser& withHitCounters(const bool enabled);
+
+    // Tries the parameters that matched most often so far first, which saves trying the rarely
+    // used ones for every argument. Only options, or nexts, of a parameter that all match by their
+    // forms alone, such as flags and options taking a value, are reordered, so every argument still
+    // matches the same parameter and Parse stores the same values. The options of a grammar
+    // without nexts or nested parameters are already looked up by form and are unaffected.
+    // Without counts, the order the parameters were passed in is restored.
+    Parser& Reorder();
+
+    // Saves the counts as a text profile, so a later run can LoadProfile it instead of counting
+    // again. The profile holds the fingerprint of the grammar it was counted against.
+    std::string Profile() const;
+
+    // Reorders the parameters like Reorder with the counts of a profile saved by Profile. Returns
+    // false and leaves the order unchanged if |profile| is malformed or was counted against a
+    // grammar with a different fingerprint, which makes a stale profile harmless.
+    bool LoadProfile(const std::string& profile);
+
+    // Limits the number of steps Parse may take before failing with
+    // ParseError::STEP_BUDGET_EXCEEDED. Each step is an attempt to match a parameter at a position
+    // in the arguments. Use this when parsing untrusted arguments with nested grammars, which may
+    // otherwise backtrack for a long time. A budget of 0, the default, is unlimited.
+    Parser& withStepBudget(const unsigned long long steps);
+
+    // Limits the time Parse may take before failing with ParseError::DEADLINE_EXCEEDED. A timeout
+    // of zero, the default, is unlimited.
+    Parser& withTimeout(const std::chrono::nanoseconds timeout);
+
+    // Makes Parse fail with ParseError::CANCELLED once |cancelled| becomes true, allowing another
+    // thread to abort it. |cancelled| must outlive any calls to Parse and may be null to disable
+    // cancellation.
+    Parser& withCancellation(const std::atomic<bool>* cancelled);
+
+    // Reads the environment variables of parameters with ahoy::EnvVar from |environment| instead of
+    // the process's environment. |environment| is laid out like environ, a null-terminated array of
+    // "NAME=value" strings, and must outlive any calls to Parse. Null restores the default.
+    Parser& withEnvironment(const char* const* environment);
+
+    // Makes Parse stop at the first "--" after the program name and set |rest| to the arguments
+    // after it, or to an empty span at the end of argv if there is no "--". Those arguments are
+    // neither parsed nor copied, so they can be forwarded to a child process, e.g. with
+    // execvp(rest[0], rest.argv()) for a wrapper run like "wrapper -v -- child --flag". |rest| must
+    // outlive any calls to Parse and may be null to parse "--" like any other argument.
+    Parser& withPassthrough(ArgvSpan* rest);
+
     // Parses the arguments from the main() function, updating the values of parameters passed in
     // via the add param methods. Returns true if the arguments were parsed successfully and false
     // if some constraints could not be met, e.g. missing required parameters or parameters that are
-    // unsigned but are passed a negative number
+    // unsigned but are passed a negative number. If |result| is set, it is filled in with the
+    // details of the parse, like why it failed. If it failed on an argument that nothing matched,
+    // that argument and the forms closest to it are reported too.
+    //
+    // Once the arguments matched and the constraints hold, the values of parameters with
+    // ahoy::Path are checked against the filesystem all together, and if any is rejected parsing
+    // fails with ParseError::INVALID_PATH and every rejected path is reported.
+    //
+    // Parameters with an ahoy::EnvVar that match no argument take the value of their environment
+    // variable if it is set, so arguments take precedence over the environment, which takes
+    // precedence over the values the parameters started with. A required parameter whose variable
+    // is set may be left out of the arguments. The environment is read once per call.
     bool Parse(const int argc, char const * const argv[],
-                std::string* program_name = nullptr) const;
+                std::string* program_name = nullptr,
+                ParseResult* result = nullptr) const;
+
+    // Lists the candidates for the argument at index |cursor| of |argv|, for shell completion.
+    // |argv| is laid out like the arguments of main() and may end with the partial argument being
+    // completed. If |cursor| is |argc|, a new argument is completed. Candidates are the forms that
+    // could appear next, the choices of values expected next, and hints for free-form values.
+    // Values are never stored. The limits set by withStepBudget, withTimeout and withCancellation
+    // apply, and whatever was found before a limit was reached is returned.
+    std::vector<Completion> Complete(const int argc, char const * const argv[],
+                                     const int cursor) const;
 
     // Gets a reference to the current options vector
     const std::vector<Parameter>& current_options() const;
@@ -45,9 +167,59 @@ class Parser {
     // Gets a reference to the next options vector
     const std::vector<Parameter>& next_options() const;
 
+    // The number of bytes of memory held by the packed grammar that Parse runs against
+    std::size_t memory_footprint() const;
+
+    // Saves the packed grammar as a binary snapshot, which can be written to a file or embedded in
+    // a program and loaded later with LoadSnapshot to skip building the grammar. Snapshots are only
+    // read back by machines of the same endianness and by the same snapshot version of the library.
+    std::string Snapshot() const;
+
+    // Parses against the grammar in a snapshot taken by Snapshot instead of the options. Returns
+    // false and leaves the parser unchanged if |data| is not a valid snapshot. The snapshot is used
+    // in place, e.g. from a memory-mapped file, so |data| must be aligned to 8 bytes and outlive
+    // the parser and its copies. The options passed in so far are dropped, and no storage is bound
+    // to the parameters of the snapshot, so use Bind to receive their values. Values of unbound
+    // parameters are still checked but are discarded. Adding options afterwards replaces the
+    // snapshot with a grammar built from them.
+    bool LoadSnapshot(const void* const data, const std::size_t size);
+
+    // Stores the values of the parameters named |name| in |storage|, for parsers loaded from a
+    // snapshot. Returns false if there is no such parameter or if |storage| is of the wrong type
+    // for it, e.g. not a std::vector for a repeated parameter. |storage| must outlive calls to
+    // Parse.
+    template <typename T>
+    bool Bind(const std::string& name, T* const storage) {
+        return grammar_.bind(name, storage);
+    }
+
+    // A hash of the packed grammar. A snapshot is up to date with the options it was taken from if
+    // its fingerprint is equal to that of a parser built from them.
+    std::uint64_t fingerprint() const;
+
   private:
+    // The index of the "--" that ends the arguments to parse, or |argc| if there is none or
+    // withPassthrough was not used
+    int passthrough(const int argc, char const * const argv[]) const;
+
+    // Packs the options into |grammar_|
+    void rebuild();
+
     std::vector<Parameter> current_options_;
     std::vector<Parameter> next_options_;
+    internal::Grammar grammar_;
+    std::vector<Constraint> constraints_;
+    // |constraints_| resolved against |grammar_|
+    internal::ConstraintSet constraint_set_;
+    unsigned long long step_budget_;
+    std::chrono::nanoseconds timeout_;
+    const std::atomic<bool>* cancelled_;
+    const char* const* environment_;
+    ArgvSpan* rest_;
+    std::size_t path_check_threads_;
+    // Filled in by Parse, which is otherwise const
+    mutable internal::ParseCache parse_cache_;
+    mutable internal::HitCounters hit_counters_;
 };
 
 } // namespace ahoy
@@ -0,0 +1,65 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_PATH_H
+#define AHOY_AHOY_PATH_H
+
+#include <ostream>
+#include <string>
+
+namespace ahoy {
+
+// What a parameter with ahoy::Path requires of the filesystem path it is passed
+enum class PathKind {
+    // Any value is accepted without looking at the filesystem
+    ANY,
+    // The path names something that exists and is not a directory
+    EXISTING_FILE,
+    // The path names a directory that exists
+    EXISTING_DIRECTORY,
+    // The path can be written to, as it is either an existing file that is writable or does not
+    // exist yet but is in a writable directory, like an output file
+    CREATABLE,
+};
+
+// Writes a string form of |kind| to the ostream
+std::ostream& operator<<(std::ostream& os, const PathKind& kind);
+
+// A value of a parameter with ahoy::Path that the filesystem did not satisfy, as reported by
+// ParseResult::path_failures
+class PathFailure {
+  public:
+    PathFailure(const std::string& name,
+                const std::string& path,
+                const PathKind kind,
+                const std::string& reason);
+    virtual ~PathFailure();
+
+    // The ahoy::Name of the parameter the path was passed to, which is empty if it has none
+    const std::string& name() const;
+
+    // The path as it was passed in
+    const std::string& path() const;
+
+    // What the parameter required of the path
+    PathKind kind() const;
+
+    // Why the path was rejected, like "does not exist"
+    const std::string& reason() const;
+
+    bool operator ==(const PathFailure& other) const;
+    bool operator !=(const PathFailure& other) const;
+
+  private:
+    std::string name_;
+    std::string path_;
+    PathKind kind_;
+    std::string reason_;
+};
+
+// Writes a string form of |failure| to the ostream, like "input: data.csv does not exist"
+std::ostream& operator<<(std::ostream& os, const PathFailure& failure);
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_PATH_H
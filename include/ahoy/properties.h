@@ -0,0 +1,148 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_PROPERTIES_H
+#define AHOY_AHOY_PROPERTIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ahoy {
+
+namespace internal {
+class Grammar;
+} // namespace internal
+
+// What a Properties parameter does when it is passed a key it already holds
+enum class DuplicateKeyPolicy {
+    // The later value replaces the earlier one, like the JVM does for -D
+    LAST_WINS,
+    // The later value is ignored
+    FIRST_WINS,
+    // Parsing fails
+    REJECT,
+};
+
+// Writes a string form of |policy| to the ostream
+std::ostream& operator<<(std::ostream& os, const DuplicateKeyPolicy& policy);
+
+// A map of string keys to string values, filled in by parameters like -Dname=value.
+//
+// It is an open-addressing hash table of indices into a dense array of entries kept in insertion
+// order, so lookups probe a flat array and iterating visits the entries in the order they were
+// first inserted. Keys and values are either copied into blocks owned by the map or borrowed from
+// the caller, which lets a parser point them into argv rather than copying thousands of arguments.
+class Properties {
+  public:
+    // A key and its value. Values are null-terminated, but borrowed keys are not, as they usually
+    // end at the '=' of an argument.
+    struct Entry {
+        const char* key;
+        std::size_t key_size;
+        const char* value;
+        std::size_t value_size;
+
+        std::string key_str() const;
+        std::string value_str() const;
+    };
+
+    Properties();
+    virtual ~Properties();
+
+    // Copies own all of their keys and values, including those the original borrowed
+    Properties(const Properties& other);
+    Properties& operator=(const Properties& other);
+    Properties(Properties&&) = default;
+    Properties& operator=(Properties&&) = default;
+
+    // Copies the key and value into the map, returning false if the key is already present and
+    // |policy| is DuplicateKeyPolicy::REJECT
+    bool insert(const char* const key, const std::size_t key_size,
+                const char* const value, const std::size_t value_size,
+                const DuplicateKeyPolicy policy = DuplicateKeyPolicy::LAST_WINS);
+    bool insert(const std::string& key, const std::string& value,
+                const DuplicateKeyPolicy policy = DuplicateKeyPolicy::LAST_WINS);
+
+    // Like insert, but keeps pointers to the key and value instead of copying them, so they must
+    // outlive the map. |value| must be null-terminated.
+    bool borrow(const char* const key, const std::size_t key_size,
+                const char* const value, const std::size_t value_size,
+                const DuplicateKeyPolicy policy = DuplicateKeyPolicy::LAST_WINS);
+
+    // The value of |key| or null if it is not present
+    const char* find(const std::string& key) const;
+
+    // If true, |key| is present
+    bool contains(const std::string& key) const;
+
+    // The value of |key| or |fallback| if it is not present
+    std::string get(const std::string& key, const std::string& fallback = std::string()) const;
+
+    std::size_t size() const;
+    bool empty() const;
+
+    // Makes room for |count| entries in total, so inserting that many does not rehash
+    void reserve(const std::size_t count);
+
+    // Removes every entry, keeping the room reserved for them
+    void clear();
+
+    // The entries in the order their keys were first inserted
+    const Entry* begin() const;
+    const Entry* end() const;
+
+    bool operator ==(const Properties& other) const;
+    bool operator !=(const Properties& other) const;
+
+  private:
+    // The grammar undoes the entries stored by branches of a parse it abandons
+    friend class internal::Grammar;
+
+    // A slot of the hash table. |entry| is one more than an index into |entries_|, or 0 for an
+    // empty slot, and |hash| is the low bits of the key's hash, which also picks its first slot.
+    struct Slot {
+        std::uint32_t entry;
+        std::uint32_t hash;
+    };
+
+    // Inserts an entry whose strings the map will keep pointers to
+    bool put(const char* const key, const std::size_t key_size,
+             const char* const value, const std::size_t value_size,
+             const DuplicateKeyPolicy policy);
+
+    // The slot holding |key| or the empty slot where it belongs
+    std::size_t probe(const char* const key, const std::size_t key_size,
+                      const std::uint32_t hash) const;
+
+    // Resizes the table to |capacity| slots, a power of two, and reinserts every entry
+    void rehash(const std::size_t capacity);
+
+    // The index of the entry of |key| or size() if it is not present
+    std::size_t index(const char* const key, const std::size_t key_size) const;
+
+    // Removes the entries after the first |size|, undoing the inserts of new keys since the map
+    // held that many. Copied strings are left in the blocks.
+    void truncate(const std::size_t size);
+
+    // Sets the value of the entry at |index| back to |value|, undoing a later insert of its key
+    void restore(const std::size_t index, const char* const value, const std::size_t value_size);
+
+    // Copies |size| bytes followed by a null terminator into the map's blocks
+    const char* copy(const char* const data, const std::size_t size);
+
+    std::vector<Entry> entries_;
+    std::vector<Slot> slots_;
+    // Copied strings, which never move once copied
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    // The unused bytes at the end of the last block
+    char* free_;
+    std::size_t free_size_;
+};
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_PROPERTIES_H
@@ -0,0 +1,117 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_AHOY_RELOADER_H
+#define AHOY_AHOY_RELOADER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ahoy/parse_result.h"
+#include "ahoy/parser.h"
+
+namespace ahoy {
+
+// Holds the configuration of a long-running program as an immutable snapshot of type T that can be
+// replaced while other threads read it, e.g. to re-read the arguments on SIGHUP.
+//
+// Each reload parses into a fresh copy of the defaults, away from the readers, and only publishes
+// the copy once parsing succeeded, so readers never see a partial or invalid configuration. Reading
+// the current snapshot is a single atomic load.
+//
+// Snapshots replaced by a reload stay valid until Reclaim is called, so readers may keep using the
+// reference they got without any bookkeeping. Call Reclaim once no reader can still hold a
+// reference to an old snapshot, e.g. after every worker has finished the requests it was serving
+// during the reload.
+template<typename T>
+class Reloader {
+  public:
+    // Builds a parser that stores the values of its parameters in the members of |values|
+    typedef std::function<Parser(T* values)> ParserFactory;
+
+    // Publishes |defaults| as the first snapshot. Every reload starts from a copy of |defaults|, so
+    // parameters left out of the arguments go back to their defaults.
+    explicit Reloader(const ParserFactory& factory, const T& defaults = T()) :
+            factory_(factory),
+            defaults_(defaults),
+            mutex_(),
+            snapshots_(),
+            current_(nullptr),
+            version_(0) {
+        snapshots_.emplace_back(new T(defaults_));
+        current_.store(snapshots_.back().get(), std::memory_order_release);
+    }
+
+    virtual ~Reloader() {}
+
+    Reloader(const Reloader&) = delete;
+    Reloader& operator=(const Reloader&) = delete;
+
+    // Parses the arguments from the main() function into a new snapshot and publishes it, returning
+    // true if it was published. If parsing fails, the current snapshot is kept. |result| is filled
+    // in like it is by Parser::Parse.
+    bool Reload(const int argc, char const * const argv[], ParseResult* result = nullptr) {
+        std::unique_ptr<T> next(new T(defaults_));
+        if (!factory_(next.get()).Parse(argc, argv, nullptr, result)) {
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+        snapshots_.push_back(std::move(next));
+        current_.store(snapshots_.back().get(), std::memory_order_release);
+        version_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    // Like Reload for arguments from another source, like a file, laid out like those of main()
+    // starting with the program name
+    bool Reload(const std::vector<std::string>& args, ParseResult* result = nullptr) {
+        std::vector<const char*> argv;
+        argv.reserve(args.size());
+        for (const std::string& arg : args) {
+            argv.push_back(arg.c_str());
+        }
+        return Reload(static_cast<int>(argv.size()), argv.data(), result);
+    }
+
+    // The current snapshot, which stays valid until Reclaim is called after it was replaced
+    const T& Get() const {
+        return *current_.load(std::memory_order_acquire);
+    }
+
+    // The number of snapshots published by Reload
+    std::uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    // Frees every snapshot but the current one. No reader may be using an older snapshot.
+    void Reclaim() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        snapshots_.erase(snapshots_.begin(), snapshots_.end() - 1);
+    }
+
+    // The number of snapshots held, including the current one
+    std::size_t retained() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return snapshots_.size();
+    }
+
+  private:
+    const ParserFactory factory_;
+    const T defaults_;
+    // Serializes publishing and reclaiming. Readers never take it.
+    mutable std::mutex mutex_;
+    // Every snapshot that may still be read, oldest first, ending with the current one
+    std::vector<std::unique_ptr<const T>> snapshots_;
+    std::atomic<const T*> current_;
+    std::atomic<std::uint64_t> version_;
+};
+
+} // namespace ahoy
+
+#endif // AHOY_AHOY_RELOADER_H
@@ -0,0 +1,82 @@
+# Copyright (c) 2018 Dustin Toff
+# Licensed under Apache License v2.0
+
+"""Generates parsers from declarative schemas of their parameters.
+
+A schema is a JSON file like:
+
+    {
+        "namespace": "my_program",
+        "config": "Flags",
+        "function": "ParseFlags",
+        "parameters": [
+            {
+                "name": "verbose",
+                "type": "bool",
+                "short_forms": ["v"],
+                "long_forms": ["verbose"],
+                "flag": true,
+                "description": "Enable verbose logging"
+            },
+            {
+                "name": "iterations",
+                "type": "int",
+                "long_forms": ["iterations"],
+                "default": 3
+            },
+            {
+                "name": "file",
+                "type": "string",
+                "required": true
+            }
+        ]
+    }
+
+"config" and "function" default to Config and Parse and "namespace" to the global namespace. Each
+parameter becomes a field of the config struct, initialized to its default. Types are the names
+of the C++ types ahoy supports, with "string" for std::string, "bytes" for sizes like 4GiB and
+"nanoseconds" through "hours" for std::chrono durations, whose defaults are counts of that unit.
+Parameters with "repeated" set are std::vectors that may be matched any number of times. Parameters
+without forms are positional and are filled in the order they are declared.
+
+Generated parsers are flat: there are no nested options or "then" branches as with ahoy::Parser.
+In exchange, forms are matched against a sorted constant table and values are converted by calls
+specialized to each field, so nothing is built at runtime.
+"""
+
+def ahoy_cc_parser(name, schema, **kwargs):
+    """Generates a cc_library with a header |name|.h declaring the parser described by |schema|.
+
+    Args:
+        name: The name of the library and of the generated files
+        schema: The JSON schema of the parameters
+        **kwargs: Passed on to the cc_library, e.g. visibility
+    """
+    header = name + ".h"
+    source = name + ".cc"
+    package = native.package_name()
+    include = (package + "/" + header) if package else header
+
+    native.genrule(
+        name = name + "_generate",
+        srcs = [schema],
+        outs = [header, source],
+        cmd = " ".join([
+            "$(location %s)" % Label("//tools:ahoy_cc_parser"),
+            "--schema $(location %s)" % schema,
+            "--header $(location %s)" % header,
+            "--source $(location %s)" % source,
+            "--include %s" % include,
+        ]),
+        tools = [Label("//tools:ahoy_cc_parser")],
+        testonly = kwargs.get("testonly", False),
+        visibility = ["//visibility:private"],
+    )
+
+    native.cc_library(
+        name = name,
+        srcs = [source],
+        hdrs = [header],
+        deps = [Label("//:ahoy")],
+        **kwargs
+    )
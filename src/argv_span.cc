@@ -0,0 +1,46 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/argv_span.h"
+
+namespace {
+
+// The arguments of an empty span, which end at once like the arguments of main() do
+char const * const kNoArgs[] = { nullptr };
+
+} // namespace
+
+namespace ahoy {
+
+ArgvSpan::ArgvSpan() : ArgvSpan(kNoArgs, 0) {}
+
+ArgvSpan::ArgvSpan(char const * const * const args, const std::size_t size) :
+        args_(args), size_(size) {}
+
+ArgvSpan::~ArgvSpan() {}
+
+std::size_t ArgvSpan::size() const {
+    return size_;
+}
+
+bool ArgvSpan::empty() const {
+    return size_ == 0;
+}
+
+const char* ArgvSpan::operator[](const std::size_t index) const {
+    return args_[index];
+}
+
+char const * const * ArgvSpan::begin() const {
+    return args_;
+}
+
+char const * const * ArgvSpan::end() const {
+    return args_ + size_;
+}
+
+char* const* ArgvSpan::argv() const {
+    return const_cast<char* const*>(args_);
+}
+
+} // namespace ahoy
@@ -0,0 +1,54 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/completion.h"
+
+namespace ahoy {
+
+std::ostream& operator<<(std::ostream& os, const CompletionKind& kind) {
+    switch (kind) {
+        case CompletionKind::FORM:
+            return os << "Form";
+        case CompletionKind::CHOICE:
+            return os << "Choice";
+        case CompletionKind::VALUE:
+            return os << "Value";
+        default:
+            return os << "Unknown";
+    }
+}
+
+Completion::Completion(const CompletionKind kind,
+                       const std::string& value,
+                       const std::string& description) :
+        kind_(kind), value_(value), description_(description) {}
+
+Completion::~Completion() {}
+
+CompletionKind Completion::kind() const {
+    return kind_;
+}
+
+const std::string& Completion::value() const {
+    return value_;
+}
+
+const std::string& Completion::description() const {
+    return description_;
+}
+
+bool Completion::operator ==(const Completion& other) const {
+    return kind_ == other.kind_ &&
+            value_ == other.value_ &&
+            description_ == other.description_;
+}
+
+bool Completion::operator !=(const Completion& other) const {
+    return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& os, const Completion& completion) {
+    return os << completion.kind() << "(" << completion.value() << ")";
+}
+
+} // namespace ahoy
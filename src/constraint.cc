@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/constraint.h"
+
+namespace ahoy {
+
+std::ostream& operator<<(std::ostream& os, const ConstraintKind& kind) {
+    switch (kind) {
+        case ConstraintKind::EXCLUSIVE:
+            return os << "Exclusive";
+        case ConstraintKind::AT_LEAST_ONE:
+            return os << "AtLeastOne";
+        case ConstraintKind::REQUIRES:
+            return os << "Requires";
+        default:
+            return os << "Unknown";
+    }
+}
+
+Constraint::Constraint(const ConstraintKind kind,
+                       const std::vector<std::string>& names,
+                       const std::string& dependent) :
+        kind_(kind), names_(names), dependent_(dependent) {}
+
+Constraint::~Constraint() {}
+
+ConstraintKind Constraint::kind() const {
+    return kind_;
+}
+
+const std::vector<std::string>& Constraint::names() const {
+    return names_;
+}
+
+const std::string& Constraint::dependent() const {
+    return dependent_;
+}
+
+bool Constraint::operator ==(const Constraint& other) const {
+    return kind_ == other.kind_ && names_ == other.names_ && dependent_ == other.dependent_;
+}
+
+bool Constraint::operator !=(const Constraint& other) const {
+    return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& os, const Constraint& constraint) {
+    os << constraint.kind() << '(';
+    if (constraint.kind() == ConstraintKind::REQUIRES) {
+        os << constraint.dependent() << "; ";
+    }
+    for (std::size_t i = 0; i < constraint.names().size(); i++) {
+        os << (i == 0 ? "" : ", ") << constraint.names()[i];
+    }
+    return os << ')';
+}
+
+Exclusive::Exclusive(const std::vector<std::string>& names) :
+        Constraint(ConstraintKind::EXCLUSIVE, names) {}
+
+AtLeastOne::AtLeastOne(const std::vector<std::string>& names) :
+        Constraint(ConstraintKind::AT_LEAST_ONE, names) {}
+
+Requires::Requires(const std::string& dependent, const std::vector<std::string>& required) :
+        Constraint(ConstraintKind::REQUIRES, required, dependent) {}
+
+} // namespace ahoy
@@ -0,0 +1,41 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/flag.h"
+
+namespace ahoy {
+
+const std::string& FlagValue<std::string>::Get() const {
+    const std::string* value = value_.load(std::memory_order_acquire);
+    if (value == nullptr) {
+        // Readers racing to create the default keep whichever string was published first
+        const std::string* const created = new std::string(default_);
+        if (value_.compare_exchange_strong(value, created, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+            value = created;
+        } else {
+            delete created;
+        }
+    }
+    return *value;
+}
+
+void FlagValue<std::string>::Load(const void* const flag, void* const staging) {
+    *static_cast<std::string*>(staging) = static_cast<const FlagValue*>(flag)->Get();
+}
+
+void FlagValue<std::string>::Store(void* const flag, const void* const staging) {
+    FlagValue* const string_flag = static_cast<FlagValue*>(flag);
+    const std::string& value = *static_cast<const std::string*>(staging);
+    // Unchanged values are not published again, so parsing repeatedly does not keep more strings
+    if (string_flag->Get() != value) {
+        string_flag->value_.store(new std::string(value), std::memory_order_release);
+    }
+}
+
+bool ParseFlags(const int argc, char const * const argv[], std::string* program_name,
+                ParseResult* result) {
+    return internal::FlagRegistry::Program().Parse(argc, argv, program_name, result);
+}
+
+} // namespace ahoy
@@ -0,0 +1,250 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/getopt.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ahoy/internal/getopt_table.h"
+
+char* ahoy_optarg = nullptr;
+int ahoy_optind = 1;
+int ahoy_opterr = 1;
+int ahoy_optopt = '?';
+
+namespace {
+
+using ahoy::internal::GetoptTable;
+
+// What a scan remembers between calls, like the private state of getopt_long
+struct Scan {
+    bool initialized;
+    // The table passed in and what it compiled to
+    const char* optstring;
+    const struct option* longopts;
+    std::shared_ptr<const GetoptTable> table;
+    GetoptTable::Ordering ordering;
+    // The rest of a group of short options, like "bc" of "-abc", or null between arguments
+    char* nextchar;
+    // argv[first_nonopt, last_nonopt) are the arguments that are not options skipped so far, which
+    // are moved after the options that follow them
+    int first_nonopt;
+    int last_nonopt;
+};
+
+Scan scan = { false, nullptr, nullptr, nullptr, GetoptTable::Ordering::PERMUTE, nullptr, 0, 0 };
+
+// If true, |arg| is not an option, which includes a lone "-"
+bool IsNonOption(const char* const arg) {
+    return arg[0] != '-' || arg[1] == '\0';
+}
+
+// Moves the skipped arguments that are not options after the options scanned since, keeping the
+// order of each
+void Exchange(char* const argv[]) {
+    char** const args = const_cast<char**>(argv);
+    std::rotate(args + scan.first_nonopt, args + scan.last_nonopt, args + ahoy_optind);
+    scan.first_nonopt += ahoy_optind - scan.last_nonopt;
+    scan.last_nonopt = ahoy_optind;
+}
+
+// Handles the long option at |scan.nextchar|, just after the "--" of argv[ahoy_optind]
+int LongOption(const int argc, char* const argv[], const GetoptTable& table, int* const longindex,
+               const bool print_errors) {
+    char* const name = scan.nextchar;
+    const std::size_t size = std::strcspn(name, "=");
+    scan.nextchar = nullptr;
+
+    std::vector<int> ambiguities;
+    const int index = table.find(name, size, print_errors ? &ambiguities : nullptr);
+    if (index == GetoptTable::kAmbiguous) {
+        if (print_errors) {
+            std::fprintf(stderr, "%s: option '--%s' is ambiguous; possibilities:", argv[0], name);
+            for (const int ambiguity : ambiguities) {
+                std::fprintf(stderr, " '--%s'", table.long_option(ambiguity).name);
+            }
+            std::fprintf(stderr, "\n");
+        }
+        ahoy_optind++;
+        ahoy_optopt = 0;
+        return '?';
+    }
+    if (index == GetoptTable::kNotFound) {
+        if (print_errors) {
+            std::fprintf(stderr, "%s: unrecognized option '--%s'\n", argv[0], name);
+        }
+        ahoy_optind++;
+        ahoy_optopt = 0;
+        return '?';
+    }
+
+    const struct option& option = table.long_option(index);
+    ahoy_optind++;
+    if (name[size] == '=') {
+        if (option.has_arg == no_argument) {
+            if (print_errors) {
+                std::fprintf(stderr, "%s: option '--%s' doesn't allow an argument\n", argv[0],
+                             option.name);
+            }
+            ahoy_optopt = option.val;
+            return '?';
+        }
+        ahoy_optarg = name + size + 1;
+    } else if (option.has_arg == required_argument) {
+        if (ahoy_optind >= argc) {
+            if (print_errors) {
+                std::fprintf(stderr, "%s: option '--%s' requires an argument\n", argv[0],
+                             option.name);
+            }
+            ahoy_optopt = option.val;
+            return table.silent() ? ':' : '?';
+        }
+        ahoy_optarg = argv[ahoy_optind++];
+    }
+
+    if (longindex != nullptr) {
+        *longindex = index;
+    }
+    if (option.flag != nullptr) {
+        *option.flag = option.val;
+        return 0;
+    }
+    return option.val;
+}
+
+// Handles the next short option of the group at |scan.nextchar|
+int ShortOption(const int argc, char* const argv[], const GetoptTable& table,
+                const bool print_errors) {
+    const char c = *scan.nextchar++;
+    const GetoptTable::Argument argument = table.short_option(c);
+    if (*scan.nextchar == '\0') {
+        ahoy_optind++;
+    }
+
+    switch (argument) {
+        case GetoptTable::Argument::NONE:
+            if (print_errors) {
+                std::fprintf(stderr, "%s: invalid option -- '%c'\n", argv[0], c);
+            }
+            ahoy_optopt = c;
+            return '?';
+        case GetoptTable::Argument::NO_ARGUMENT:
+            return c;
+        case GetoptTable::Argument::OPTIONAL:
+            if (*scan.nextchar != '\0') {
+                ahoy_optarg = scan.nextchar;
+                ahoy_optind++;
+            }
+            scan.nextchar = nullptr;
+            return c;
+        case GetoptTable::Argument::REQUIRED:
+            break;
+    }
+
+    const char* const attached = scan.nextchar;
+    scan.nextchar = nullptr;
+    if (*attached != '\0') {
+        ahoy_optarg = const_cast<char*>(attached);
+        ahoy_optind++;
+    } else if (ahoy_optind == argc) {
+        if (print_errors) {
+            std::fprintf(stderr, "%s: option requires an argument -- '%c'\n", argv[0], c);
+        }
+        ahoy_optopt = c;
+        return table.silent() ? ':' : '?';
+    } else {
+        ahoy_optarg = argv[ahoy_optind++];
+    }
+    return c;
+}
+
+} // namespace
+
+extern "C" int ahoy_getopt_long(const int argc, char* const argv[], const char* const optstring,
+                                const struct option* const longopts, int* const longindex) {
+    if (argc < 1) {
+        return -1;
+    }
+    ahoy_optarg = nullptr;
+
+    const bool starting = ahoy_optind == 0 || !scan.initialized;
+    if (starting || scan.optstring != optstring || scan.longopts != longopts) {
+        scan.table = GetoptTable::Find(optstring, longopts);
+        scan.optstring = optstring;
+        scan.longopts = longopts;
+    }
+    const GetoptTable& table = *scan.table;
+    if (starting) {
+        if (ahoy_optind == 0) {
+            ahoy_optind = 1;
+        }
+        scan.initialized = true;
+        scan.nextchar = nullptr;
+        scan.first_nonopt = ahoy_optind;
+        scan.last_nonopt = ahoy_optind;
+        scan.ordering = table.ordering();
+        if (scan.ordering == GetoptTable::Ordering::PERMUTE &&
+                std::getenv("POSIXLY_CORRECT") != nullptr) {
+            scan.ordering = GetoptTable::Ordering::REQUIRE_ORDER;
+        }
+    }
+    const bool print_errors = ahoy_opterr != 0 && !table.silent();
+
+    if (scan.nextchar == nullptr || *scan.nextchar == '\0') {
+        // The scan may have been moved back by the caller
+        scan.last_nonopt = std::min(scan.last_nonopt, ahoy_optind);
+        scan.first_nonopt = std::min(scan.first_nonopt, ahoy_optind);
+
+        if (scan.ordering == GetoptTable::Ordering::PERMUTE) {
+            if (scan.first_nonopt != scan.last_nonopt && scan.last_nonopt != ahoy_optind) {
+                Exchange(argv);
+            } else if (scan.last_nonopt != ahoy_optind) {
+                scan.first_nonopt = ahoy_optind;
+            }
+            while (ahoy_optind < argc && IsNonOption(argv[ahoy_optind])) {
+                ahoy_optind++;
+            }
+            scan.last_nonopt = ahoy_optind;
+        }
+
+        // "--" ends the options, and the arguments after it are left where they are
+        if (ahoy_optind != argc && std::strcmp(argv[ahoy_optind], "--") == 0) {
+            ahoy_optind++;
+            if (scan.first_nonopt != scan.last_nonopt && scan.last_nonopt != ahoy_optind) {
+                Exchange(argv);
+            } else if (scan.first_nonopt == scan.last_nonopt) {
+                scan.first_nonopt = ahoy_optind;
+            }
+            scan.last_nonopt = argc;
+            ahoy_optind = argc;
+        }
+
+        if (ahoy_optind == argc) {
+            // Point at the arguments that are not options, which were moved to the end
+            if (scan.first_nonopt != scan.last_nonopt) {
+                ahoy_optind = scan.first_nonopt;
+            }
+            return -1;
+        }
+
+        if (IsNonOption(argv[ahoy_optind])) {
+            if (scan.ordering == GetoptTable::Ordering::REQUIRE_ORDER) {
+                return -1;
+            }
+            ahoy_optarg = argv[ahoy_optind++];
+            return 1;
+        }
+
+        if (longopts != nullptr && argv[ahoy_optind][1] == '-') {
+            scan.nextchar = argv[ahoy_optind] + 2;
+            return LongOption(argc, argv, table, longindex, print_errors);
+        }
+        scan.nextchar = argv[ahoy_optind] + 1;
+    }
+    return ShortOption(argc, argv, table, print_errors);
+}
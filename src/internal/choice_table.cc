@@ -0,0 +1,229 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/choice_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#include "ahoy/internal/hash.h"
+
+namespace {
+
+const std::uint32_t kEmptySlot = UINT32_MAX;
+
+// The number of displacements to try for a bucket before growing the table and starting over
+const std::uint32_t kMaxDisplacement = 1024;
+
+// A multiplier that spreads consecutive displacements across the whole hash
+const std::uint64_t kDisplacementMultiplier = 0x9e3779b97f4a7c15ull;
+
+// Finds the slot |hash| maps to given the displacement of its bucket
+std::size_t Slot(const std::uint64_t hash, const std::uint32_t displacement,
+                 const std::size_t slot_count) {
+    return ahoy::internal::Mix64(hash + displacement * kDisplacementMultiplier) % slot_count;
+}
+
+// Lowercases the ASCII letters of |value|
+std::string FoldCase(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(), ahoy::internal::ToLowerAscii);
+    return value;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+ChoiceTable::ChoiceTable(const std::vector<std::pair<std::string, long long>>& choices,
+                         const bool case_insensitive) :
+        case_insensitive_(case_insensitive),
+        names_(),
+        entries_(),
+        displacements_(),
+        slots_() {
+    std::set<std::string> seen;
+    std::vector<std::uint64_t> hashes;
+    for (const std::pair<std::string, long long>& choice : choices) {
+        if (!seen.insert(case_insensitive ? FoldCase(choice.first) : choice.first).second) {
+            continue;
+        }
+        entries_.push_back({ static_cast<std::uint32_t>(names_.size()),
+                             static_cast<std::uint32_t>(choice.first.size()),
+                             choice.second });
+        names_ += choice.first;
+        hashes.push_back(HashBytes(choice.first.data(), choice.first.size(), case_insensitive));
+    }
+
+    if (entries_.empty()) {
+        return;
+    }
+
+    // Hash and displace: choices are grouped into buckets by hash and then, starting with the
+    // largest bucket, each bucket searches for a displacement that moves all of its choices into
+    // empty slots.
+    displacements_.resize(std::max<std::size_t>(1, entries_.size() / 2));
+    std::size_t slot_count = entries_.size() + entries_.size() / 4 + 1;
+
+    std::vector<std::vector<std::uint32_t>> buckets(displacements_.size());
+    for (std::uint32_t i = 0; i < entries_.size(); i++) {
+        buckets[hashes[i] % buckets.size()].push_back(i);
+    }
+    std::vector<std::size_t> order(buckets.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t a, std::size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    bool built = false;
+    while (!built) {
+        slots_.assign(slot_count, kEmptySlot);
+        built = true;
+        for (const std::size_t bucket : order) {
+            const std::vector<std::uint32_t>& members = buckets[bucket];
+            if (members.empty()) {
+                break;
+            }
+
+            std::vector<std::size_t> candidates(members.size());
+            std::uint32_t displacement = 0;
+            for (; displacement < kMaxDisplacement; displacement++) {
+                bool fits = true;
+                for (std::size_t i = 0; i < members.size() && fits; i++) {
+                    candidates[i] = Slot(hashes[members[i]], displacement, slots_.size());
+                    fits = slots_[candidates[i]] == kEmptySlot &&
+                            std::find(candidates.begin(), candidates.begin() + i, candidates[i]) ==
+                                candidates.begin() + i;
+                }
+                if (fits) {
+                    break;
+                }
+            }
+
+            if (displacement == kMaxDisplacement) {
+                slot_count *= 2;
+                built = false;
+                break;
+            }
+
+            displacements_[bucket] = displacement;
+            for (std::size_t i = 0; i < members.size(); i++) {
+                slots_[candidates[i]] = members[i];
+            }
+        }
+    }
+}
+
+ChoiceTable::~ChoiceTable() {}
+
+bool ChoiceTable::View::find(const char* value, const std::size_t size, long long* result) const {
+    if (entry_count == 0) {
+        return false;
+    }
+
+    const std::uint64_t hash = HashBytes(value, size, case_insensitive);
+    const std::uint32_t index =
+            slots[Slot(hash, displacements[hash % displacement_count], slot_count)];
+    if (index == kEmptySlot) {
+        return false;
+    }
+
+    const Entry& entry = entries[index];
+    if (entry.size != size) {
+        return false;
+    }
+
+    const char* const name = names + entry.offset;
+    if (!case_insensitive) {
+        if (std::memcmp(name, value, size) != 0) {
+            return false;
+        }
+    } else {
+        for (std::uint32_t i = 0; i < size; i++) {
+            if (ToLowerAscii(name[i]) != ToLowerAscii(value[i])) {
+                return false;
+            }
+        }
+    }
+
+    *result = entry.value;
+    return true;
+}
+
+bool ChoiceTable::View::valid(const std::size_t names_size) const {
+    if (entry_count == 0) {
+        return true;
+    }
+    if (displacement_count == 0 || slot_count == 0) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < entry_count; i++) {
+        if (entries[i].offset > names_size || entries[i].size > names_size - entries[i].offset) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < slot_count; i++) {
+        if (slots[i] != kEmptySlot && slots[i] >= entry_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChoiceTable::find(const char* value, const std::size_t size, long long* result) const {
+    return view().find(value, size, result);
+}
+
+bool ChoiceTable::find(const std::string& value, long long* result) const {
+    return find(value.data(), value.size(), result);
+}
+
+std::vector<std::pair<std::string, long long>> ChoiceTable::choices() const {
+    std::vector<std::pair<std::string, long long>> choices;
+    choices.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+        choices.emplace_back(names_.substr(entry.offset, entry.size), entry.value);
+    }
+    return choices;
+}
+
+std::size_t ChoiceTable::size() const {
+    return entries_.size();
+}
+
+bool ChoiceTable::case_insensitive() const {
+    return case_insensitive_;
+}
+
+ChoiceTable::View ChoiceTable::view() const {
+    return View{ names_.data(),
+                 entries_.data(),
+                 static_cast<std::uint32_t>(entries_.size()),
+                 displacements_.data(),
+                 static_cast<std::uint32_t>(displacements_.size()),
+                 slots_.data(),
+                 static_cast<std::uint32_t>(slots_.size()),
+                 case_insensitive_ };
+}
+
+std::size_t ChoiceTable::memory_footprint() const {
+    return sizeof(*this) +
+            names_.capacity() +
+            entries_.capacity() * sizeof(Entry) +
+            displacements_.capacity() * sizeof(std::uint32_t) +
+            slots_.capacity() * sizeof(std::uint32_t);
+}
+
+bool ChoiceTable::operator ==(const ChoiceTable& other) const {
+    return case_insensitive_ == other.case_insensitive_ && choices() == other.choices();
+}
+
+bool ChoiceTable::operator !=(const ChoiceTable& other) const {
+    return !(*this == other);
+}
+
+} // namespace internal
+} // namespace ahoy
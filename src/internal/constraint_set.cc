@@ -0,0 +1,150 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/constraint_set.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace {
+
+const std::size_t kWordBits = 64;
+
+// The number of bits set in |value|
+int PopCount(const std::uint64_t value) {
+    return __builtin_popcountll(value);
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+const std::size_t ConstraintSet::kSatisfied = std::numeric_limits<std::size_t>::max();
+
+ConstraintSet::ConstraintSet() :
+        words_(0), nodes_(), masks_(), rules_(), unknown_(), unknown_constraint_(kSatisfied) {}
+
+ConstraintSet::ConstraintSet(const std::vector<Constraint>& constraints, const Grammar& grammar) :
+        ConstraintSet() {
+    if (constraints.empty()) {
+        return;
+    }
+
+    // Every distinct name gets the bit of its index
+    std::vector<std::string> slots;
+    for (const Constraint& constraint : constraints) {
+        slots.insert(slots.end(), constraint.names().begin(), constraint.names().end());
+        if (!constraint.dependent().empty()) {
+            slots.push_back(constraint.dependent());
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+    words_ = (slots.size() + kWordBits - 1) / kWordBits;
+
+    std::vector<bool> known(slots.size(), false);
+    for (std::size_t node = 0; node < grammar.size(); node++) {
+        const auto slot = std::lower_bound(slots.begin(), slots.end(), grammar.name(node));
+        if (slot != slots.end() && *slot == grammar.name(node)) {
+            nodes_.emplace_back(static_cast<std::uint32_t>(node),
+                                static_cast<std::uint32_t>(slot - slots.begin()));
+            known[slot - slots.begin()] = true;
+        }
+    }
+    for (std::size_t i = 0; i < constraints.size() && unknown_.empty(); i++) {
+        std::vector<std::string> names = constraints[i].names();
+        if (!constraints[i].dependent().empty()) {
+            names.insert(names.begin(), constraints[i].dependent());
+        }
+        for (const std::string& name : names) {
+            if (!known[std::lower_bound(slots.begin(), slots.end(), name) - slots.begin()]) {
+                unknown_ = name;
+                unknown_constraint_ = i;
+                break;
+            }
+        }
+    }
+
+    masks_.assign(constraints.size() * 2 * words_, 0);
+    rules_.reserve(constraints.size());
+    for (std::size_t i = 0; i < constraints.size(); i++) {
+        const Rule rule{ constraints[i].kind(), 2 * i * words_, (2 * i + 1) * words_ };
+        set(constraints[i].names(), rule.names, slots);
+        if (!constraints[i].dependent().empty()) {
+            set({ constraints[i].dependent() }, rule.dependent, slots);
+        }
+        rules_.push_back(rule);
+    }
+}
+
+ConstraintSet::~ConstraintSet() {}
+
+bool ConstraintSet::empty() const {
+    return rules_.empty();
+}
+
+const std::string& ConstraintSet::unknown() const {
+    return unknown_;
+}
+
+std::size_t ConstraintSet::unknown_constraint() const {
+    return unknown_constraint_;
+}
+
+std::size_t ConstraintSet::check(const ParseState& state) const {
+    if (rules_.empty() || unknown_constraint_ != kSatisfied) {
+        return unknown_constraint_;
+    }
+
+    std::vector<std::uint64_t> present(words_, 0);
+    for (const std::pair<std::uint32_t, std::uint32_t>& node : nodes_) {
+        if (state.matched(node.first)) {
+            present[node.second / kWordBits] |= std::uint64_t(1) << (node.second % kWordBits);
+        }
+    }
+
+    for (std::size_t i = 0; i < rules_.size(); i++) {
+        const Rule& rule = rules_[i];
+        const std::uint64_t* const names = masks_.data() + rule.names;
+        const std::uint64_t* const dependent = masks_.data() + rule.dependent;
+        int present_names = 0;
+        bool missing_name = false;
+        bool present_dependent = false;
+        for (std::size_t w = 0; w < words_; w++) {
+            present_names += PopCount(present[w] & names[w]);
+            missing_name |= (present[w] & names[w]) != names[w];
+            present_dependent |= (present[w] & dependent[w]) != 0;
+        }
+
+        bool holds = true;
+        switch (rule.kind) {
+            case ConstraintKind::EXCLUSIVE:
+                holds = present_names <= 1;
+                break;
+            case ConstraintKind::AT_LEAST_ONE:
+                holds = present_names >= 1;
+                break;
+            case ConstraintKind::REQUIRES:
+                holds = !present_dependent || !missing_name;
+                break;
+        }
+        if (!holds) {
+            return i;
+        }
+    }
+    return kSatisfied;
+}
+
+void ConstraintSet::set(const std::vector<std::string>& names, const std::size_t mask,
+                        const std::vector<std::string>& slots) {
+    for (const std::string& name : names) {
+        const std::size_t slot = static_cast<std::size_t>(
+                std::lower_bound(slots.begin(), slots.end(), name) - slots.begin());
+        masks_[mask + slot / kWordBits] |= std::uint64_t(1) << (slot % kWordBits);
+    }
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/edit_distance.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// The number of set bits in |value|
+std::size_t PopCount(std::uint64_t value) {
+#if defined(__GNUC__)
+    return static_cast<std::size_t>(__builtin_popcountll(value));
+#else
+    std::size_t count = 0;
+    for (; value != 0; value &= value - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+const std::size_t EditDistance::kLanes;
+const std::size_t EditDistance::kMaxBitParallel;
+
+EditDistance::EditDistance(const std::string& pattern) :
+        pattern_(pattern),
+        match_masks_(),
+        in_pattern_() {
+    for (std::size_t i = 0; i < pattern_.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(pattern_[i]);
+        in_pattern_[c] = true;
+        if (i < kMaxBitParallel) {
+            match_masks_[c] |= std::uint64_t(1) << i;
+        }
+    }
+}
+
+EditDistance::~EditDistance() {}
+
+std::size_t EditDistance::distance(const char* const text, const std::size_t size) const {
+    std::size_t result;
+    distances(&text, &size, 1, &result);
+    return result;
+}
+
+std::size_t EditDistance::lower_bound(const char* const text, const std::size_t size) const {
+    std::size_t missing = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        missing += !in_pattern_[static_cast<unsigned char>(text[i])];
+    }
+    return missing;
+}
+
+void EditDistance::distances(const char* const texts[], const std::size_t sizes[],
+                             const std::size_t count, std::size_t results[]) const {
+    const std::size_t length = pattern_.size();
+    if (length == 0 || length > kMaxBitParallel) {
+        for (std::size_t i = 0; i < count; i++) {
+            results[i] = length == 0 ? sizes[i] : dynamic_distance(texts[i], sizes[i]);
+        }
+        return;
+    }
+
+    // The bits of the pattern
+    const std::uint64_t mask = ~std::uint64_t(0) >> (kMaxBitParallel - length);
+    for (std::size_t first = 0; first < count; first += kLanes) {
+        const std::size_t lanes = std::min(kLanes, count - first);
+        Column columns[kLanes];
+        std::size_t shortest = sizes[first];
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            columns[lane] = Column{ ~std::uint64_t(0), 0 };
+            shortest = std::min(shortest, sizes[first + lane]);
+        }
+
+        // Each text's column depends only on its own previous column, so advancing several texts
+        // together lets their steps overlap rather than wait on each other
+        std::size_t j = 0;
+        if (lanes == kLanes) {
+            for (; j < shortest; j++) {
+                for (std::size_t lane = 0; lane < kLanes; lane++) {
+                    columns[lane] = advance(columns[lane], texts[first + lane][j]);
+                }
+            }
+        }
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            const char* const text = texts[first + lane];
+            for (std::size_t k = j; k < sizes[first + lane]; k++) {
+                columns[lane] = advance(columns[lane], text[k]);
+            }
+            // The first cell of the last column is the length of the text and every bit adds the
+            // difference to the next cell down
+            results[first + lane] = sizes[first + lane] + PopCount(columns[lane].positive & mask) -
+                    PopCount(columns[lane].negative & mask);
+        }
+    }
+}
+
+EditDistance::Column EditDistance::advance(const Column& column, const char c) const {
+    const std::uint64_t match = match_masks_[static_cast<unsigned char>(c)];
+    const std::uint64_t vertical = match | column.negative;
+    const std::uint64_t horizontal =
+            (((match & column.positive) + column.positive) ^ column.positive) | match;
+    // The first row of the matrix counts up from zero, so each column starts one higher
+    const std::uint64_t horizontal_positive =
+            ((column.negative | ~(horizontal | column.positive)) << 1) | 1;
+    const std::uint64_t horizontal_negative = (column.positive & horizontal) << 1;
+    return Column{ horizontal_negative | ~(vertical | horizontal_positive),
+                   horizontal_positive & vertical };
+}
+
+std::size_t EditDistance::dynamic_distance(const char* const text, const std::size_t size) const {
+    std::vector<std::size_t> row(pattern_.size() + 1);
+    for (std::size_t i = 0; i < row.size(); i++) {
+        row[i] = i;
+    }
+    for (std::size_t j = 0; j < size; j++) {
+        std::size_t diagonal = row[0];
+        row[0] = j + 1;
+        for (std::size_t i = 1; i < row.size(); i++) {
+            const std::size_t above = row[i];
+            row[i] = std::min({ above + 1, row[i - 1] + 1,
+                                diagonal + (pattern_[i - 1] == text[j] ? 0 : 1) });
+            diagonal = above;
+        }
+    }
+    return row.back();
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/flag_registry.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ahoy/options.h"
+#include "ahoy/parameter.h"
+#include "ahoy/parser.h"
+
+#if defined(__ELF__)
+// Defined by the linker around the ahoy_flags section. They are weak so programs without any flags
+// still link, with both of them null.
+extern "C" {
+extern const ahoy::internal::FlagDescriptor* const __start_ahoy_flags[] __attribute__((weak));
+extern const ahoy::internal::FlagDescriptor* const __stop_ahoy_flags[] __attribute__((weak));
+}
+#endif
+
+namespace {
+
+// Every descriptor placed in the ahoy_flags section by AHOY_FLAG
+std::vector<const ahoy::internal::FlagDescriptor*> SectionDescriptors() {
+    std::vector<const ahoy::internal::FlagDescriptor*> descriptors;
+#if defined(__ELF__)
+    if (__start_ahoy_flags != nullptr) {
+        for (const ahoy::internal::FlagDescriptor* const* entry = __start_ahoy_flags;
+                entry != __stop_ahoy_flags; entry++) {
+            descriptors.push_back(*entry);
+        }
+    }
+#endif
+    return descriptors;
+}
+
+bool NameLess(const ahoy::internal::FlagDescriptor* a, const ahoy::internal::FlagDescriptor* b) {
+    return std::strcmp(a->name, b->name) < 0;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+FlagRegistry& FlagRegistry::Program() {
+    static FlagRegistry* const registry = new FlagRegistry(SectionDescriptors());
+    return *registry;
+}
+
+FlagRegistry::FlagRegistry(const std::vector<const FlagDescriptor*>& descriptors) :
+        descriptors_(descriptors),
+        mutex_(),
+        built_(false),
+        valid_(false),
+        staging_(),
+        parser_() {
+    std::sort(descriptors_.begin(), descriptors_.end(), NameLess);
+}
+
+FlagRegistry::~FlagRegistry() {}
+
+const std::vector<const FlagDescriptor*>& FlagRegistry::descriptors() const {
+    return descriptors_;
+}
+
+bool FlagRegistry::Parse(const int argc, char const * const argv[], std::string* program_name,
+                         ParseResult* result) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!built_) {
+        valid_ = build();
+        built_ = true;
+    }
+    if (!valid_) {
+        if (result != nullptr) {
+            *result = ParseResult();
+            result->error(ParseError::INVALID_ARGUMENTS);
+        }
+        return false;
+    }
+
+    // Parsing starts from the current values so flags that are not passed in keep them
+    for (std::size_t i = 0; i < descriptors_.size(); i++) {
+        const FlagDescriptor& descriptor = *descriptors_[i];
+        descriptor.load(descriptor.flag, staging(descriptor, &staging_[i]));
+    }
+    if (!parser_->Parse(argc, argv, program_name, result)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < descriptors_.size(); i++) {
+        const FlagDescriptor& descriptor = *descriptors_[i];
+        descriptor.store(descriptor.flag, staging(descriptor, &staging_[i]));
+    }
+    return true;
+}
+
+void* FlagRegistry::staging(const FlagDescriptor& descriptor, Staging* staging) const {
+    if (descriptor.type == Type::STRING) {
+        return &staging->string;
+    }
+    return &staging->scalar;
+}
+
+bool FlagRegistry::build() {
+    const auto duplicate = std::adjacent_find(descriptors_.begin(), descriptors_.end(),
+            [](const FlagDescriptor* a, const FlagDescriptor* b) {
+                return std::strcmp(a->name, b->name) == 0;
+            });
+    if (duplicate != descriptors_.end()) {
+        return false;
+    }
+
+    // The parameters point into |staging_|, so it is never resized afterwards
+    staging_.resize(descriptors_.size());
+    std::vector<Parameter> parameters;
+    parameters.reserve(descriptors_.size());
+    for (std::size_t i = 0; i < descriptors_.size(); i++) {
+        const FlagDescriptor& descriptor = *descriptors_[i];
+        Parameter parameter(staging(descriptor, &staging_[i]), descriptor.type, false);
+        Parameter::BuildFormalNamedParameter(&parameter.fp_, LongForms({ descriptor.name }));
+        Parameter::BuildFormalNamedParameter(&parameter.fp_, Name(descriptor.name));
+        Parameter::BuildFormalNamedParameter(&parameter.fp_, Description(descriptor.help));
+        if (descriptor.type == Type::BOOL) {
+            Parameter::BuildFormalNamedParameter(&parameter.fp_, Flag());
+        }
+        parameters.push_back(parameter);
+    }
+    // Passed as const so the vector is not taken for a single Parameter
+    const std::vector<Parameter>& options = parameters;
+    parser_.reset(new Parser());
+    parser_->withOptions(options);
+    return true;
+}
+
+} // namespace internal
+} // namespace ahoy
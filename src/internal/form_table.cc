@@ -0,0 +1,39 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/form_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Orders forms like std::string::compare
+int Compare(const char* const a, const std::size_t a_size,
+            const char* const b, const std::size_t b_size) {
+    const int order = std::memcmp(a, b, std::min(a_size, b_size));
+    if (order != 0) {
+        return order;
+    }
+    return a_size < b_size ? -1 : (a_size > b_size ? 1 : 0);
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+const FormEntry* FindForm(const FormEntry* const begin, const FormEntry* const end,
+                          const char* const arg, const std::size_t size) {
+    const FormEntry* const found = std::lower_bound(begin, end, 0,
+            [arg, size](const FormEntry& entry, int) {
+                return Compare(entry.form, entry.size, arg, size) < 0;
+            });
+    if (found == end || Compare(found->form, found->size, arg, size) != 0) {
+        return nullptr;
+    }
+    return found;
+}
+
+} // namespace internal
+} // namespace ahoy
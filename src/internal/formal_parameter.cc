@@ -6,7 +6,7 @@
 namespace ahoy {
 namespace internal {
 
-FormalParameter::FormalParameter() :  name_(), description_(), forms_(), marker_(), required_(false), flag_(false), type_(Type::INVALID) {}
+FormalParameter::FormalParameter() :  name_(), description_(), forms_(), marker_(), required_(false), flag_(false), repeated_(false), count_(false), type_(Type::INVALID), choices_(), case_insensitive_(false), env_var_(), duplicate_key_policy_(DuplicateKeyPolicy::LAST_WINS), borrow_argv_(false), path_kind_(PathKind::ANY), variadic_(false) {}
 FormalParameter::~FormalParameter() {}
 
 const std::string& FormalParameter::name() const {
@@ -69,6 +69,101 @@ void FormalParameter::flag(const bool flag) {
     flag_ = flag;
 }
 
+void FormalParameter::byte_size(const bool byte_size) {
+    if (byte_size) {
+        type_ = Type::BYTES;
+    }
+}
+
+void FormalParameter::validate_utf8(const bool validate_utf8) {
+    if (validate_utf8) {
+        type_ = Type::UTF8_STRING;
+    }
+}
+
+bool FormalParameter::repeated() const {
+    return repeated_;
+}
+
+void FormalParameter::repeated(const bool repeated) {
+    repeated_ = repeated;
+}
+
+bool FormalParameter::count() const {
+    return count_;
+}
+
+void FormalParameter::count(const bool count) {
+    count_ = count;
+    if (count) {
+        flag_ = true;
+    }
+}
+
+const ChoiceTable* FormalParameter::choices() const {
+    return choices_.get();
+}
+
+void FormalParameter::choices(const std::vector<Choice>& choices) {
+    std::vector<std::pair<std::string, long long>> entries;
+    entries.reserve(choices.size());
+    for (const Choice& choice : choices) {
+        entries.emplace_back(choice.name(), choice.value());
+    }
+    choices_ = std::make_shared<const ChoiceTable>(entries, case_insensitive_);
+}
+
+bool FormalParameter::case_insensitive() const {
+    return case_insensitive_;
+}
+
+void FormalParameter::case_insensitive(const bool case_insensitive) {
+    case_insensitive_ = case_insensitive;
+    if (choices_ && choices_->case_insensitive() != case_insensitive) {
+        choices_ = std::make_shared<const ChoiceTable>(choices_->choices(), case_insensitive);
+    }
+}
+
+const std::string& FormalParameter::env_var() const {
+    return env_var_;
+}
+
+void FormalParameter::env_var(const std::string& env_var) {
+    env_var_ = env_var;
+}
+
+DuplicateKeyPolicy FormalParameter::duplicate_key_policy() const {
+    return duplicate_key_policy_;
+}
+
+void FormalParameter::duplicate_key_policy(const DuplicateKeyPolicy duplicate_key_policy) {
+    duplicate_key_policy_ = duplicate_key_policy;
+}
+
+bool FormalParameter::borrow_argv() const {
+    return borrow_argv_;
+}
+
+void FormalParameter::borrow_argv(const bool borrow_argv) {
+    borrow_argv_ = borrow_argv;
+}
+
+PathKind FormalParameter::path_kind() const {
+    return path_kind_;
+}
+
+void FormalParameter::path_kind(const PathKind path_kind) {
+    path_kind_ = path_kind;
+}
+
+bool FormalParameter::variadic() const {
+    return variadic_;
+}
+
+void FormalParameter::variadic(const bool variadic) {
+    variadic_ = variadic;
+}
+
 bool FormalParameter::is_positional() const {
     return forms_.size() == 0;
 }
@@ -88,7 +183,17 @@ bool FormalParameter::operator ==(const FormalParameter& other) const {
             marker_ == other.marker_ &&
             required_ == other.required_ &&
             flag_ == other.flag_ &&
-            type_ == other.type_;
+            repeated_ == other.repeated_ &&
+            count_ == other.count_ &&
+            type_ == other.type_ &&
+            case_insensitive_ == other.case_insensitive_ &&
+            env_var_ == other.env_var_ &&
+            duplicate_key_policy_ == other.duplicate_key_policy_ &&
+            borrow_argv_ == other.borrow_argv_ &&
+            path_kind_ == other.path_kind_ &&
+            variadic_ == other.variadic_ &&
+            (choices_ == other.choices_ ||
+                (choices_ && other.choices_ && *choices_ == *other.choices_));
 }
 bool FormalParameter::operator !=(const FormalParameter& other) const {
     return !(*this == other);
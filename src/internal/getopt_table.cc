@@ -0,0 +1,205 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/getopt_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace {
+
+using ahoy::internal::GetoptTable;
+
+// The number of compiled tables kept by GetoptTable::Find. Programs rarely have more than a few.
+const std::size_t kCacheCapacity = 16;
+
+// A compiled table and the addresses it was compiled from
+struct CacheEntry {
+    const char* optstring;
+    const struct option* longopts;
+    std::shared_ptr<const GetoptTable> table;
+};
+
+// Orders names like std::string::compare
+int Compare(const std::string& a, const char* const b, const std::size_t b_size) {
+    const int order = std::memcmp(a.data(), b, std::min(a.size(), b_size));
+    if (order != 0) {
+        return order;
+    }
+    return a.size() < b_size ? -1 : (a.size() > b_size ? 1 : 0);
+}
+
+// If true, getopt_long treats |a| and |b| as the same option when a prefix abbreviates both
+bool SameOption(const struct option& a, const struct option& b) {
+    return a.has_arg == b.has_arg && a.flag == b.flag && a.val == b.val;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+const int GetoptTable::kNotFound;
+const int GetoptTable::kAmbiguous;
+
+GetoptTable::GetoptTable(const char* optstring, const struct option* const longopts) :
+        optstring_(optstring),
+        has_longopts_(longopts != nullptr),
+        longopts_(),
+        ordering_(Ordering::PERMUTE),
+        silent_(false),
+        shorts_(),
+        names_(),
+        options_() {
+    shorts_.fill(Argument::NONE);
+    if (optstring[0] == '-') {
+        ordering_ = Ordering::RETURN_IN_ORDER;
+        optstring++;
+    } else if (optstring[0] == '+') {
+        ordering_ = Ordering::REQUIRE_ORDER;
+        optstring++;
+    }
+    silent_ = optstring[0] == ':';
+
+    for (const char* c = optstring; *c != '\0'; c++) {
+        // getopt_long looks characters up with strchr, so the first of repeated ones wins
+        const unsigned char index = static_cast<unsigned char>(*c);
+        if (*c == ':' || *c == ';' || shorts_[index] != Argument::NONE) {
+            continue;
+        }
+        if (c[1] != ':') {
+            shorts_[index] = Argument::NO_ARGUMENT;
+        } else if (c[2] != ':') {
+            shorts_[index] = Argument::REQUIRED;
+        } else {
+            shorts_[index] = Argument::OPTIONAL;
+        }
+    }
+
+    if (longopts == nullptr) {
+        return;
+    }
+    for (const struct option* o = longopts; o->name != nullptr; o++) {
+        names_.push_back(Name{ o->name, static_cast<int>(o - longopts) });
+        longopts_.push_back(*o);
+        options_.push_back(*o);
+    }
+    std::sort(names_.begin(), names_.end(), [](const Name& a, const Name& b) {
+        const int order = a.name.compare(b.name);
+        return order < 0 || (order == 0 && a.index < b.index);
+    });
+    for (const Name& name : names_) {
+        options_[static_cast<std::size_t>(name.index)].name = name.name.c_str();
+    }
+}
+
+GetoptTable::~GetoptTable() {}
+
+std::shared_ptr<const GetoptTable> GetoptTable::Find(const char* const optstring,
+                                                     const struct option* const longopts) {
+    static std::mutex mutex;
+    static std::vector<CacheEntry> entries;
+    static std::size_t next_eviction = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (CacheEntry& entry : entries) {
+        if (entry.optstring == optstring && entry.longopts == longopts) {
+            if (!entry.table->matches(optstring, longopts)) {
+                entry.table = std::make_shared<const GetoptTable>(optstring, longopts);
+            }
+            return entry.table;
+        }
+    }
+
+    const CacheEntry entry{ optstring, longopts,
+                            std::make_shared<const GetoptTable>(optstring, longopts) };
+    if (entries.size() < kCacheCapacity) {
+        entries.push_back(entry);
+    } else {
+        entries[next_eviction] = entry;
+        next_eviction = (next_eviction + 1) % kCacheCapacity;
+    }
+    return entry.table;
+}
+
+bool GetoptTable::matches(const char* const optstring, const struct option* const longopts) const {
+    if (optstring_ != optstring || has_longopts_ != (longopts != nullptr)) {
+        return false;
+    }
+    if (longopts == nullptr) {
+        return true;
+    }
+    for (std::size_t i = 0; i < longopts_.size(); i++) {
+        const struct option& compiled = longopts_[i];
+        const struct option& option = longopts[i];
+        if (option.name != compiled.name || option.has_arg != compiled.has_arg ||
+                option.flag != compiled.flag || option.val != compiled.val) {
+            return false;
+        }
+    }
+    return longopts[longopts_.size()].name == nullptr;
+}
+
+GetoptTable::Ordering GetoptTable::ordering() const {
+    return ordering_;
+}
+
+bool GetoptTable::silent() const {
+    return silent_;
+}
+
+GetoptTable::Argument GetoptTable::short_option(const char c) const {
+    return shorts_[static_cast<unsigned char>(c)];
+}
+
+int GetoptTable::find(const char* const name, const std::size_t size,
+                      std::vector<int>* const ambiguities) const {
+    const auto begin = std::lower_bound(names_.begin(), names_.end(), 0,
+            [name, size](const Name& entry, int) {
+                return Compare(entry.name, name, size) < 0;
+            });
+    auto end = begin;
+    while (end != names_.end() && end->name.compare(0, size, name, size) == 0) {
+        end++;
+    }
+    if (begin == end) {
+        return kNotFound;
+    }
+    // Names are sorted shortest first, so an exact match leads the run of names |name| prefixes
+    if (begin->name.size() == size || end - begin == 1) {
+        return begin->index;
+    }
+
+    int found = begin->index;
+    for (auto it = begin; it != end; it++) {
+        found = std::min(found, it->index);
+    }
+    const struct option& first = options_[static_cast<std::size_t>(found)];
+    bool ambiguous = false;
+    for (auto it = begin; it != end; it++) {
+        ambiguous = ambiguous || !SameOption(first, options_[static_cast<std::size_t>(it->index)]);
+    }
+    if (!ambiguous) {
+        return found;
+    }
+
+    if (ambiguities != nullptr) {
+        ambiguities->clear();
+        for (auto it = begin; it != end; it++) {
+            if (it->index == found ||
+                    !SameOption(first, options_[static_cast<std::size_t>(it->index)])) {
+                ambiguities->push_back(it->index);
+            }
+        }
+        std::sort(ambiguities->begin(), ambiguities->end());
+    }
+    return kAmbiguous;
+}
+
+const struct option& GetoptTable::long_option(const int index) const {
+    return options_[static_cast<std::size_t>(index)];
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,1557 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/grammar.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+#include "ahoy/internal/assign.h"
+#include "ahoy/internal/edit_distance.h"
+#include "ahoy/internal/hash.h"
+
+namespace {
+
+// The state of each option of a node while it is being consumed
+enum OptionStatus : std::uint8_t {
+    AVAILABLE = 0,
+    CONSUMED,
+    // Matched at least once but may match again
+    REPEATING,
+};
+
+// Identifies an image as a grammar snapshot
+const char kMagic[8] = { 'A', 'H', 'O', 'Y', 'G', 'R', 'M', 'R' };
+
+// Reads back differently on machines of the other endianness
+const std::uint32_t kByteOrder = 0x01020304;
+
+// Every section of an image starts at a multiple of this, which suits all of their elements
+const std::size_t kSectionAlignment = 8;
+
+// Orders byte strings like std::string does
+int CompareBytes(const char* const a, const std::size_t a_size,
+                 const char* const b, const std::size_t b_size) {
+    const int order = std::memcmp(a, b, std::min(a_size, b_size));
+    if (order != 0) {
+        return order;
+    }
+    return a_size < b_size ? -1 : (a_size > b_size ? 1 : 0);
+}
+
+// Rounds |offset| up to the start of the next section
+std::size_t AlignSection(const std::size_t offset) {
+    return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+}
+
+// Returns true if |count| elements of |element_size| bytes at |offset| fit in an image of |size|
+// bytes and start at a section boundary
+bool SectionFits(const std::uint32_t offset, const std::uint32_t count,
+                 const std::size_t element_size, const std::size_t size) {
+    return offset % kSectionAlignment == 0 &&
+            offset <= size &&
+            static_cast<std::uint64_t>(count) * element_size <= size - offset;
+}
+
+// Returns true if the range [first, first + count) lies within [0, total)
+bool RangeFits(const std::uint32_t first, const std::uint32_t count, const std::uint32_t total) {
+    return static_cast<std::uint64_t>(first) + count <= total;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+const std::uint32_t Grammar::kSnapshotVersion;
+
+struct Grammar::Sections {
+    Sections() :
+            nodes(), help(), forms(), choices(), entries(), words(), pool(), interned() {}
+
+    std::vector<Node> nodes;
+    std::vector<Help> help;
+    std::vector<StringRef> forms;
+    std::vector<PackedChoices> choices;
+    std::vector<ChoiceTable::Entry> entries;
+    std::vector<std::uint32_t> words;
+    std::string pool;
+    // Where each string already in |pool| starts
+    std::unordered_map<std::string, StringRef> interned;
+};
+
+Grammar::Grammar() :
+        image_(),
+        header_(nullptr),
+        nodes_(nullptr),
+        help_(nullptr),
+        forms_(nullptr),
+        choices_(nullptr),
+        entries_(nullptr),
+        words_(nullptr),
+        pool_(nullptr),
+        storage_(),
+        environment_(),
+        flat_(false),
+        flat_forms_(),
+        flat_unindexed_(),
+        paths_(),
+        order_(),
+        sorted_() {}
+
+Grammar::Grammar(const Parameter& root) : Grammar() {
+    build(root.fp_, root.storage_, root.current_options_, root.next_options_);
+}
+
+Grammar::Grammar(const std::vector<Parameter>& options, const std::vector<Parameter>& nexts) :
+        Grammar() {
+    FormalParameter root;
+    root.type(Type::STRING);
+    build(root, nullptr, options, nexts);
+}
+
+Grammar::~Grammar() {}
+
+size_t Grammar::consume(const std::vector<std::string>& args,
+                        const size_t start,
+                        void* const root_storage,
+                        ParseState* const state) const {
+    if (size() == 0) {
+        return -1;
+    }
+    // Dry runs for completion note every option tried, so they need the generic engine
+    const bool dry_run = state != nullptr && state->probes() != nullptr;
+    const size_t consumed = flat_ && !dry_run ?
+            consume_flat(args, start, root_storage, state) :
+            consume(0, args, start, root_storage, state);
+    if (consumed < 0 || dry_run) {
+        return consumed;
+    }
+    return assign_environment(root_storage, state) ? consumed : -1;
+}
+
+std::vector<const char*> Grammar::environment(const char* const* const variables) const {
+    std::vector<const char*> values;
+    if (environment_.empty() || variables == nullptr) {
+        return values;
+    }
+
+    values.assign(size(), nullptr);
+    for (const char* const* variable = variables; *variable != nullptr; variable++) {
+        const char* const separator = std::strchr(*variable, '=');
+        if (separator == nullptr) {
+            continue;
+        }
+
+        const std::size_t length = static_cast<std::size_t>(separator - *variable);
+        const std::uint64_t hash = HashBytes(*variable, length);
+        auto entry = std::lower_bound(environment_.begin(), environment_.end(), hash,
+                                      [](const EnvironmentEntry& entry, const std::uint64_t hash) {
+                                          return entry.hash < hash;
+                                      });
+        for (; entry != environment_.end() && entry->hash == hash; ++entry) {
+            const StringRef& name = help_[entry->node].env_var;
+            // The first definition of a variable wins, as with getenv
+            if (values[entry->node] == nullptr && name.size == length &&
+                    std::memcmp(pool_ + name.offset, *variable, length) == 0) {
+                values[entry->node] = separator + 1;
+            }
+        }
+    }
+    return values;
+}
+
+std::vector<Completion> Grammar::complete(const std::vector<std::string>& args,
+                                          const std::size_t cursor,
+                                          ParseState* const state) const {
+    std::vector<Completion> completions;
+    if (size() == 0) {
+        return completions;
+    }
+
+    const std::size_t position = std::min(cursor, args.size());
+    const std::vector<std::string> before(args.begin(), args.begin() + position);
+    const std::string word = position < args.size() ? args[position] : std::string();
+
+    std::vector<std::uint8_t> probes(size(), 0);
+    state->probe(position, &probes);
+    consume(0, before, 0, nullptr, state);
+    state->probe(0, nullptr);
+
+    std::unordered_set<std::string> seen;
+    for (std::uint32_t i = 0; i < size(); i++) {
+        if (probes[i] & kProbedValue) {
+            complete_value(i, std::string(), word, &seen, &completions);
+        }
+        if (!(probes[i] & kProbedForm)) {
+            continue;
+        }
+
+        const Node& node = nodes_[i];
+        if (node.form_count == 0) {
+            complete_value(i, std::string(), word, &seen, &completions);
+            continue;
+        }
+        for (std::uint32_t f = node.first_form; f < node.first_form + node.form_count; f++) {
+            const StringRef& form = forms_[f];
+            if (form.size >= word.size() &&
+                    std::memcmp(word.data(), pool_ + form.offset, word.size()) == 0) {
+                add_completion(CompletionKind::FORM, str(form), i, &seen, &completions);
+            } else if (!(node.attributes & kFlagAttribute) && prefixes(form, word)) {
+                complete_value(i, word.substr(0, form.size + 1), word, &seen, &completions);
+            }
+        }
+    }
+    return completions;
+}
+
+std::vector<std::string> Grammar::suggest(const std::string& arg, const std::size_t limit) const {
+    std::vector<std::string> suggestions;
+    if (size() == 0 || limit == 0) {
+        return suggestions;
+    }
+
+    std::size_t length = arg.size();
+    const std::size_t equals = arg.find('=');
+    if (!arg.empty() && arg[0] == '-' && equals != std::string::npos) {
+        length = equals;
+    }
+    const std::string token = arg.substr(0, length);
+    // Allows about one typo per three characters, so short tokens are not matched to everything
+    std::size_t max_distance = std::max<std::size_t>(2, token.size() / 3);
+
+    const EditDistance distance(token);
+    // Orders by distance and then by form
+    const auto closer = [this](const std::pair<std::size_t, std::uint32_t>& a,
+                               const std::pair<std::size_t, std::uint32_t>& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        const StringRef& form_a = forms_[a.second];
+        const StringRef& form_b = forms_[b.second];
+        const int order = std::memcmp(pool_ + form_a.offset, pool_ + form_b.offset,
+                                      std::min(form_a.size, form_b.size));
+        return order < 0 || (order == 0 && form_a.size < form_b.size);
+    };
+
+    // The closest |limit| forms so far, as pairs of a distance and the index of a form, kept sorted
+    std::vector<std::pair<std::size_t, std::uint32_t>> nearest;
+    nearest.reserve(limit + 1);
+    const auto consider = [&](const std::pair<std::size_t, std::uint32_t>& candidate) {
+        if (candidate.first == 0 || candidate.first > max_distance ||
+                (nearest.size() == limit && !closer(candidate, nearest.back()))) {
+            return;
+        }
+        const auto position = std::upper_bound(nearest.begin(), nearest.end(), candidate, closer);
+        // Forms shared by several parameters are equal to their neighbours once sorted
+        if (position != nearest.begin() && !closer(*(position - 1), candidate)) {
+            return;
+        }
+        nearest.insert(position, candidate);
+        if (nearest.size() > limit) {
+            nearest.pop_back();
+        }
+        if (nearest.size() == limit) {
+            // Nothing further away can make the cut any more
+            max_distance = nearest.back().first;
+        }
+    };
+
+    // Forms that pass the cheap checks are measured in batches
+    const char* texts[EditDistance::kLanes];
+    std::size_t sizes[EditDistance::kLanes];
+    std::uint32_t indices[EditDistance::kLanes];
+    std::size_t distances[EditDistance::kLanes];
+    std::size_t batched = 0;
+    for (std::uint32_t f = 0; f <= header_->form_count; f++) {
+        if (f < header_->form_count) {
+            const StringRef& form = forms_[f];
+            const char* const text = pool_ + form.offset;
+            // The difference in length is a lower bound on the distance too
+            const std::size_t difference =
+                    form.size > token.size() ? form.size - token.size() : token.size() - form.size;
+            if (difference > max_distance || distance.lower_bound(text, form.size) > max_distance) {
+                continue;
+            }
+            texts[batched] = text;
+            sizes[batched] = form.size;
+            indices[batched] = f;
+            batched++;
+        }
+        if (batched == EditDistance::kLanes || (f == header_->form_count && batched > 0)) {
+            distance.distances(texts, sizes, batched, distances);
+            for (std::size_t i = 0; i < batched; i++) {
+                consider(std::make_pair(distances[i], indices[i]));
+            }
+            batched = 0;
+        }
+    }
+
+    for (const std::pair<std::size_t, std::uint32_t>& candidate : nearest) {
+        suggestions.push_back(str(forms_[candidate.second]));
+    }
+    return suggestions;
+}
+
+void Grammar::reserve(const std::vector<std::string>& args, void* const root_storage) const {
+    for (std::size_t i = 0; i < size(); i++) {
+        const Node& node = nodes_[i];
+        void* const storage = i == 0 ? root_storage : storage_[i];
+        if (!(node.attributes & kRepeatedAttribute) || storage == nullptr) {
+            continue;
+        }
+
+        const Type type = static_cast<Type>(node.type);
+        std::size_t matches = 0;
+        if (node.form_count == 0) {
+            matches = args.size();
+        } else {
+            for (const std::string& arg : args) {
+                const std::uint32_t forms_end = node.first_form + node.form_count;
+                for (std::uint32_t f = node.first_form; f < forms_end; f++) {
+                    if (equals(forms_[f], arg) || (type == Type::PROPERTIES ?
+                            attaches(forms_[f], arg) : prefixes(forms_[f], arg))) {
+                        matches++;
+                        break;
+                    }
+                }
+            }
+        }
+        if (type == Type::PROPERTIES) {
+            Properties* const properties = static_cast<Properties*>(storage);
+            properties->reserve(properties->size() + matches);
+        } else {
+            ReserveAppend(storage, type, matches);
+        }
+    }
+}
+
+std::string Grammar::snapshot() const {
+    if (header_ == nullptr) {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(header_), header_->size);
+}
+
+bool Grammar::load(const void* const data, const std::size_t size) {
+    Grammar loaded;
+    if (!loaded.map(static_cast<const char*>(data), size)) {
+        return false;
+    }
+    loaded.storage_.assign(loaded.size(), nullptr);
+    *this = std::move(loaded);
+    return true;
+}
+
+bool Grammar::replay(const StoreLog& log, void* const root_storage,
+                     ParseState* const state) const {
+    for (const StoreLog::Store& store : log.stores()) {
+        const Node& node = nodes_[store.node];
+        void* const storage = store.node == 0 ? root_storage : storage_[store.node];
+        const Type type = static_cast<Type>(node.type);
+        bool stored = true;
+        switch (store.kind) {
+            case StoreLog::Kind::VALUE:
+                if (SizeOf(type) > 0) {
+                    std::memcpy(storage, store.data.data(), store.data.size());
+                } else {
+                    *static_cast<std::string*>(storage) = store.data;
+                }
+                break;
+            case StoreLog::Kind::APPEND:
+                stored = AssignAppend(storage, type, store.data);
+                break;
+            case StoreLog::Kind::COUNT:
+                stored = AssignCount(storage, type, store.occurrences);
+                break;
+            case StoreLog::Kind::PROPERTY:
+                stored = assign_property(node, storage, store.data, store.offset,
+                                         store.position == StoreLog::kNoPosition ?
+                                             -1 : static_cast<size_t>(store.position),
+                                         state);
+                break;
+        }
+        if (!stored) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Grammar::has_paths() const {
+    return !paths_.empty();
+}
+
+std::vector<PathRequest> Grammar::paths(const ParseState& state) const {
+    std::vector<PathRequest> requests;
+    for (const std::uint32_t i : paths_) {
+        const Node& node = nodes_[i];
+        void* const storage = storage_[i];
+        if (storage == nullptr || !state.matched(i)) {
+            continue;
+        }
+
+        const PathKind kind = static_cast<PathKind>(node.path);
+        if (node.attributes & kRepeatedAttribute) {
+            for (const std::string& path : *static_cast<std::vector<std::string>*>(storage)) {
+                requests.push_back(PathRequest{ i, kind, path });
+            }
+        } else {
+            requests.push_back(PathRequest{ i, kind, *static_cast<std::string*>(storage) });
+        }
+    }
+    return requests;
+}
+
+std::uint64_t Grammar::fingerprint() const {
+    return header_ == nullptr ? 0 : header_->fingerprint;
+}
+
+std::size_t Grammar::size() const {
+    return header_ == nullptr ? 0 : header_->node_count;
+}
+
+std::string Grammar::name(const std::size_t node) const {
+    return str(help_[node].name);
+}
+
+std::string Grammar::description(const std::size_t node) const {
+    return str(help_[node].description);
+}
+
+std::string Grammar::marker(const std::size_t node) const {
+    return str(help_[node].marker);
+}
+
+std::size_t Grammar::memory_footprint() const {
+    std::size_t footprint = sizeof(*this) + storage_.capacity() * sizeof(void*) +
+            environment_.capacity() * sizeof(EnvironmentEntry) +
+            flat_forms_.capacity() * sizeof(FlatForm) +
+            flat_unindexed_.capacity() * sizeof(std::uint32_t) +
+            paths_.capacity() * sizeof(std::uint32_t) +
+            order_.capacity() * sizeof(std::uint32_t) + sorted_.capacity() / 8;
+    if (image_) {
+        footprint += image_->capacity() * sizeof(std::uint64_t);
+    }
+    return footprint;
+}
+
+void Grammar::build(const FormalParameter& root,
+                    void* const root_storage,
+                    const std::vector<Parameter>& options,
+                    const std::vector<Parameter>& nexts) {
+    // Size everything up front so building allocates each array once
+    std::size_t node_count = 1;
+    std::size_t form_count = root.forms().size();
+    for (const Parameter& parameter : options) {
+        count(parameter, &node_count, &form_count);
+    }
+    for (const Parameter& parameter : nexts) {
+        count(parameter, &node_count, &form_count);
+    }
+
+    Sections sections;
+    sections.nodes.reserve(node_count);
+    sections.help.reserve(node_count);
+    sections.forms.reserve(form_count);
+    storage_.reserve(node_count);
+
+    // Doubles as the breadth-first queue. Each parameter's children are appended as it is visited,
+    // which keeps them contiguous.
+    std::vector<const Parameter*> parameters;
+    parameters.reserve(node_count - 1);
+    add(root, options, nexts, &parameters, &sections);
+    storage_.push_back(root_storage);
+    for (std::size_t i = 0; i < parameters.size(); i++) {
+        const Parameter& parameter = *parameters[i];
+        add(parameter.fp_, parameter.current_options_, parameter.next_options_, &parameters,
+            &sections);
+        storage_.push_back(parameter.storage_);
+    }
+
+    pack(sections);
+}
+
+void Grammar::count(const Parameter& parameter, std::size_t* nodes, std::size_t* forms) {
+    *nodes += 1;
+    *forms += parameter.fp_.forms().size();
+    for (const Parameter& option : parameter.current_options_) {
+        count(option, nodes, forms);
+    }
+    for (const Parameter& next : parameter.next_options_) {
+        count(next, nodes, forms);
+    }
+}
+
+void Grammar::add(const FormalParameter& fp,
+                  const std::vector<Parameter>& options,
+                  const std::vector<Parameter>& nexts,
+                  std::vector<const Parameter*>* parameters,
+                  Sections* sections) {
+    Node node;
+    node.first_form = static_cast<std::uint32_t>(sections->forms.size());
+    node.form_count = static_cast<std::uint32_t>(fp.forms().size());
+    // The root is not in |parameters|, so every other node's index is one past its position there
+    node.first_child = static_cast<std::uint32_t>(parameters->size() + 1);
+    node.option_count = static_cast<std::uint32_t>(options.size());
+    node.next_count = static_cast<std::uint32_t>(nexts.size());
+    node.choices = 0;
+    node.type = static_cast<std::uint8_t>(fp.type());
+    node.attributes = 0;
+    node.path = static_cast<std::uint8_t>(fp.path_kind());
+    node.variadic = fp.variadic() && fp.repeated() && fp.is_positional() ? 1 : 0;
+    if (fp.required()) {
+        node.attributes |= kRequiredAttribute;
+    }
+    if (fp.flag()) {
+        node.attributes |= kFlagAttribute;
+    }
+    if (fp.repeated()) {
+        node.attributes |= kRepeatedAttribute;
+    }
+    if (fp.count()) {
+        node.attributes |= kCountAttribute;
+    }
+    if (fp.type() == Type::PROPERTIES) {
+        if (fp.duplicate_key_policy() == DuplicateKeyPolicy::FIRST_WINS) {
+            node.attributes |= kFirstWinsAttribute;
+        } else if (fp.duplicate_key_policy() == DuplicateKeyPolicy::REJECT) {
+            node.attributes |= kRejectDuplicatesAttribute;
+        }
+        if (fp.borrow_argv()) {
+            node.attributes |= kBorrowAttribute;
+        }
+    }
+
+    for (const std::string& form : fp.forms()) {
+        sections->forms.push_back(intern(form, sections));
+    }
+
+    if (fp.choices() != nullptr) {
+        // Copied so the grammar stays valid after the parameters it was built from are gone
+        const ChoiceTable::View view = fp.choices()->view();
+        std::size_t names_size = 0;
+        for (std::uint32_t i = 0; i < view.entry_count; i++) {
+            names_size = std::max<std::size_t>(names_size,
+                                               view.entries[i].offset + view.entries[i].size);
+        }
+
+        PackedChoices choices;
+        choices.names = static_cast<std::uint32_t>(sections->pool.size());
+        choices.first_entry = static_cast<std::uint32_t>(sections->entries.size());
+        choices.entry_count = view.entry_count;
+        choices.first_displacement = static_cast<std::uint32_t>(sections->words.size());
+        choices.displacement_count = view.displacement_count;
+        choices.first_slot = choices.first_displacement + view.displacement_count;
+        choices.slot_count = view.slot_count;
+        choices.case_insensitive = view.case_insensitive ? 1 : 0;
+
+        sections->pool.append(view.names, names_size);
+        sections->entries.insert(sections->entries.end(),
+                                 view.entries, view.entries + view.entry_count);
+        sections->words.insert(sections->words.end(),
+                               view.displacements, view.displacements + view.displacement_count);
+        sections->words.insert(sections->words.end(), view.slots, view.slots + view.slot_count);
+        sections->choices.push_back(choices);
+        node.choices = static_cast<std::uint32_t>(sections->choices.size());
+    }
+
+    for (const Parameter& option : options) {
+        parameters->push_back(&option);
+    }
+    bool found_required = false;
+    for (const Parameter& next : nexts) {
+        if (next.fp_.required()) {
+            if (found_required) {
+                node.attributes |= kInvalidAttribute;
+            }
+            found_required = true;
+        }
+        parameters->push_back(&next);
+    }
+
+    sections->nodes.push_back(node);
+    sections->help.push_back(Help{ intern(fp.name(), sections),
+                                   intern(fp.description(), sections),
+                                   intern(fp.marker(), sections),
+                                   intern(fp.env_var(), sections) });
+}
+
+Grammar::StringRef Grammar::intern(const std::string& value, Sections* sections) {
+    if (value.empty()) {
+        return StringRef{ 0, 0 };
+    }
+
+    const auto it = sections->interned.find(value);
+    if (it != sections->interned.end()) {
+        return it->second;
+    }
+
+    const StringRef ref{ static_cast<std::uint32_t>(sections->pool.size()),
+                         static_cast<std::uint32_t>(value.size()) };
+    sections->pool.append(value);
+    sections->interned.emplace(value, ref);
+    return ref;
+}
+
+void Grammar::pack(const Sections& sections) {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byte_order = kByteOrder;
+    header.version = kSnapshotVersion;
+    header.node_count = static_cast<std::uint32_t>(sections.nodes.size());
+    header.form_count = static_cast<std::uint32_t>(sections.forms.size());
+    header.choice_count = static_cast<std::uint32_t>(sections.choices.size());
+    header.entry_count = static_cast<std::uint32_t>(sections.entries.size());
+    header.word_count = static_cast<std::uint32_t>(sections.words.size());
+    header.pool_size = static_cast<std::uint32_t>(sections.pool.size());
+
+    std::size_t size = AlignSection(sizeof(Header));
+    const auto place = [&size](std::uint32_t* section, const std::size_t bytes) {
+        *section = static_cast<std::uint32_t>(size);
+        size = AlignSection(size + bytes);
+    };
+    place(&header.nodes, sections.nodes.size() * sizeof(Node));
+    place(&header.help, sections.help.size() * sizeof(Help));
+    place(&header.forms, sections.forms.size() * sizeof(StringRef));
+    place(&header.choices, sections.choices.size() * sizeof(PackedChoices));
+    place(&header.entries, sections.entries.size() * sizeof(ChoiceTable::Entry));
+    place(&header.words, sections.words.size() * sizeof(std::uint32_t));
+    place(&header.pool, sections.pool.size());
+    header.size = static_cast<std::uint32_t>(size);
+
+    // Zero filled so the padding between sections is the same in every image
+    std::shared_ptr<std::vector<std::uint64_t>> image =
+            std::make_shared<std::vector<std::uint64_t>>(size / sizeof(std::uint64_t), 0);
+    char* const data = reinterpret_cast<char*>(image->data());
+    const auto copy = [data](const std::uint32_t section, const void* source,
+                             const std::size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(data + section, source, bytes);
+        }
+    };
+    copy(header.nodes, sections.nodes.data(), sections.nodes.size() * sizeof(Node));
+    copy(header.help, sections.help.data(), sections.help.size() * sizeof(Help));
+    copy(header.forms, sections.forms.data(), sections.forms.size() * sizeof(StringRef));
+    copy(header.choices, sections.choices.data(),
+         sections.choices.size() * sizeof(PackedChoices));
+    copy(header.entries, sections.entries.data(),
+         sections.entries.size() * sizeof(ChoiceTable::Entry));
+    copy(header.words, sections.words.data(), sections.words.size() * sizeof(std::uint32_t));
+    copy(header.pool, sections.pool.data(), sections.pool.size());
+    std::memcpy(data, &header, sizeof(header));
+
+    header.fingerprint = Fingerprint(data, size);
+    std::memcpy(data, &header, sizeof(header));
+
+    image_ = image;
+    map(data, size);
+}
+
+bool Grammar::map(const char* const data, const std::size_t size) {
+    if (data == nullptr || size < sizeof(Header) ||
+            reinterpret_cast<std::uintptr_t>(data) % kSectionAlignment != 0) {
+        return false;
+    }
+
+    const Header* const header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+            header->byte_order != kByteOrder ||
+            header->version != kSnapshotVersion ||
+            header->size != size ||
+            header->fingerprint != Fingerprint(data, size) ||
+            header->node_count == 0 ||
+            !SectionFits(header->nodes, header->node_count, sizeof(Node), size) ||
+            !SectionFits(header->help, header->node_count, sizeof(Help), size) ||
+            !SectionFits(header->forms, header->form_count, sizeof(StringRef), size) ||
+            !SectionFits(header->choices, header->choice_count, sizeof(PackedChoices), size) ||
+            !SectionFits(header->entries, header->entry_count, sizeof(ChoiceTable::Entry), size) ||
+            !SectionFits(header->words, header->word_count, sizeof(std::uint32_t), size) ||
+            !SectionFits(header->pool, header->pool_size, 1, size)) {
+        return false;
+    }
+
+    const Node* const nodes = reinterpret_cast<const Node*>(data + header->nodes);
+    const Help* const help = reinterpret_cast<const Help*>(data + header->help);
+    const StringRef* const forms = reinterpret_cast<const StringRef*>(data + header->forms);
+    const PackedChoices* const choices =
+            reinterpret_cast<const PackedChoices*>(data + header->choices);
+    const ChoiceTable::Entry* const entries =
+            reinterpret_cast<const ChoiceTable::Entry*>(data + header->entries);
+    const std::uint32_t* const words = reinterpret_cast<const std::uint32_t*>(data + header->words);
+    const char* const pool = data + header->pool;
+
+    // Every index must stay within its section, and children must come after their parents so
+    // consuming always terminates. Only repeated positionals may be variadic, as their values are
+    // appended to a std::vector in bulk.
+    for (std::uint32_t i = 0; i < header->node_count; i++) {
+        const Node& node = nodes[i];
+        const std::uint32_t children = node.option_count + node.next_count;
+        if (!RangeFits(node.first_form, node.form_count, header->form_count) ||
+                node.variadic > 1 ||
+                (node.variadic && (!(node.attributes & kRepeatedAttribute) ||
+                    node.form_count > 0)) ||
+                node.choices > header->choice_count ||
+                node.path > static_cast<std::uint8_t>(PathKind::CREATABLE) ||
+                (node.path != 0 && static_cast<Type>(node.type) != Type::STRING &&
+                    static_cast<Type>(node.type) != Type::UTF8_STRING) ||
+                children < node.option_count ||
+                (children > 0 && (node.first_child <= i ||
+                    !RangeFits(node.first_child, children, header->node_count))) ||
+                !RangeFits(help[i].name.offset, help[i].name.size, header->pool_size) ||
+                !RangeFits(help[i].description.offset, help[i].description.size,
+                           header->pool_size) ||
+                !RangeFits(help[i].marker.offset, help[i].marker.size, header->pool_size) ||
+                !RangeFits(help[i].env_var.offset, help[i].env_var.size, header->pool_size)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < header->form_count; i++) {
+        if (!RangeFits(forms[i].offset, forms[i].size, header->pool_size)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < header->choice_count; i++) {
+        const PackedChoices& packed = choices[i];
+        if (packed.names > header->pool_size ||
+                !RangeFits(packed.first_entry, packed.entry_count, header->entry_count) ||
+                !RangeFits(packed.first_displacement, packed.displacement_count,
+                           header->word_count) ||
+                !RangeFits(packed.first_slot, packed.slot_count, header->word_count)) {
+            return false;
+        }
+        const ChoiceTable::View view{ pool + packed.names,
+                                      entries + packed.first_entry,
+                                      packed.entry_count,
+                                      words + packed.first_displacement,
+                                      packed.displacement_count,
+                                      words + packed.first_slot,
+                                      packed.slot_count,
+                                      packed.case_insensitive != 0 };
+        if (!view.valid(header->pool_size - packed.names)) {
+            return false;
+        }
+    }
+
+    header_ = header;
+    nodes_ = nodes;
+    help_ = help;
+    forms_ = forms;
+    choices_ = choices;
+    entries_ = entries;
+    words_ = words;
+    pool_ = pool;
+    index();
+    return true;
+}
+
+void Grammar::index() {
+    environment_.clear();
+    flat_forms_.clear();
+    flat_unindexed_.clear();
+    paths_.clear();
+    order_.clear();
+    sorted_.clear();
+
+    for (std::uint32_t i = 0; i < size(); i++) {
+        const StringRef& name = help_[i].env_var;
+        if (name.size > 0) {
+            const std::uint64_t hash = HashBytes(pool_ + name.offset, name.size);
+            environment_.push_back(EnvironmentEntry{ hash, i, 0 });
+        }
+        // The root holds the program name, which is not checked
+        if (i > 0 && static_cast<PathKind>(nodes_[i].path) != PathKind::ANY) {
+            paths_.push_back(i);
+        }
+    }
+    if (!environment_.empty()) {
+        std::vector<std::uint32_t> parents(size(), 0);
+        for (std::uint32_t i = 0; i < size(); i++) {
+            const Node& node = nodes_[i];
+            const std::uint32_t children = node.option_count + node.next_count;
+            for (std::uint32_t child = node.first_child; child < node.first_child + children;
+                    child++) {
+                parents[child] = i;
+            }
+        }
+        for (EnvironmentEntry& entry : environment_) {
+            entry.parent = parents[entry.node];
+        }
+    }
+    std::sort(environment_.begin(), environment_.end(),
+              [](const EnvironmentEntry& a, const EnvironmentEntry& b) {
+                  return a.hash < b.hash || (a.hash == b.hash && a.node < b.node);
+              });
+
+    const Node& root = nodes_[0];
+    flat_ = root.option_count > 0 && root.next_count == 0 && !(root.attributes & kInvalidAttribute);
+    for (std::uint32_t i = 0; i < root.option_count && flat_; i++) {
+        const Node& option = nodes_[root.first_child + i];
+        flat_ = option.option_count == 0 && option.next_count == 0;
+    }
+    if (!flat_) {
+        return;
+    }
+
+    std::size_t form_count = 0;
+    std::size_t unindexed_count = 0;
+    for (std::uint32_t i = 0; i < root.option_count; i++) {
+        const Node& option = nodes_[root.first_child + i];
+        form_count += option.form_count;
+        unindexed_count += option.form_count == 0 || (option.attributes & kCountAttribute) ||
+                static_cast<Type>(option.type) == Type::PROPERTIES;
+    }
+    flat_forms_.reserve(form_count);
+    flat_unindexed_.reserve(unindexed_count);
+    for (std::uint32_t i = 0; i < root.option_count; i++) {
+        const Node& option = nodes_[root.first_child + i];
+        for (std::uint32_t f = option.first_form; f < option.first_form + option.form_count; f++) {
+            flat_forms_.push_back(FlatForm{ forms_[f], i });
+        }
+        if (option.form_count == 0 || (option.attributes & kCountAttribute) ||
+                static_cast<Type>(option.type) == Type::PROPERTIES) {
+            flat_unindexed_.push_back(i);
+        }
+    }
+
+    const char* const pool = pool_;
+    std::sort(flat_forms_.begin(), flat_forms_.end(),
+              [pool](const FlatForm& a, const FlatForm& b) {
+                  const int order = CompareBytes(pool + a.form.offset, a.form.size,
+                                                 pool + b.form.offset, b.form.size);
+                  return order < 0 || (order == 0 && a.option < b.option);
+              });
+}
+
+void Grammar::reorder(const std::vector<unsigned long long>& hits) {
+    const auto hits_of = [&hits](const std::uint32_t node) {
+        return node < hits.size() ? hits[node] : 0;
+    };
+    if (order_.empty()) {
+        order_.resize(size());
+        std::iota(order_.begin(), order_.end(), 0);
+        sorted_.assign(size(), false);
+    }
+    const auto sort_run = [this, &hits_of](const std::uint32_t first, const std::uint32_t count,
+                                           const bool nexts) {
+        if (count < 2 || !reorderable(first, count, nexts)) {
+            return false;
+        }
+        const auto begin = order_.begin() + first;
+        std::iota(begin, begin + count, first);
+        std::stable_sort(begin, begin + count,
+                         [&hits_of](const std::uint32_t a, const std::uint32_t b) {
+                             return hits_of(a) > hits_of(b);
+                         });
+        return true;
+    };
+    for (std::uint32_t i = 0; i < size(); i++) {
+        const Node& node = nodes_[i];
+        sorted_[i] = sort_run(node.first_child, node.option_count, false);
+        sort_run(node.first_child + node.option_count, node.next_count, true);
+    }
+}
+
+std::uint64_t Grammar::Fingerprint(const char* const data, const std::size_t size) {
+    const std::size_t start = offsetof(Header, fingerprint) + sizeof(std::uint64_t);
+    return HashBytes(data + start, size - start);
+}
+
+bool Grammar::bind(const std::string& name, void* const storage,
+                   bool (*matches)(const Type type, const bool repeated)) {
+    bool bound = false;
+    for (std::size_t i = 1; i < size(); i++) {
+        if (str(help_[i].name) != name) {
+            continue;
+        }
+        if (!matches(static_cast<Type>(nodes_[i].type),
+                     (nodes_[i].attributes & kRepeatedAttribute) != 0)) {
+            return false;
+        }
+        storage_[i] = storage;
+        bound = true;
+    }
+    return bound;
+}
+
+std::string Grammar::str(const StringRef& ref) const {
+    return std::string(pool_ + ref.offset, ref.size);
+}
+
+ChoiceTable::View Grammar::choices(const Node& node) const {
+    const PackedChoices& packed = choices_[node.choices - 1];
+    return ChoiceTable::View{ pool_ + packed.names,
+                              entries_ + packed.first_entry,
+                              packed.entry_count,
+                              words_ + packed.first_displacement,
+                              packed.displacement_count,
+                              words_ + packed.first_slot,
+                              packed.slot_count,
+                              packed.case_insensitive != 0 };
+}
+
+bool Grammar::equals(const StringRef& form, const std::string& arg) const {
+    return arg.size() == form.size &&
+            std::memcmp(arg.data(), pool_ + form.offset, form.size) == 0;
+}
+
+bool Grammar::prefixes(const StringRef& form, const std::string& arg) const {
+    return arg.size() > form.size &&
+            arg[form.size] == '=' &&
+            std::memcmp(arg.data(), pool_ + form.offset, form.size) == 0;
+}
+
+bool Grammar::attaches(const StringRef& form, const std::string& arg) const {
+    return arg.size() > form.size && std::memcmp(arg.data(), pool_ + form.offset, form.size) == 0;
+}
+
+bool Grammar::reorderable(const std::uint32_t first, const std::uint32_t count,
+                          const bool nexts) const {
+    std::vector<std::string> forms;
+    for (std::uint32_t i = first; i < first + count; i++) {
+        const Node& node = nodes_[i];
+        // Parameters with children can consume arguments through them even when their own forms
+        // do not match, and count flags and Properties also match arguments that merely start
+        // with a form
+        if (node.form_count == 0 || node.option_count > 0 || node.next_count > 0 ||
+                (node.attributes & kCountAttribute) || node.variadic ||
+                (nexts && (node.attributes & kRequiredAttribute)) ||
+                static_cast<Type>(node.type) == Type::PROPERTIES) {
+            return false;
+        }
+        for (std::uint32_t f = node.first_form; f < node.first_form + node.form_count; f++) {
+            forms.push_back(str(forms_[f]));
+            if (forms.back().find('=') != std::string::npos) {
+                return false;
+            }
+        }
+    }
+    std::sort(forms.begin(), forms.end());
+    return std::adjacent_find(forms.begin(), forms.end()) == forms.end();
+}
+
+std::uint32_t Grammar::child(const Node& node, const std::uint32_t position,
+                             const ParseState* const state) const {
+    const std::uint32_t index = node.first_child + position;
+    if (order_.empty() || (state != nullptr && state->probes() != nullptr)) {
+        return index;
+    }
+    return order_[index];
+}
+
+bool Grammar::missing(const std::uint32_t node, const ParseState* const state) const {
+    return (nodes_[node].attributes & kRequiredAttribute) &&
+            (state == nullptr || state->variable(node) == nullptr);
+}
+
+bool Grammar::assign_environment(void* const root_storage, ParseState* const state) const {
+    if (state == nullptr) {
+        return true;
+    }
+    // Decided before any value is stored, as a parent only counts as taken if it matched an
+    // argument rather than a variable of its own
+    std::vector<std::uint32_t> taken;
+    for (const EnvironmentEntry& entry : environment_) {
+        if (state->variable(entry.node) != nullptr &&
+                (entry.node == 0 || state->matched(entry.parent))) {
+            taken.push_back(entry.node);
+        }
+    }
+    for (const std::uint32_t node : taken) {
+        const char* const value = state->variable(node);
+        if (!state->matched(node) &&
+                !assign(nodes_[node], node == 0 ? root_storage : storage_[node], value, state)) {
+            return false;
+        }
+        state->match(node);
+    }
+    return true;
+}
+
+size_t Grammar::match(const std::uint32_t index,
+                      const std::vector<std::string>& args,
+                      const size_t start,
+                      void* const storage,
+                      ParseState* const state) const {
+    if (state != nullptr && !state->step()) {
+        return -1;
+    }
+
+    const Node& node = nodes_[index];
+    if (node.attributes & kInvalidAttribute) {
+        return -1;
+    }
+
+    std::vector<std::uint8_t>* const probes = state != nullptr ? state->probes() : nullptr;
+    if (probes != nullptr && static_cast<std::size_t>(start) == state->probe_position()) {
+        (*probes)[index] |= kProbedForm;
+    }
+
+    const size_t args_available = args.size() - start;
+
+    if (args_available <= 0) {
+        return -1;
+    }
+
+    size_t consumed = 0;
+
+    // This whole section is where this node consumes the arguments passed in
+    if (node.form_count == 0) {
+        if (node.variadic) {
+            if (!assign_remaining(node, storage, args, start, state)) {
+                return -1;
+            }
+            consumed = args_available;
+        } else if (node.attributes & kFlagAttribute) {
+            if (!assign_flag(node, storage, 1, state)) {
+                return -1;
+            }
+            consumed = 1;
+        } else {
+            if (!assign(node, storage, args[start], state)) {
+                return -1;
+            }
+            consumed = 1;
+        }
+    } else {
+        const std::string& arg = args[start];
+        const std::uint32_t forms_end = node.first_form + node.form_count;
+
+        bool is_form = false;
+        for (std::uint32_t f = node.first_form; f < forms_end && !is_form; f++) {
+            is_form = equals(forms_[f], arg);
+        }
+
+        if (is_form) {
+            if (node.attributes & kFlagAttribute) {
+                if (!assign_flag(node, storage, 1, state)) {
+                    return -1;
+                }
+                consumed = 1;
+            } else if (args_available >= 2) {
+                const bool assigned = static_cast<Type>(node.type) == Type::PROPERTIES ?
+                        assign_property(node, storage, args[start + 1], 0, start + 1, state) :
+                        assign(node, storage, args[start + 1], state);
+                if (!assigned) {
+                    return -1;
+                }
+                consumed = 2;
+            } else if (probes != nullptr &&
+                    static_cast<std::size_t>(start + 1) == state->probe_position()) {
+                (*probes)[index] |= kProbedValue;
+            }
+        } else if (static_cast<Type>(node.type) == Type::PROPERTIES) {
+            for (std::uint32_t f = node.first_form; f < forms_end; f++) {
+                if (attaches(forms_[f], arg)) {
+                    // The key follows the form directly or after an '='
+                    const std::size_t offset = forms_[f].size + (arg[forms_[f].size] == '=');
+                    if (!assign_property(node, storage, arg, offset, start, state)) {
+                        return -1;
+                    }
+                    consumed = 1;
+                    break;
+                }
+            }
+        } else if (!(node.attributes & kFlagAttribute)) {
+            for (std::uint32_t f = node.first_form; f < forms_end; f++) {
+                if (prefixes(forms_[f], arg)) {
+                    if (!assign(node, storage, arg.substr(forms_[f].size + 1), state)) {
+                        return -1;
+                    }
+                    consumed = 1;
+                    break;
+                }
+            }
+        } else if (node.attributes & kCountAttribute) {
+            const unsigned long long occurrences = combined_occurrences(node, arg);
+            if (occurrences > 0) {
+                if (!assign_flag(node, storage, occurrences, state)) {
+                    return -1;
+                }
+                consumed = 1;
+            }
+        }
+    }
+
+    if (consumed > 0 && state != nullptr) {
+        state->reach(start + consumed);
+        state->match(index);
+        state->hit(index);
+    }
+    return consumed;
+}
+
+size_t Grammar::consume(const std::uint32_t index,
+                        const std::vector<std::string>& args,
+                        const size_t start,
+                        void* const storage,
+                        ParseState* const state) const {
+    size_t consumed = match(index, args, start, storage, state);
+    if (consumed < 0) {
+        return -1;
+    }
+
+    const Node& node = nodes_[index];
+    std::vector<std::uint8_t> status(node.option_count, AVAILABLE);
+
+    // Try options
+    consumed = try_options(node, &status, args, start, consumed, state);
+
+    // Find at most one next that works
+    for (std::uint32_t i = node.option_count; i < node.option_count + node.next_count; i++) {
+        if (state != nullptr && state->aborted()) {
+            return -1;
+        }
+
+        const std::uint32_t next = child(node, i, state);
+        const size_t consumption = attempt(next, args, start + consumed, state);
+        if (consumption <= 0) {
+            if (missing(next, state)) {
+                return -1;
+            }
+        } else {
+            consumed += consumption;
+            break;
+        }
+    }
+
+    consumed = try_options(node, &status, args, start, consumed, state);
+    if (state != nullptr && state->aborted()) {
+        return -1;
+    }
+
+    for (std::uint32_t i = 0; i < node.option_count; i++) {
+        if (status[i] == AVAILABLE && missing(child(node, i, state), state)) {
+            return -1;
+        }
+    }
+
+    return consumed;
+}
+
+size_t Grammar::try_options(const Node& node,
+                            std::vector<std::uint8_t>* status,
+                            const std::vector<std::string>& args,
+                            const size_t start,
+                            size_t consumed,
+                            ParseState* const state) const {
+    // Sorted options are tried from the most used one again after each match, as each argument
+    // matches at most one of them whichever are tried first
+    const bool dry_run = state != nullptr && state->probes() != nullptr;
+    const bool restarts = !dry_run && !sorted_.empty() && sorted_[index_of(node)];
+    bool parsed_something;
+    do {
+        parsed_something = false;
+        for (std::uint32_t i = 0; i < node.option_count; i++) {
+            if ((*status)[i] == CONSUMED) {
+                continue;
+            }
+
+            const std::uint32_t option = child(node, i, state);
+            const size_t consumption = attempt(option, args, start + consumed, state);
+            if (state != nullptr && state->aborted()) {
+                return consumed;
+            }
+            if (consumption > 0) {
+                const bool repeats =
+                        nodes_[option].attributes & (kRepeatedAttribute | kCountAttribute);
+                (*status)[i] = repeats ? REPEATING : CONSUMED;
+                consumed += consumption;
+                parsed_something = true;
+                if (restarts) {
+                    break;
+                }
+            }
+        }
+    } while (parsed_something);
+
+    return consumed;
+}
+
+size_t Grammar::attempt(const std::uint32_t index,
+                        const std::vector<std::string>& args,
+                        const size_t start,
+                        ParseState* const state) const {
+    void* const storage = storage_for(index, state);
+    const Node& node = nodes_[index];
+    // Nothing is kept when a node without children fails to match
+    if (state == nullptr || node.option_count + node.next_count == 0) {
+        return consume(index, args, start, storage, state);
+    }
+
+    const std::size_t mark = state->attempt();
+    const size_t consumed = consume(index, args, start, storage, state);
+    if (consumed <= 0) {
+        rollback(mark, state);
+    }
+    state->commit();
+    return consumed;
+}
+
+void Grammar::rollback(const std::size_t mark, ParseState* const state) const {
+    ParseState::Undo undo;
+    while (state->pop(mark, &undo)) {
+        void* const storage = storage_[undo.node];
+        const Type type = static_cast<Type>(nodes_[undo.node].type);
+        switch (undo.kind) {
+            case ParseState::Undo::Kind::APPEND:
+                TruncateAppended(storage, type, static_cast<std::size_t>(undo.before));
+                break;
+            case ParseState::Undo::Kind::COUNT:
+                std::memcpy(storage, &undo.before, SizeOf(type));
+                break;
+            case ParseState::Undo::Kind::PROPERTY_COUNT:
+                static_cast<Properties*>(storage)->truncate(static_cast<std::size_t>(undo.before));
+                break;
+            case ParseState::Undo::Kind::PROPERTY_VALUE:
+                static_cast<Properties*>(storage)->restore(static_cast<std::size_t>(undo.before),
+                                                           undo.value, undo.value_size);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void Grammar::record_append(const Node& node, void* const storage, ParseState* const state) const {
+    if (state != nullptr && state->attempting()) {
+        state->record(ParseState::Undo{ ParseState::Undo::Kind::APPEND, index_of(node),
+                                        AppendedSize(storage, static_cast<Type>(node.type)),
+                                        nullptr, 0 });
+    }
+}
+
+size_t Grammar::consume_flat(const std::vector<std::string>& args,
+                             const size_t start,
+                             void* const root_storage,
+                             ParseState* const state) const {
+    size_t consumed = match(0, args, start, root_storage, state);
+    if (consumed < 0) {
+        return -1;
+    }
+
+    const Node& root = nodes_[0];
+    // A bit per option that has matched at least once, kept inline for up to 64 options
+    const std::size_t words = (root.option_count + 63) / 64;
+    std::uint64_t inline_matched = 0;
+    std::vector<std::uint64_t> spilled_matched;
+    std::uint64_t* matched = &inline_matched;
+    if (words > 1) {
+        spilled_matched.assign(words, 0);
+        matched = spilled_matched.data();
+    }
+    std::vector<std::uint32_t> candidates;
+    candidates.reserve(flat_unindexed_.size() + 4);
+    // try_options sweeps the options in order and resumes after whichever last matched, wrapping
+    // around while anything does, so the first candidate that matches from here is the one it finds
+    std::uint32_t resume = 0;
+    while (start + consumed < static_cast<size_t>(args.size())) {
+        flat_candidates(args[start + consumed], &candidates);
+        const std::uint32_t option_count = root.option_count;
+        std::sort(candidates.begin(), candidates.end(),
+                  [resume, option_count](const std::uint32_t a, const std::uint32_t b) {
+                      return (a + option_count - resume) % option_count <
+                              (b + option_count - resume) % option_count;
+                  });
+
+        bool parsed_something = false;
+        for (const std::uint32_t i : candidates) {
+            const std::uint32_t option = root.first_child + i;
+            const bool repeats = nodes_[option].attributes & (kRepeatedAttribute | kCountAttribute);
+            const std::uint64_t bit = std::uint64_t(1) << (i % 64);
+            if ((matched[i / 64] & bit) && !repeats) {
+                continue;
+            }
+
+            const size_t consumption =
+                    match(option, args, start + consumed, storage_for(option, state), state);
+            if (state != nullptr && state->aborted()) {
+                return -1;
+            }
+            if (consumption > 0) {
+                matched[i / 64] |= bit;
+                consumed += consumption;
+                resume = (i + 1) % option_count;
+                parsed_something = true;
+                break;
+            }
+        }
+        if (!parsed_something) {
+            break;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < root.option_count; i++) {
+        if (!(matched[i / 64] & (std::uint64_t(1) << (i % 64))) &&
+                missing(root.first_child + i, state)) {
+            return -1;
+        }
+    }
+    return consumed;
+}
+
+void Grammar::flat_candidates(const std::string& arg,
+                              std::vector<std::uint32_t>* candidates) const {
+    candidates->assign(flat_unindexed_.begin(), flat_unindexed_.end());
+
+    const char* const pool = pool_;
+    const auto add_form = [this, pool, &arg, candidates](const std::size_t size) {
+        const auto less_than = [pool, &arg, size](const FlatForm& entry, const std::nullptr_t) {
+            return CompareBytes(pool + entry.form.offset, entry.form.size, arg.data(), size) < 0;
+        };
+        auto it = std::lower_bound(flat_forms_.begin(), flat_forms_.end(), nullptr, less_than);
+        for (; it != flat_forms_.end() && it->form.size == size &&
+                std::memcmp(pool + it->form.offset, arg.data(), size) == 0; ++it) {
+            candidates->push_back(it->option);
+        }
+    };
+
+    // Forms equal to the argument, then those it starts with followed by '='
+    add_form(arg.size());
+    for (std::size_t end = arg.find('='); end != std::string::npos; end = arg.find('=', end + 1)) {
+        add_form(end);
+    }
+
+    std::sort(candidates->begin(), candidates->end());
+    candidates->erase(std::unique(candidates->begin(), candidates->end()), candidates->end());
+}
+
+void* Grammar::storage_for(const std::uint32_t node, const ParseState* const state) const {
+    if (state != nullptr && state->probes() != nullptr) {
+        return nullptr;
+    }
+    return storage_[node];
+}
+
+void Grammar::complete_value(const std::uint32_t node,
+                             const std::string& lead,
+                             const std::string& word,
+                             std::unordered_set<std::string>* seen,
+                             std::vector<Completion>* completions) const {
+    const Node& n = nodes_[node];
+    if (n.choices == 0) {
+        std::string hint = str(help_[node].name);
+        if (hint.empty()) {
+            std::ostringstream type;
+            type << static_cast<Type>(n.type);
+            hint = type.str();
+        }
+        add_completion(CompletionKind::VALUE, hint, node, seen, completions);
+        return;
+    }
+
+    const ChoiceTable::View view = choices(n);
+    for (std::uint32_t i = 0; i < view.entry_count; i++) {
+        const ChoiceTable::Entry& entry = view.entries[i];
+        const std::string candidate = lead + std::string(view.names + entry.offset, entry.size);
+        if (candidate.compare(0, word.size(), word) == 0) {
+            add_completion(CompletionKind::CHOICE, candidate, node, seen, completions);
+        }
+    }
+}
+
+void Grammar::add_completion(const CompletionKind kind,
+                             const std::string& value,
+                             const std::uint32_t node,
+                             std::unordered_set<std::string>* seen,
+                             std::vector<Completion>* completions) const {
+    // Kinds are kept apart so a hint never hides a form or choice with the same text
+    if (seen->insert(static_cast<char>(kind) + value).second) {
+        completions->emplace_back(kind, value, str(help_[node].description));
+    }
+}
+
+bool Grammar::assign(const Node& node, void* const storage, const std::string& value,
+                     ParseState* const state) const {
+    const Type type = static_cast<Type>(node.type);
+    if (type == Type::PROPERTIES) {
+        return assign_property(node, storage, value, 0, -1, state);
+    }
+    if (storage == nullptr) {
+        long long choice;
+        return node.choices != 0 && !(node.attributes & kRepeatedAttribute) ?
+                choices(node).find(value.data(), value.size(), &choice) : Validate(type, value);
+    }
+
+    StoreLog* const log = state != nullptr ? state->log() : nullptr;
+    if (node.attributes & kRepeatedAttribute) {
+        record_append(node, storage, state);
+        if (!AssignAppend(storage, type, value)) {
+            return false;
+        }
+        if (log != nullptr) {
+            log->append(index_of(node), value);
+        }
+        return true;
+    }
+
+    long long choice;
+    const bool assigned = node.choices != 0 ?
+            choices(node).find(value.data(), value.size(), &choice) &&
+                AssignChoice(storage, type, choice) :
+            Assign(storage, type, value);
+    if (assigned && log != nullptr) {
+        log_value(node, storage, log);
+    }
+    return assigned;
+}
+
+bool Grammar::assign_remaining(const Node& node, void* const storage,
+                               const std::vector<std::string>& args, const size_t start,
+                               ParseState* const state) const {
+    const Type type = static_cast<Type>(node.type);
+    if (storage == nullptr) {
+        for (std::size_t i = start; i < args.size(); i++) {
+            if (!Validate(type, args[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    record_append(node, storage, state);
+    if (!AssignAppendAll(storage, type, args.data() + start, args.size() - start)) {
+        return false;
+    }
+    StoreLog* const log = state != nullptr ? state->log() : nullptr;
+    if (log != nullptr) {
+        for (std::size_t i = start; i < args.size(); i++) {
+            log->append(index_of(node), args[i]);
+        }
+    }
+    return true;
+}
+
+bool Grammar::assign_property(const Node& node,
+                              void* const storage,
+                              const std::string& arg,
+                              const std::size_t offset,
+                              const size_t position,
+                              ParseState* const state) const {
+    const std::size_t separator = arg.find('=', offset);
+    const std::size_t key_end = separator == std::string::npos ? arg.size() : separator;
+    const std::size_t value_start = separator == std::string::npos ? arg.size() : separator + 1;
+    if (key_end == offset) {
+        return false;
+    }
+    if (storage == nullptr) {
+        return true;
+    }
+
+    DuplicateKeyPolicy policy = DuplicateKeyPolicy::LAST_WINS;
+    if (node.attributes & kFirstWinsAttribute) {
+        policy = DuplicateKeyPolicy::FIRST_WINS;
+    } else if (node.attributes & kRejectDuplicatesAttribute) {
+        policy = DuplicateKeyPolicy::REJECT;
+    }
+
+    Properties* const properties = static_cast<Properties*>(storage);
+    // An attempt that is abandoned must leave the properties as they were
+    const bool attempting = state != nullptr && state->attempting();
+    const std::size_t size = properties->size();
+    const std::size_t existing = attempting ? properties->index(arg.data() + offset,
+                                                                key_end - offset) : size;
+    const Properties::Entry previous = existing < size ? properties->begin()[existing] :
+                                                         Properties::Entry{};
+    const char* const original = borrowed(node, position, state);
+    // The value runs to the end of the argument, so a borrowed one is null-terminated
+    const bool assigned = original != nullptr ?
+            properties->borrow(original + offset, key_end - offset,
+                               original + value_start, arg.size() - value_start, policy) :
+            properties->insert(arg.data() + offset, key_end - offset,
+                               arg.data() + value_start, arg.size() - value_start, policy);
+    if (assigned && attempting) {
+        if (properties->size() != size) {
+            state->record(ParseState::Undo{ ParseState::Undo::Kind::PROPERTY_COUNT,
+                                            index_of(node), size, nullptr, 0 });
+        } else if (existing < size) {
+            state->record(ParseState::Undo{ ParseState::Undo::Kind::PROPERTY_VALUE,
+                                            index_of(node), existing, previous.value,
+                                            previous.value_size });
+        }
+    }
+    if (assigned && state != nullptr && state->log() != nullptr) {
+        state->log()->property(index_of(node), arg, static_cast<std::uint32_t>(offset),
+                               original != nullptr ? static_cast<std::uint32_t>(position) :
+                                                     StoreLog::kNoPosition);
+    }
+    return assigned;
+}
+
+const char* Grammar::borrowed(const Node& node,
+                              const size_t position,
+                              const ParseState* const state) const {
+    if (!(node.attributes & kBorrowAttribute) || position < 0 || state == nullptr ||
+            state->argv() == nullptr) {
+        return nullptr;
+    }
+    return state->argv()[position];
+}
+
+bool Grammar::assign_flag(const Node& node, void* const storage,
+                          const unsigned long long occurrences, ParseState* const state) const {
+    if (storage == nullptr) {
+        return true;
+    }
+
+    const Type type = static_cast<Type>(node.type);
+    StoreLog* const log = state != nullptr ? state->log() : nullptr;
+    if (node.attributes & kCountAttribute) {
+        if (state != nullptr && state->attempting()) {
+            ParseState::Undo undo{ ParseState::Undo::Kind::COUNT, index_of(node), 0, nullptr, 0 };
+            std::memcpy(&undo.before, storage, SizeOf(type));
+            state->record(undo);
+        }
+        if (!AssignCount(storage, type, occurrences)) {
+            return false;
+        }
+        if (log != nullptr) {
+            log->count(index_of(node), occurrences);
+        }
+        return true;
+    }
+    if (!Assign(storage, type, true)) {
+        return false;
+    }
+    if (log != nullptr) {
+        log_value(node, storage, log);
+    }
+    return true;
+}
+
+void Grammar::log_value(const Node& node, const void* const storage, StoreLog* const log) const {
+    const Type type = static_cast<Type>(node.type);
+    const std::size_t size = SizeOf(type);
+    if (size > 0) {
+        log->value(index_of(node), std::string(static_cast<const char*>(storage), size));
+    } else {
+        log->value(index_of(node), *static_cast<const std::string*>(storage));
+    }
+}
+
+std::uint32_t Grammar::index_of(const Node& node) const {
+    return static_cast<std::uint32_t>(&node - nodes_);
+}
+
+unsigned long long Grammar::combined_occurrences(const Node& node, const std::string& arg) const {
+    if (arg.size() < 2 || arg[0] != '-') {
+        return 0;
+    }
+
+    for (std::uint32_t f = node.first_form; f < node.first_form + node.form_count; f++) {
+        const StringRef& form = forms_[f];
+        const char* const chars = pool_ + form.offset;
+        if (form.size == 2 && chars[0] == '-' && chars[1] != '-' &&
+                arg.find_first_not_of(chars[1], 1) == std::string::npos) {
+            return arg.size() - 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/hash.h"
+
+namespace {
+
+// FNV-1a parameters for 64-bit hashes
+const std::uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+const std::uint64_t kFnvPrime = 0x100000001b3ull;
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+std::uint64_t HashBytes(const char* data, const std::size_t size, const bool case_insensitive) {
+    std::uint64_t hash = kFnvOffsetBasis;
+    const char* const end = data + size;
+    if (case_insensitive) {
+        for (; data != end; data++) {
+            hash = (hash ^ static_cast<unsigned char>(ToLowerAscii(*data))) * kFnvPrime;
+        }
+    } else {
+        for (; data != end; data++) {
+            hash = (hash ^ static_cast<unsigned char>(*data)) * kFnvPrime;
+        }
+    }
+    return Mix64(hash);
+}
+
+// The finalizer of MurmurHash3
+std::uint64_t Mix64(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+char ToLowerAscii(const char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,60 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/hit_counters.h"
+
+namespace ahoy {
+namespace internal {
+
+HitCounters::HitCounters(const std::size_t nodes) :
+        size_(nodes), counts_(nodes > 0 ? new std::atomic<unsigned long long>[nodes] : nullptr) {
+    clear();
+}
+
+HitCounters::HitCounters(const HitCounters& other) : HitCounters(other.size()) {}
+
+HitCounters& HitCounters::operator=(const HitCounters& other) {
+    if (this != &other) {
+        size_ = other.size();
+        counts_.reset(size_ > 0 ? new std::atomic<unsigned long long>[size_] : nullptr);
+        clear();
+    }
+    return *this;
+}
+
+HitCounters::~HitCounters() {}
+
+bool HitCounters::disabled() const {
+    return size_ == 0;
+}
+
+std::size_t HitCounters::size() const {
+    return size_;
+}
+
+void HitCounters::hit(const std::size_t node) {
+    if (node < size_) {
+        counts_[node].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+unsigned long long HitCounters::hits(const std::size_t node) const {
+    return node < size_ ? counts_[node].load(std::memory_order_relaxed) : 0;
+}
+
+std::vector<unsigned long long> HitCounters::counts() const {
+    std::vector<unsigned long long> counts(size_);
+    for (std::size_t i = 0; i < size_; i++) {
+        counts[i] = hits(i);
+    }
+    return counts;
+}
+
+void HitCounters::clear() {
+    for (std::size_t i = 0; i < size_; i++) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,138 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/parse_cache.h"
+
+#include <cstring>
+
+#include "ahoy/internal/hash.h"
+
+namespace {
+
+// Appends |size| to |key| as fixed-width bytes, so no two lists of strings share a key
+void AppendSize(const std::size_t size, std::string* key) {
+    const std::uint32_t narrowed = static_cast<std::uint32_t>(size);
+    key->append(reinterpret_cast<const char*>(&narrowed), sizeof(narrowed));
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+ParseCache::ParseCache(const std::size_t capacity) :
+        capacity_(capacity), entries_(), index_(), hits_(0), misses_(0), mutex_() {}
+
+ParseCache::ParseCache(const ParseCache& other) : ParseCache(other.capacity()) {}
+
+ParseCache& ParseCache::operator=(const ParseCache& other) {
+    if (this != &other) {
+        const std::size_t capacity = other.capacity();
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        entries_.clear();
+        index_.clear();
+        hits_ = 0;
+        misses_ = 0;
+    }
+    return *this;
+}
+
+ParseCache::~ParseCache() {}
+
+bool ParseCache::disabled() const {
+    return capacity() == 0;
+}
+
+std::size_t ParseCache::capacity() const {
+    // Only changed by assigning the cache, which must not race with using it anyway
+    return capacity_;
+}
+
+std::size_t ParseCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::string ParseCache::Key(const int argc, char const * const argv[],
+                            const std::vector<const char*>& environment) {
+    std::size_t size = 0;
+    for (int i = 0; i < argc; i++) {
+        size += sizeof(std::uint32_t) + std::strlen(argv[i]);
+    }
+
+    std::string key;
+    key.reserve(size + sizeof(std::uint32_t));
+    for (int i = 0; i < argc; i++) {
+        const std::size_t length = std::strlen(argv[i]);
+        AppendSize(length, &key);
+        key.append(argv[i], length);
+    }
+    // The number of arguments keeps them apart from the environment
+    AppendSize(static_cast<std::size_t>(argc), &key);
+    for (std::size_t node = 0; node < environment.size(); node++) {
+        if (environment[node] != nullptr) {
+            const std::size_t length = std::strlen(environment[node]);
+            AppendSize(node, &key);
+            AppendSize(length, &key);
+            key.append(environment[node], length);
+        }
+    }
+    return key;
+}
+
+std::shared_ptr<const StoreLog> ParseCache::find(const std::string& key) {
+    const std::uint64_t hash = HashBytes(key.data(), key.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found = index_.find(hash);
+    if (found == index_.end() || found->second->key != key) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->log;
+}
+
+void ParseCache::insert(const std::string& key, const std::shared_ptr<const StoreLog>& log) {
+    const std::uint64_t hash = HashBytes(key.data(), key.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+
+    // Replaces an entry with the same key, or with a colliding hash
+    const auto found = index_.find(hash);
+    if (found != index_.end()) {
+        found->second->key = key;
+        found->second->log = log;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+
+    if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().hash);
+        entries_.pop_back();
+    }
+    entries_.push_front(Entry{ hash, key, log });
+    index_.emplace(hash, entries_.begin());
+}
+
+void ParseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+unsigned long long ParseCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+unsigned long long ParseCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+} // namespace internal
+} // namespace ahoy
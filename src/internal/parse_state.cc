@@ -0,0 +1,203 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/parse_state.h"
+
+#include <algorithm>
+
+#include "ahoy/internal/hit_counters.h"
+#include "ahoy/internal/store_log.h"
+
+namespace {
+
+// Reading the clock and the cancellation flag is much more expensive than a step so they are only
+// checked on the first step and then once every this many steps
+const unsigned long long kPollInterval = 64;
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+ParseState::ParseState() : ParseState(0, std::chrono::nanoseconds::zero(), nullptr) {}
+
+ParseState::ParseState(const unsigned long long step_budget,
+                       const std::chrono::nanoseconds timeout,
+                       const std::atomic<bool>* const cancelled) :
+        step_budget_(step_budget),
+        has_deadline_(timeout > std::chrono::nanoseconds::zero()),
+        deadline_(std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout)),
+        cancelled_(cancelled),
+        steps_(0),
+        error_(ParseError::NONE),
+        probe_position_(0),
+        probes_(nullptr),
+        reached_(0),
+        environment_(nullptr),
+        matched_(),
+        argv_(nullptr),
+        log_(nullptr),
+        counters_(nullptr),
+        attempts_(0),
+        undos_() {}
+
+ParseState::~ParseState() {}
+
+bool ParseState::step() {
+    if (error_ != ParseError::NONE) {
+        return false;
+    }
+
+    steps_++;
+
+    if (step_budget_ > 0 && steps_ > step_budget_) {
+        error_ = ParseError::STEP_BUDGET_EXCEEDED;
+        return false;
+    }
+
+    if (steps_ % kPollInterval == 1) {
+        if (cancelled_ != nullptr && cancelled_->load(std::memory_order_relaxed)) {
+            error_ = ParseError::CANCELLED;
+            return false;
+        }
+        if (has_deadline_ && std::chrono::steady_clock::now() > deadline_) {
+            error_ = ParseError::DEADLINE_EXCEEDED;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParseState::aborted() const {
+    return error_ != ParseError::NONE;
+}
+
+ParseError ParseState::error() const {
+    return error_;
+}
+
+unsigned long long ParseState::steps() const {
+    return steps_;
+}
+
+void ParseState::probe(const std::size_t position, std::vector<std::uint8_t>* const probes) {
+    probe_position_ = position;
+    probes_ = probes;
+}
+
+std::vector<std::uint8_t>* ParseState::probes() const {
+    return probes_;
+}
+
+std::size_t ParseState::probe_position() const {
+    return probe_position_;
+}
+
+void ParseState::reach(const std::size_t position) {
+    reached_ = std::max(reached_, position);
+}
+
+std::size_t ParseState::reached() const {
+    return reached_;
+}
+
+void ParseState::environment(const std::vector<const char*>* const values) {
+    environment_ = values;
+    if (values != nullptr && values->size() > matched_.size()) {
+        track(values->size());
+    }
+}
+
+const char* ParseState::variable(const std::size_t node) const {
+    return environment_ != nullptr && node < environment_->size() ? (*environment_)[node] : nullptr;
+}
+
+void ParseState::track(const std::size_t nodes) {
+    matched_.assign(nodes, false);
+}
+
+void ParseState::match(const std::size_t node) {
+    if (node < matched_.size() && !matched_[node]) {
+        matched_[node] = true;
+        record(Undo{ Undo::Kind::MATCH, static_cast<std::uint32_t>(node), 0, nullptr, 0 });
+    }
+}
+
+bool ParseState::matched(const std::size_t node) const {
+    return node < matched_.size() && matched_[node];
+}
+
+void ParseState::argv(char const * const * const argv) {
+    argv_ = argv;
+}
+
+char const * const * ParseState::argv() const {
+    return argv_;
+}
+
+void ParseState::log(StoreLog* const log) {
+    log_ = log;
+}
+
+StoreLog* ParseState::log() const {
+    return log_;
+}
+
+void ParseState::counters(HitCounters* const counters) {
+    counters_ = counters;
+}
+
+void ParseState::hit(const std::size_t node) {
+    if (counters_ != nullptr && probes_ == nullptr) {
+        counters_->hit(node);
+    }
+}
+
+std::size_t ParseState::attempt() {
+    const std::size_t mark = undos_.size();
+    attempts_++;
+    if (log_ != nullptr) {
+        record(Undo{ Undo::Kind::LOG, 0, log_->stores().size(), nullptr, 0 });
+    }
+    return mark;
+}
+
+void ParseState::commit() {
+    attempts_--;
+    if (attempts_ == 0) {
+        undos_.clear();
+    }
+}
+
+bool ParseState::attempting() const {
+    return attempts_ > 0;
+}
+
+void ParseState::record(const Undo& undo) {
+    if (attempts_ > 0) {
+        undos_.push_back(undo);
+    }
+}
+
+bool ParseState::pop(const std::size_t mark, Undo* const undo) {
+    while (undos_.size() > mark) {
+        *undo = undos_.back();
+        undos_.pop_back();
+        switch (undo->kind) {
+            case Undo::Kind::MATCH:
+                matched_[undo->node] = false;
+                break;
+            case Undo::Kind::LOG:
+                log_->truncate(static_cast<std::size_t>(undo->before));
+                break;
+            default:
+                return true;
+        }
+    }
+    return false;
+}
+
+} // namespace internal
+} // namespace ahoy
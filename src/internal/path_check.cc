@@ -0,0 +1,127 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/path_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <system_error>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Describes why a stat or access call failed with |error|. strerror is avoided as it is not
+// guaranteed to be safe to call from several threads.
+std::string Describe(const int error) {
+    switch (error) {
+        case ENOENT:
+        case ENOTDIR:
+            return "does not exist";
+        case EACCES:
+            return "is not accessible";
+        default:
+            return "could not be checked";
+    }
+}
+
+// The directory containing |path|, which is "." for a bare file name
+std::string Parent(const std::string& path) {
+    std::size_t end = path.size();
+    while (end > 1 && path[end - 1] == '/') {
+        end--;
+    }
+    const std::size_t slash = path.rfind('/', end - 1);
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+std::string CheckPath(const std::string& path, const PathKind kind) {
+    if (kind == PathKind::ANY) {
+        return std::string();
+    }
+    if (path.empty()) {
+        return "is empty";
+    }
+
+    struct stat info;
+    const bool exists = ::stat(path.c_str(), &info) == 0;
+    const int error = errno;
+    switch (kind) {
+        case PathKind::EXISTING_FILE:
+            if (!exists) {
+                return Describe(error);
+            }
+            return S_ISDIR(info.st_mode) ? "is a directory" : std::string();
+        case PathKind::EXISTING_DIRECTORY:
+            if (!exists) {
+                return Describe(error);
+            }
+            return S_ISDIR(info.st_mode) ? std::string() : "is not a directory";
+        case PathKind::CREATABLE: {
+            if (exists) {
+                if (S_ISDIR(info.st_mode)) {
+                    return "is a directory";
+                }
+                return ::access(path.c_str(), W_OK) == 0 ? std::string() : "is not writable";
+            }
+            if (error != ENOENT) {
+                return Describe(error);
+            }
+            const std::string parent = Parent(path);
+            if (::stat(parent.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+                return "is in a directory that does not exist";
+            }
+            if (::access(parent.c_str(), W_OK | X_OK) != 0) {
+                return "is in a directory that is not writable";
+            }
+            return std::string();
+        }
+        default:
+            return std::string();
+    }
+}
+
+std::vector<std::string> CheckPaths(const std::vector<PathRequest>& requests,
+                                    const std::size_t threads) {
+    std::vector<std::string> reasons(requests.size());
+    // Each thread claims the next unchecked request until none are left, so a slow path only holds
+    // up the thread checking it
+    std::atomic<std::size_t> next(0);
+    const auto work = [&requests, &reasons, &next]() {
+        for (std::size_t i = next++; i < requests.size(); i = next++) {
+            reasons[i] = CheckPath(requests[i].path, requests[i].kind);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const std::size_t worker_count = std::min(threads, requests.size());
+    if (worker_count > 1) {
+        workers.reserve(worker_count - 1);
+        try {
+            while (workers.size() < worker_count - 1) {
+                workers.emplace_back(work);
+            }
+        } catch (const std::system_error&) {
+            // Whatever the started threads do not get to is checked below
+        }
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return reasons;
+}
+
+} // namespace internal
+} // namespace ahoy
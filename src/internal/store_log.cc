@@ -0,0 +1,43 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/store_log.h"
+
+namespace ahoy {
+namespace internal {
+
+const std::uint32_t StoreLog::kNoPosition;
+
+StoreLog::StoreLog() : stores_() {}
+
+StoreLog::~StoreLog() {}
+
+void StoreLog::value(const std::uint32_t node, const std::string& data) {
+    stores_.push_back(Store{ node, Kind::VALUE, 0, kNoPosition, 0, data });
+}
+
+void StoreLog::append(const std::uint32_t node, const std::string& text) {
+    stores_.push_back(Store{ node, Kind::APPEND, 0, kNoPosition, 0, text });
+}
+
+void StoreLog::count(const std::uint32_t node, const unsigned long long occurrences) {
+    stores_.push_back(Store{ node, Kind::COUNT, 0, kNoPosition, occurrences, std::string() });
+}
+
+void StoreLog::property(const std::uint32_t node, const std::string& arg,
+                        const std::uint32_t offset, const std::uint32_t position) {
+    stores_.push_back(Store{ node, Kind::PROPERTY, offset, position, 0, arg });
+}
+
+void StoreLog::truncate(const std::size_t size) {
+    if (size < stores_.size()) {
+        stores_.erase(stores_.begin() + size, stores_.end());
+    }
+}
+
+const std::vector<StoreLog::Store>& StoreLog::stores() const {
+    return stores_;
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -3,9 +3,60 @@
 
 #include "ahoy/internal/type.h"
 
+#include <cstdint>
+
 namespace ahoy {
 namespace internal {
 
+std::size_t SizeOf(const Type type) {
+    switch (type) {
+        case Type::BOOL:
+            return sizeof(bool);
+        case Type::CHAR:
+            return sizeof(char);
+        case Type::U_CHAR:
+            return sizeof(unsigned char);
+        case Type::SHORT:
+            return sizeof(short);
+        case Type::U_SHORT:
+            return sizeof(unsigned short);
+        case Type::INT:
+            return sizeof(int);
+        case Type::U_INT:
+            return sizeof(unsigned int);
+        case Type::LONG:
+            return sizeof(long);
+        case Type::U_LONG:
+            return sizeof(unsigned long);
+        case Type::LONG_LONG:
+            return sizeof(long long);
+        case Type::U_LONG_LONG:
+            return sizeof(unsigned long long);
+        case Type::FLOAT:
+            return sizeof(float);
+        case Type::DOUBLE:
+            return sizeof(double);
+        case Type::LONG_DOUBLE:
+            return sizeof(long double);
+        case Type::BYTES:
+            return sizeof(std::uint64_t);
+        case Type::NANOSECONDS:
+            return sizeof(std::chrono::nanoseconds);
+        case Type::MICROSECONDS:
+            return sizeof(std::chrono::microseconds);
+        case Type::MILLISECONDS:
+            return sizeof(std::chrono::milliseconds);
+        case Type::SECONDS:
+            return sizeof(std::chrono::seconds);
+        case Type::MINUTES:
+            return sizeof(std::chrono::minutes);
+        case Type::HOURS:
+            return sizeof(std::chrono::hours);
+        default:
+            return 0;
+    }
+}
+
 std::ostream& operator<<(std::ostream& os, const Type& type) {
     switch (type) {
         case Type::INVALID:
@@ -40,6 +91,24 @@ std::ostream& operator<<(std::ostream& os, const Type& type) {
             return os << "Long Double";
         case Type::STRING:
             return os << "String";
+        case Type::BYTES:
+            return os << "Bytes";
+        case Type::NANOSECONDS:
+            return os << "Nanoseconds";
+        case Type::MICROSECONDS:
+            return os << "Microseconds";
+        case Type::MILLISECONDS:
+            return os << "Milliseconds";
+        case Type::SECONDS:
+            return os << "Seconds";
+        case Type::MINUTES:
+            return os << "Minutes";
+        case Type::HOURS:
+            return os << "Hours";
+        case Type::PROPERTIES:
+            return os << "Properties";
+        case Type::UTF8_STRING:
+            return os << "UTF-8 String";
         default:
             return os << "Unknown";
     }
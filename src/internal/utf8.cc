@@ -0,0 +1,108 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/utf8.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Every byte of ASCII text has its high bit clear
+const std::uint64_t kHighBits = 0x8080808080808080ULL;
+
+// The number of ASCII bytes at the start of the |size| bytes at |data|
+std::size_t AsciiPrefix(const unsigned char* const data, const std::size_t size) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const int mask = _mm_movemask_epi8(block);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+        }
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if (word & kHighBits) {
+            break;
+        }
+    }
+    while (i < size && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+// The length of the well-formed multi-byte sequence at the start of the |size| bytes at |data|, or
+// 0 if it is malformed. The ranges of the second byte follow table 3-7 of the Unicode standard.
+std::size_t SequenceLength(const unsigned char* const data, const std::size_t size) {
+    const unsigned char lead = data[0];
+    std::size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) {
+            // Overlong
+            low = 0xA0;
+        } else if (lead == 0xED) {
+            // Surrogates
+            high = 0x9F;
+        }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) {
+            // Overlong
+            low = 0x90;
+        } else if (lead == 0xF4) {
+            // Past U+10FFFF
+            high = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+
+    if (size < length || data[1] < low || data[1] > high) {
+        return 0;
+    }
+    for (std::size_t i = 2; i < length; i++) {
+        if ((data[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+bool ValidUtf8(const char* const data, const std::size_t size) {
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+    std::size_t i = 0;
+    while (i < size) {
+        i += AsciiPrefix(bytes + i, size - i);
+        if (i == size) {
+            break;
+        }
+        const std::size_t length = SequenceLength(bytes + i, size - i);
+        if (length == 0) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+} // namespace internal
+} // namespace ahoy
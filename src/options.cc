@@ -0,0 +1,32 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/options.h"
+
+// Defines the constructor and destructor declared by _AHOY_OPTIONS_OUT_OF_LINE_OPTION_CLASS
+#define _AHOY_OPTIONS_DEFINE_OPTION_CLASS(ClassName, ValueType) \
+    ClassName::ClassName(const ValueType& value) : Option(value) {} \
+    ClassName::~ClassName() {}
+
+// Defines the constructors and destructor declared by _AHOY_OPTIONS_STRING_OPTION_CLASS
+#define _AHOY_OPTIONS_DEFINE_STRING_OPTION_CLASS(ClassName) \
+    _AHOY_OPTIONS_DEFINE_OPTION_CLASS(ClassName, std::string) \
+    ClassName::ClassName(const char* const value) : Option(std::string(value)) {}
+
+// Defines the constructors and destructor declared by _AHOY_OPTIONS_FORMS_OPTION_CLASS
+#define _AHOY_OPTIONS_DEFINE_FORMS_OPTION_CLASS(ClassName) \
+    _AHOY_OPTIONS_DEFINE_OPTION_CLASS(ClassName, std::set<std::string>) \
+    ClassName::ClassName(const std::initializer_list<const char*> values) : \
+            Option(std::set<std::string>(values.begin(), values.end())) {}
+
+namespace ahoy {
+
+_AHOY_OPTIONS_DEFINE_STRING_OPTION_CLASS(Description)
+_AHOY_OPTIONS_DEFINE_STRING_OPTION_CLASS(Name)
+_AHOY_OPTIONS_DEFINE_FORMS_OPTION_CLASS(Forms)
+_AHOY_OPTIONS_DEFINE_FORMS_OPTION_CLASS(ShortForms)
+_AHOY_OPTIONS_DEFINE_FORMS_OPTION_CLASS(LongForms)
+_AHOY_OPTIONS_DEFINE_OPTION_CLASS(Choices, std::vector<Choice>)
+_AHOY_OPTIONS_DEFINE_STRING_OPTION_CLASS(EnvVar)
+
+} // namespace ahoy
@@ -3,40 +3,24 @@
 
 #include "ahoy/parameter.h"
 
-#include "ahoy/internal/assign.h"
-
-namespace {
-
-// Attempts to consume some options, returning the new consumed value
-ahoy::internal::size_t try_options(const std::vector<std::string>& args,
-                                   std::set<const ahoy::Parameter*>& available_options,
-                                   const ahoy::internal::size_t start,
-                                   ahoy::internal::size_t consumed) {
-    bool parsed_something;
-    do {
-        parsed_something = false;
-        for (auto it = available_options.begin(); it != available_options.end();) {
-            ahoy::Parameter const * const parameter = *it;
-            ahoy::internal::size_t consumption = parameter->consume(args, start + consumed);
-            if (consumption > 0) {
-                // Incrementing must be done here to avoid `it` referencing a deleted entry
-                // Compiler optimizations may otherwise result in undefined behavior
-                available_options.erase(it++);
-                consumed += consumption;
-                parsed_something = true;
-            } else {
-                it++;
-            }
-        }
-    } while (parsed_something);
-
-    return consumed;
-}
-
-} // namespace
+#include "ahoy/internal/grammar.h"
+
+// Defines the BuildFormalNamedParameter declared by _AHOY_PARSER_BUILD_FORMAL_PARAMETER for
+// OptionClass, which passes the option's value to |formal_parameter_value| of the FormalParameter
+#define _AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(OptionClass, formal_parameter_value) \
+    void Parameter::BuildFormalNamedParameter(internal::FormalParameter* fp, \
+                                              const OptionClass& option_value) { \
+        fp->formal_parameter_value(option_value.get()); \
+    }
 
 namespace ahoy {
 
+Parameter::Parameter(void* const storage, const internal::Type type, const bool repeated) :
+        storage_(storage), fp_(), current_options_(), next_options_() {
+    fp_.type(type);
+    fp_.repeated(repeated);
+}
+
 Parameter::~Parameter() {}
 
 Parameter& Parameter::withOptions(const std::vector<Parameter>& parameters) {
@@ -50,92 +34,17 @@ Parameter& Parameter::then(const std::vector<Parameter>& parameters) {
     return *this;
 }
 
-internal::size_t Parameter::consume(const std::vector<std::string>& args, internal::size_t start)
-        const {
-    if (!is_valid()) {
-        return -1;
-    };
-
-    const internal::size_t args_available = args.size() - start;
-
-    if (args_available <= 0) {
-        return -1;
-    }
-
-    internal::size_t consumed = 0;
-
-    // This whole section is where this instance consumes the arguments passed in
-    if (fp_.is_positional()) {
-        if (fp_.flag()) {
-            if (!Assign(storage_, fp_.type(), true)) {
-                return -1;
-            }
-        } else {
-            if (!Assign(storage_, fp_.type(), args[start])) {
-                return -1;
-            }
-        }
-        consumed = 1;
-    } else {
-        const std::string& arg = args[start];
-
-        const std::set<std::string>& forms = fp_.forms();
-        if (forms.count(arg)) {
-            if (fp_.flag()) {
-                if (!Assign(storage_, fp_.type(), true)) {
-                    return -1;
-                }
-                consumed = 1;
-            } else if (args_available >= 2) {
-                if (!Assign(storage_, fp_.type(), args[start + 1])) {
-                    return -1;
-                }
-                consumed = 2;
-            }
-        } else if (!fp_.flag()) {
-            for (const std::string& form : forms) {
-                if (arg.find(form + "=") == 0) {
-                    if (!Assign(storage_, fp_.type(), arg.substr(form.size() + 1))) {
-                        return -1;
-                    }
-                    consumed = 1;
-                    break;
-                }
-            }
-        }
-    }
-
-    // Convert to a set
-    std::set<const Parameter*> available_options;
-    for (const Parameter& parameter : current_options_) {
-        available_options.emplace(&parameter);
-    }
-
-    // Try options
-    consumed = try_options(args, available_options, start, consumed);
-
-    // Find at most one next that works
-    for (const Parameter& parameter : next_options_) {
-        internal::size_t consumption = parameter.consume(args, start + consumed);
-        if (consumption <= 0) {
-            if (parameter.fp_.required()) {
-                return -1;
-            }
-        } else {
-            consumed += consumption;
-            break;
-        }
-    }
-
-    consumed = try_options(args, available_options, start, consumed);
+internal::size_t Parameter::consume(const std::vector<std::string>& args, internal::size_t start,
+                                    internal::ParseState* state) const {
+    return internal::Grammar(*this).consume(args, start, storage_, state);
+}
 
-    for (Parameter const * const parameter : available_options) {
-        if (parameter->fp_.required()) {
-            return -1;
-        }
-    }
+void Parameter::reserve(const std::vector<std::string>& args) const {
+    internal::Grammar(*this).reserve(args, storage_);
+}
 
-    return consumed;
+bool Parameter::repeats() const {
+    return fp_.repeated() || fp_.count();
 }
 
 const std::vector<Parameter>& Parameter::current_options() const {
@@ -157,21 +66,22 @@ bool Parameter::operator !=(const Parameter& other) const {
     return !(*this == other);
 }
 
-// Currently just validates that next_options_ only contains at most one ahoy::Required()
-bool Parameter::is_valid() const {
-    bool found_required = false;
-    for (const ahoy::Parameter& parameter : next_options_) {
-        if (parameter.fp_.required()) {
-            if (found_required) {
-                return false;
-            } else {
-                found_required = true;
-            }
-        }
-    }
-    return true;
-}
-
-void Parameter::BuildFormalNamedParameter(internal::FormalParameter*) {}
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Forms, forms)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::LongForms, long_forms)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::ShortForms, short_forms)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Name, name)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Description, description)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Required, required)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Flag, flag)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::ByteSize, byte_size)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::ValidateUtf8, validate_utf8)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Choices, choices)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::CaseInsensitive, case_insensitive)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Count, count)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::EnvVar, env_var)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::OnDuplicateKey, duplicate_key_policy)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::BorrowArgv, borrow_argv)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Path, path_kind)
+_AHOY_PARAMETER_DEFINE_BUILD_FORMAL_PARAMETER(ahoy::Variadic, variadic)
 
 } // namespace ahoy
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/parse_result.h"
+
+namespace ahoy {
+
+std::ostream& operator<<(std::ostream& os, const ParseError& error) {
+    switch (error) {
+        case ParseError::NONE:
+            return os << "None";
+        case ParseError::INVALID_ARGUMENTS:
+            return os << "Invalid Arguments";
+        case ParseError::UNMATCHED_ARGUMENT:
+            return os << "Unmatched Argument";
+        case ParseError::STEP_BUDGET_EXCEEDED:
+            return os << "Step Budget Exceeded";
+        case ParseError::DEADLINE_EXCEEDED:
+            return os << "Deadline Exceeded";
+        case ParseError::CANCELLED:
+            return os << "Cancelled";
+        case ParseError::CONSTRAINT_VIOLATION:
+            return os << "Constraint Violation";
+        case ParseError::INVALID_PATH:
+            return os << "Invalid Path";
+        default:
+            return os << "Unknown";
+    }
+}
+
+ParseResult::ParseResult() :
+        error_(ParseError::NONE),
+        steps_(0),
+        unmatched_(),
+        suggestions_(),
+        violation_(),
+        path_failures_() {}
+
+ParseResult::~ParseResult() {}
+
+bool ParseResult::success() const {
+    return error_ == ParseError::NONE;
+}
+
+ParseError ParseResult::error() const {
+    return error_;
+}
+
+void ParseResult::error(const ParseError error) {
+    error_ = error;
+}
+
+unsigned long long ParseResult::steps() const {
+    return steps_;
+}
+
+void ParseResult::steps(const unsigned long long steps) {
+    steps_ = steps;
+}
+
+const std::string& ParseResult::unmatched() const {
+    return unmatched_;
+}
+
+void ParseResult::unmatched(const std::string& unmatched) {
+    unmatched_ = unmatched;
+}
+
+const std::vector<std::string>& ParseResult::suggestions() const {
+    return suggestions_;
+}
+
+void ParseResult::suggestions(const std::vector<std::string>& suggestions) {
+    suggestions_ = suggestions;
+}
+
+const std::string& ParseResult::violation() const {
+    return violation_;
+}
+
+void ParseResult::violation(const std::string& violation) {
+    violation_ = violation;
+}
+
+const std::vector<PathFailure>& ParseResult::path_failures() const {
+    return path_failures_;
+}
+
+void ParseResult::path_failures(const std::vector<PathFailure>& path_failures) {
+    path_failures_ = path_failures;
+}
+
+} // namespace ahoy
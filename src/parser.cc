@@ -3,25 +3,205 @@
 
 #include "ahoy/parser.h"
 
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <utility>
 #include <vector>
 
+#include "ahoy/internal/path_check.h"
+
+// The environment of the process, as declared by POSIX
+extern char** environ;
+
+namespace {
+
+// The most forms suggested for an unmatched argument
+const std::size_t kMaxSuggestions = 3;
+
+// The threads checking paths unless set by withPathCheckThreads
+const std::size_t kDefaultPathCheckThreads = 4;
+
+// Separates the arguments to parse from those passed through
+const char kPassthroughSeparator[] = "--";
+
+// The first word of a profile saved by Parser::Profile
+const char kProfileMagic[] = "ahoy-profile";
+
+} // namespace
+
 namespace ahoy {
 
-Parser::Parser() : current_options_(), next_options_() {}
+Parser::Parser() :
+        current_options_(),
+        next_options_(),
+        grammar_(),
+        constraints_(),
+        constraint_set_(),
+        step_budget_(0),
+        timeout_(std::chrono::nanoseconds::zero()),
+        cancelled_(nullptr),
+        environment_(nullptr),
+        rest_(nullptr),
+        path_check_threads_(kDefaultPathCheckThreads),
+        parse_cache_(),
+        hit_counters_() {
+    rebuild();
+}
 
 Parser::~Parser() {}
 
 Parser& Parser::withOptions(const std::vector<Parameter>& paramters) {
     current_options_ = paramters;
+    rebuild();
     return *this;
 }
 
 Parser& Parser::then(const std::vector<Parameter>& paramters) {
     next_options_ = paramters;
+    rebuild();
+    return *this;
+}
+
+Parser& Parser::withConstraints(const std::vector<Constraint>& constraints) {
+    constraints_ = constraints;
+    constraint_set_ = internal::ConstraintSet(constraints_, grammar_);
+    parse_cache_.clear();
+    return *this;
+}
+
+Parser& Parser::withPathCheckThreads(const std::size_t threads) {
+    path_check_threads_ = threads;
+    return *this;
+}
+
+Parser& Parser::withParseCache(const std::size_t capacity) {
+    parse_cache_ = internal::ParseCache(capacity);
+    return *this;
+}
+
+unsigned long long Parser::cache_hits() const {
+    return parse_cache_.hits();
+}
+
+unsigned long long Parser::cache_misses() const {
+    return parse_cache_.misses();
+}
+
+Parser& Parser::withHitCounters(const bool enabled) {
+    hit_counters_ = internal::HitCounters(enabled ? grammar_.size() : 0);
+    return *this;
+}
+
+Parser& Parser::Reorder() {
+    grammar_.reorder(hit_counters_.counts());
+    return *this;
+}
+
+std::string Parser::Profile() const {
+    std::ostringstream profile;
+    profile << kProfileMagic << ' ' << std::hex << grammar_.fingerprint() << std::dec << '\n';
+    for (std::size_t node = 0; node < hit_counters_.size(); node++) {
+        const unsigned long long hits = hit_counters_.hits(node);
+        if (hits > 0) {
+            profile << node << ' ' << hits << '\n';
+        }
+    }
+    return profile.str();
+}
+
+bool Parser::LoadProfile(const std::string& profile) {
+    std::istringstream in(profile);
+    std::string magic;
+    std::uint64_t fingerprint = 0;
+    if (!(in >> magic >> std::hex >> fingerprint >> std::dec) || magic != kProfileMagic ||
+            fingerprint != grammar_.fingerprint()) {
+        return false;
+    }
+
+    std::vector<unsigned long long> hits(grammar_.size(), 0);
+    std::size_t node = 0;
+    unsigned long long count = 0;
+    while (in >> node >> count) {
+        if (node >= hits.size()) {
+            return false;
+        }
+        hits[node] = count;
+    }
+    if (!in.eof()) {
+        return false;
+    }
+    grammar_.reorder(hits);
+    return true;
+}
+
+Parser& Parser::withStepBudget(const unsigned long long steps) {
+    step_budget_ = steps;
     return *this;
 }
 
-bool Parser::Parse(const int argc, char const * const argv[], std::string* program_name) const {
+Parser& Parser::withTimeout(const std::chrono::nanoseconds timeout) {
+    timeout_ = timeout;
+    return *this;
+}
+
+Parser& Parser::withCancellation(const std::atomic<bool>* cancelled) {
+    cancelled_ = cancelled;
+    return *this;
+}
+
+Parser& Parser::withEnvironment(const char* const* environment) {
+    environment_ = environment;
+    return *this;
+}
+
+Parser& Parser::withPassthrough(ArgvSpan* rest) {
+    rest_ = rest;
+    return *this;
+}
+
+int Parser::passthrough(const int argc, char const * const argv[]) const {
+    if (rest_ == nullptr) {
+        return argc;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], kPassthroughSeparator) == 0) {
+            return i;
+        }
+    }
+    return argc;
+}
+
+bool Parser::Parse(const int argc, char const * const argv[], std::string* program_name,
+                   ParseResult* result) const {
+    // A constraint naming no parameter, most likely a typo, would hold or fail whatever the
+    // arguments are, so every parse fails before storing anything until it is fixed
+    if (!constraint_set_.unknown().empty()) {
+        if (result != nullptr) {
+            std::ostringstream violation;
+            violation << constraints_[constraint_set_.unknown_constraint()] << ": unknown name "
+                      << constraint_set_.unknown();
+            *result = ParseResult();
+            result->error(ParseError::CONSTRAINT_VIOLATION);
+            result->violation(violation.str());
+        }
+        return false;
+    }
+
+    internal::ParseState state(step_budget_, timeout_, cancelled_);
+    state.argv(argv);
+    const std::vector<const char*> environment =
+            grammar_.environment(environment_ != nullptr ? environment_ : environ);
+    if (!constraint_set_.empty() || grammar_.has_paths()) {
+        state.track(grammar_.size());
+    }
+    if (!environment.empty()) {
+        state.environment(&environment);
+    }
+    if (!hit_counters_.disabled()) {
+        state.counters(&hit_counters_);
+    }
+
     // Alternate holder to store the program name
     std::string* ptr = program_name;
     std::string alternate;
@@ -29,11 +209,130 @@ bool Parser::Parse(const int argc, char const * const argv[], std::string* progr
         ptr = &alternate;
     }
 
-    const std::vector<std::string> args(argv, argv + argc);
-    Parameter root(ptr);
-    root.withOptions(current_options_).then(next_options_);
+    const int end = passthrough(argc, argv);
+    if (rest_ != nullptr) {
+        *rest_ = end < argc ? ArgvSpan(argv + end + 1, argc - end - 1) : ArgvSpan(argv + argc, 0);
+    }
+
+    const bool cacheable = !parse_cache_.disabled() && !grammar_.has_paths();
+    std::string key;
+    internal::StoreLog log;
+    if (cacheable) {
+        key = internal::ParseCache::Key(end, argv, environment);
+        const std::shared_ptr<const internal::StoreLog> cached = parse_cache_.find(key);
+        if (cached != nullptr) {
+            const bool replayed = grammar_.replay(*cached, ptr, &state);
+            if (result != nullptr) {
+                *result = ParseResult();
+                result->error(replayed ? ParseError::NONE : ParseError::INVALID_ARGUMENTS);
+            }
+            return replayed;
+        }
+        state.log(&log);
+    }
+
+    const std::vector<std::string> args(argv, argv + end);
+    grammar_.reserve(args, ptr);
+
+    const bool matched =
+            grammar_.consume(args, 0, ptr, &state) == static_cast<internal::size_t>(args.size());
+    const std::size_t violated =
+            matched ? constraint_set_.check(state) : internal::ConstraintSet::kSatisfied;
+    const bool satisfied = matched && violated == internal::ConstraintSet::kSatisfied;
+
+    // Checked together after parsing rather than as each value is assigned, so the checks can run
+    // concurrently and every bad path is reported, not just the first
+    std::vector<PathFailure> path_failures;
+    if (satisfied && !state.aborted() && grammar_.has_paths()) {
+        const std::vector<internal::PathRequest> requests = grammar_.paths(state);
+        const std::vector<std::string> reasons =
+                internal::CheckPaths(requests, path_check_threads_);
+        for (std::size_t i = 0; i < requests.size(); i++) {
+            if (!reasons[i].empty()) {
+                path_failures.emplace_back(grammar_.name(requests[i].node), requests[i].path,
+                                           requests[i].kind, reasons[i]);
+            }
+        }
+    }
+    const bool success = satisfied && path_failures.empty();
+    if (cacheable && success && !state.aborted()) {
+        parse_cache_.insert(key, std::make_shared<const internal::StoreLog>(std::move(log)));
+    }
+
+    if (result != nullptr) {
+        result->steps(state.steps());
+        result->unmatched(std::string());
+        result->suggestions({});
+        result->violation(std::string());
+        result->path_failures(path_failures);
+        if (state.aborted()) {
+            result->error(state.error());
+        } else if (success) {
+            result->error(ParseError::NONE);
+        } else if (satisfied) {
+            result->error(ParseError::INVALID_PATH);
+        } else if (matched) {
+            std::ostringstream violation;
+            violation << constraints_[violated];
+            result->error(ParseError::CONSTRAINT_VIOLATION);
+            result->violation(violation.str());
+        } else if (state.reached() < args.size()) {
+            // Only worked out when asked for as it is not needed to tell if parsing failed
+            const std::string& unmatched = args[state.reached()];
+            result->error(ParseError::UNMATCHED_ARGUMENT);
+            result->unmatched(unmatched);
+            result->suggestions(grammar_.suggest(unmatched, kMaxSuggestions));
+        } else {
+            result->error(ParseError::INVALID_ARGUMENTS);
+        }
+    }
+
+    return success && !state.aborted();
+}
+
+std::vector<Completion> Parser::Complete(const int argc, char const * const argv[],
+                                         const int cursor) const {
+    // Nothing after "--" is parsed, so there is nothing to complete there
+    const int end = passthrough(argc, argv);
+    if (cursor > end) {
+        return {};
+    }
+
+    internal::ParseState state(step_budget_, timeout_, cancelled_);
+    const std::vector<std::string> args(argv, argv + (cursor == end && end < argc ? end + 1 : end));
+    return grammar_.complete(args, cursor < 0 ? 0 : static_cast<std::size_t>(cursor), &state);
+}
+
+std::size_t Parser::memory_footprint() const {
+    return grammar_.memory_footprint();
+}
+
+std::string Parser::Snapshot() const {
+    return grammar_.snapshot();
+}
+
+bool Parser::LoadSnapshot(const void* const data, const std::size_t size) {
+    if (!grammar_.load(data, size)) {
+        return false;
+    }
+    current_options_.clear();
+    next_options_.clear();
+    constraint_set_ = internal::ConstraintSet(constraints_, grammar_);
+    parse_cache_.clear();
+    withHitCounters(!hit_counters_.disabled());
+    return true;
+}
+
+std::uint64_t Parser::fingerprint() const {
+    return grammar_.fingerprint();
+}
 
-    return root.consume(args) == static_cast<internal::size_t>(args.size());
+void Parser::rebuild() {
+    // The root holds the program name, which Parse redirects to the holder it is called with
+    grammar_ = internal::Grammar(current_options_, next_options_);
+    constraint_set_ = internal::ConstraintSet(constraints_, grammar_);
+    parse_cache_.clear();
+    withHitCounters(!hit_counters_.disabled());
 }
 
 const std::vector<Parameter>& Parser::current_options() const {
@@ -0,0 +1,62 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/path.h"
+
+namespace ahoy {
+
+std::ostream& operator<<(std::ostream& os, const PathKind& kind) {
+    switch (kind) {
+        case PathKind::ANY:
+            return os << "Any";
+        case PathKind::EXISTING_FILE:
+            return os << "Existing File";
+        case PathKind::EXISTING_DIRECTORY:
+            return os << "Existing Directory";
+        case PathKind::CREATABLE:
+            return os << "Creatable";
+        default:
+            return os << "Unknown";
+    }
+}
+
+PathFailure::PathFailure(const std::string& name,
+                         const std::string& path,
+                         const PathKind kind,
+                         const std::string& reason) :
+        name_(name), path_(path), kind_(kind), reason_(reason) {}
+
+PathFailure::~PathFailure() {}
+
+const std::string& PathFailure::name() const {
+    return name_;
+}
+
+const std::string& PathFailure::path() const {
+    return path_;
+}
+
+PathKind PathFailure::kind() const {
+    return kind_;
+}
+
+const std::string& PathFailure::reason() const {
+    return reason_;
+}
+
+bool PathFailure::operator ==(const PathFailure& other) const {
+    return name_ == other.name_ &&
+            path_ == other.path_ &&
+            kind_ == other.kind_ &&
+            reason_ == other.reason_;
+}
+
+bool PathFailure::operator !=(const PathFailure& other) const {
+    return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& os, const PathFailure& failure) {
+    return os << failure.name() << ": " << failure.path() << " " << failure.reason();
+}
+
+} // namespace ahoy
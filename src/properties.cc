@@ -0,0 +1,277 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/properties.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "ahoy/internal/hash.h"
+
+namespace ahoy {
+
+namespace {
+
+// Copied strings are packed into blocks of at least this many bytes
+const std::size_t kBlockSize = 4096;
+
+// The smallest table allocated, in slots
+const std::size_t kMinCapacity = 16;
+
+// The table grows once more than 3/4 of its slots would be full
+bool Overloaded(const std::size_t entries, const std::size_t capacity) {
+    return entries * 4 > capacity * 3;
+}
+
+std::uint32_t Hash(const char* const key, const std::size_t key_size) {
+    return static_cast<std::uint32_t>(internal::HashBytes(key, key_size));
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, const DuplicateKeyPolicy& policy) {
+    switch (policy) {
+        case DuplicateKeyPolicy::LAST_WINS:
+            return os << "Last Wins";
+        case DuplicateKeyPolicy::FIRST_WINS:
+            return os << "First Wins";
+        case DuplicateKeyPolicy::REJECT:
+            return os << "Reject";
+        default:
+            return os << "Unknown";
+    }
+}
+
+std::string Properties::Entry::key_str() const {
+    return std::string(key, key_size);
+}
+
+std::string Properties::Entry::value_str() const {
+    return std::string(value, value_size);
+}
+
+Properties::Properties() : entries_(), slots_(), blocks_(), free_(nullptr), free_size_(0) {}
+
+Properties::~Properties() {}
+
+Properties::Properties(const Properties& other) : Properties() {
+    reserve(other.size());
+    for (const Entry& entry : other) {
+        insert(entry.key, entry.key_size, entry.value, entry.value_size);
+    }
+}
+
+Properties& Properties::operator=(const Properties& other) {
+    if (this != &other) {
+        Properties copied(other);
+        *this = std::move(copied);
+    }
+    return *this;
+}
+
+bool Properties::insert(const char* const key, const std::size_t key_size,
+                        const char* const value, const std::size_t value_size,
+                        const DuplicateKeyPolicy policy) {
+    // Copying the key is wasted if it is already present
+    if (!slots_.empty()) {
+        const Slot& slot = slots_[probe(key, key_size, Hash(key, key_size))];
+        if (slot.entry != 0) {
+            if (policy != DuplicateKeyPolicy::LAST_WINS) {
+                return policy == DuplicateKeyPolicy::FIRST_WINS;
+            }
+            Entry& entry = entries_[slot.entry - 1];
+            entry.value = copy(value, value_size);
+            entry.value_size = value_size;
+            return true;
+        }
+    }
+    return put(copy(key, key_size), key_size, copy(value, value_size), value_size, policy);
+}
+
+bool Properties::insert(const std::string& key, const std::string& value,
+                        const DuplicateKeyPolicy policy) {
+    return insert(key.data(), key.size(), value.data(), value.size(), policy);
+}
+
+bool Properties::borrow(const char* const key, const std::size_t key_size,
+                        const char* const value, const std::size_t value_size,
+                        const DuplicateKeyPolicy policy) {
+    return put(key, key_size, value, value_size, policy);
+}
+
+const char* Properties::find(const std::string& key) const {
+    if (slots_.empty()) {
+        return nullptr;
+    }
+    const Slot& slot = slots_[probe(key.data(), key.size(), Hash(key.data(), key.size()))];
+    return slot.entry == 0 ? nullptr : entries_[slot.entry - 1].value;
+}
+
+bool Properties::contains(const std::string& key) const {
+    return find(key) != nullptr;
+}
+
+std::string Properties::get(const std::string& key, const std::string& fallback) const {
+    if (slots_.empty()) {
+        return fallback;
+    }
+    const Slot& slot = slots_[probe(key.data(), key.size(), Hash(key.data(), key.size()))];
+    return slot.entry == 0 ? fallback : entries_[slot.entry - 1].value_str();
+}
+
+std::size_t Properties::size() const {
+    return entries_.size();
+}
+
+bool Properties::empty() const {
+    return entries_.empty();
+}
+
+void Properties::reserve(const std::size_t count) {
+    entries_.reserve(count);
+    std::size_t capacity = std::max(slots_.size(), kMinCapacity);
+    while (Overloaded(count, capacity)) {
+        capacity *= 2;
+    }
+    if (capacity != slots_.size()) {
+        rehash(capacity);
+    }
+}
+
+void Properties::clear() {
+    entries_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot{ 0, 0 });
+    blocks_.clear();
+    free_ = nullptr;
+    free_size_ = 0;
+}
+
+const Properties::Entry* Properties::begin() const {
+    return entries_.data();
+}
+
+const Properties::Entry* Properties::end() const {
+    return entries_.data() + entries_.size();
+}
+
+bool Properties::operator ==(const Properties& other) const {
+    if (size() != other.size()) {
+        return false;
+    }
+    for (const Entry& entry : entries_) {
+        const char* const value = other.find(entry.key_str());
+        if (value == nullptr || std::strcmp(value, entry.value) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Properties::operator !=(const Properties& other) const {
+    return !(*this == other);
+}
+
+bool Properties::put(const char* const key, const std::size_t key_size,
+                     const char* const value, const std::size_t value_size,
+                     const DuplicateKeyPolicy policy) {
+    if (slots_.empty() || Overloaded(entries_.size() + 1, slots_.size())) {
+        reserve(entries_.size() + 1);
+    }
+
+    const std::uint32_t hash = Hash(key, key_size);
+    Slot& slot = slots_[probe(key, key_size, hash)];
+    if (slot.entry != 0) {
+        if (policy != DuplicateKeyPolicy::LAST_WINS) {
+            return policy == DuplicateKeyPolicy::FIRST_WINS;
+        }
+        Entry& entry = entries_[slot.entry - 1];
+        entry.value = value;
+        entry.value_size = value_size;
+        return true;
+    }
+
+    entries_.push_back(Entry{ key, key_size, value, value_size });
+    slot.entry = static_cast<std::uint32_t>(entries_.size());
+    slot.hash = hash;
+    return true;
+}
+
+std::size_t Properties::probe(const char* const key, const std::size_t key_size,
+                              const std::uint32_t hash) const {
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (slot.entry == 0) {
+            return i;
+        }
+        const Entry& entry = entries_[slot.entry - 1];
+        if (slot.hash == hash && entry.key_size == key_size &&
+                std::memcmp(entry.key, key, key_size) == 0) {
+            return i;
+        }
+    }
+}
+
+void Properties::rehash(const std::size_t capacity) {
+    std::vector<Slot> old(capacity, Slot{ 0, 0 });
+    slots_.swap(old);
+
+    const std::size_t mask = capacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.entry == 0) {
+            continue;
+        }
+        std::size_t i = slot.hash & mask;
+        while (slots_[i].entry != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = slot;
+    }
+}
+
+std::size_t Properties::index(const char* const key, const std::size_t key_size) const {
+    if (slots_.empty()) {
+        return entries_.size();
+    }
+    const Slot& slot = slots_[probe(key, key_size, Hash(key, key_size))];
+    return slot.entry == 0 ? entries_.size() : slot.entry - 1;
+}
+
+void Properties::truncate(const std::size_t size) {
+    if (size >= entries_.size()) {
+        return;
+    }
+    entries_.resize(size);
+    for (Slot& slot : slots_) {
+        if (slot.entry > size) {
+            slot = Slot{ 0, 0 };
+        }
+    }
+    // Emptied slots may break the probe sequences of the keys after them
+    rehash(slots_.size());
+}
+
+void Properties::restore(const std::size_t index, const char* const value,
+                         const std::size_t value_size) {
+    entries_[index].value = value;
+    entries_[index].value_size = value_size;
+}
+
+const char* Properties::copy(const char* const data, const std::size_t size) {
+    if (size + 1 > free_size_) {
+        const std::size_t block_size = std::max(kBlockSize, size + 1);
+        blocks_.emplace_back(new char[block_size]);
+        free_ = blocks_.back().get();
+        free_size_ = block_size;
+    }
+
+    char* const copied = free_;
+    std::memcpy(copied, data, size);
+    copied[size] = '\0';
+    free_ += size + 1;
+    free_size_ -= size + 1;
+    return copied;
+}
+
+} // namespace ahoy
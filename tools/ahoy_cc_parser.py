@@ -0,0 +1,438 @@
+# Copyright (c) 2018 Dustin Toff
+# Licensed under Apache License v2.0
+
+"""Generates a C++ parser from a schema of flat parameters.
+
+See parser.bzl for the schema format. This is run by the ahoy_cc_parser rule and is not meant to be
+run directly, though it may be when debugging a schema:
+
+    python tools/ahoy_cc_parser.py --schema flags.json --header flags.h --source flags.cc \\
+        --include flags.h
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# Schema type -> (C++ type, assign function)
+TYPES = {
+    'bool': ('bool', 'AssignBool'),
+    'char': ('char', 'AssignChar'),
+    'unsigned char': ('unsigned char', 'AssignUChar'),
+    'short': ('short', 'AssignShort'),
+    'unsigned short': ('unsigned short', 'AssignUShort'),
+    'int': ('int', 'AssignInt'),
+    'unsigned int': ('unsigned int', 'AssignUInt'),
+    'long': ('long', 'AssignLong'),
+    'unsigned long': ('unsigned long', 'AssignULong'),
+    'long long': ('long long', 'AssignLongLong'),
+    'unsigned long long': ('unsigned long long', 'AssignULongLong'),
+    'float': ('float', 'AssignFloat'),
+    'double': ('double', 'AssignDouble'),
+    'long double': ('long double', 'AssignLongDouble'),
+    'string': ('std::string', 'AssignString'),
+    'bytes': ('std::uint64_t', 'AssignBytes'),
+    'nanoseconds': ('std::chrono::nanoseconds', 'AssignNanoseconds'),
+    'microseconds': ('std::chrono::microseconds', 'AssignMicroseconds'),
+    'milliseconds': ('std::chrono::milliseconds', 'AssignMilliseconds'),
+    'seconds': ('std::chrono::seconds', 'AssignSeconds'),
+    'minutes': ('std::chrono::minutes', 'AssignMinutes'),
+    'hours': ('std::chrono::hours', 'AssignHours'),
+}
+
+INTEGER_TYPES = {
+    'short', 'unsigned short', 'int', 'unsigned int', 'long', 'unsigned long', 'long long',
+    'unsigned long long', 'bytes',
+}
+FLOATING_TYPES = {'float', 'double', 'long double'}
+DURATION_TYPES = {'nanoseconds', 'microseconds', 'milliseconds', 'seconds', 'minutes', 'hours'}
+
+IDENTIFIER = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+QUALIFIED_IDENTIFIER = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*(::[A-Za-z_][A-Za-z0-9_]*)*$')
+PARAMETER_KEYS = {
+    'name', 'type', 'short_forms', 'long_forms', 'default', 'description', 'required', 'flag',
+    'repeated',
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+def cpp_string(value):
+    """Quotes |value| as a C++ string literal."""
+    out = []
+    for byte in value.encode('utf-8'):
+        c = chr(byte)
+        if c in '"\\?':
+            out.append('\\' + c)
+        elif 0x20 <= byte < 0x7f:
+            out.append(c)
+        else:
+            # Octal escapes end after three digits, unlike hex escapes
+            out.append('\\%03o' % byte)
+    return '"' + ''.join(out) + '"'
+
+
+def default_initializer(parameter):
+    """The C++ initializer for the default value of |parameter|."""
+    name = parameter['name']
+    kind = parameter['type']
+    if 'default' not in parameter:
+        return '{}'
+    value = parameter['default']
+    if kind == 'bool':
+        if not isinstance(value, bool):
+            raise SchemaError('Default of %s must be true or false' % name)
+        return 'true' if value else 'false'
+    if kind in ('char', 'unsigned char'):
+        if not isinstance(value, str) or len(value.encode('utf-8')) != 1:
+            raise SchemaError('Default of %s must be a single character' % name)
+        return "'%s'" % cpp_string(value)[1:-1].replace("'", "\\'")
+    if kind == 'string':
+        if not isinstance(value, str):
+            raise SchemaError('Default of %s must be a string' % name)
+        return cpp_string(value)
+    if isinstance(value, bool) or not isinstance(value, (int, float)):
+        raise SchemaError('Default of %s must be a number' % name)
+    if kind in FLOATING_TYPES:
+        return repr(float(value))
+    if not isinstance(value, int):
+        raise SchemaError('Default of %s must be an integer' % name)
+    if value < 0 and (kind.startswith('unsigned') or kind == 'bytes'):
+        raise SchemaError('Default of %s must not be negative' % name)
+    if kind in DURATION_TYPES:
+        return '%s(%d)' % (TYPES[kind][0], value)
+    return '%d' % value
+
+
+def validate(schema):
+    """Checks |schema| and returns its parameters with defaults filled in."""
+    for key in ('namespace', 'config', 'function'):
+        if key in schema and not QUALIFIED_IDENTIFIER.match(schema[key]):
+            raise SchemaError('"%s" must be a C++ identifier' % key)
+    if not IDENTIFIER.match(schema.get('config', 'Config')):
+        raise SchemaError('"config" must be an unqualified C++ identifier')
+    if not IDENTIFIER.match(schema.get('function', 'Parse')):
+        raise SchemaError('"function" must be an unqualified C++ identifier')
+
+    parameters = schema.get('parameters')
+    if not isinstance(parameters, list) or not parameters:
+        raise SchemaError('"parameters" must be a non-empty list')
+
+    names = set()
+    forms = set()
+    repeated_positional = False
+    for parameter in parameters:
+        unknown = set(parameter) - PARAMETER_KEYS
+        if unknown:
+            raise SchemaError('Unknown keys: %s' % ', '.join(sorted(unknown)))
+        name = parameter.get('name')
+        if not isinstance(name, str) or not IDENTIFIER.match(name):
+            raise SchemaError('Parameter name %r must be a C++ identifier' % name)
+        if name in names:
+            raise SchemaError('Duplicate parameter %s' % name)
+        names.add(name)
+        if parameter.get('type') not in TYPES:
+            raise SchemaError('Parameter %s has unknown type %r' % (name, parameter.get('type')))
+
+        parameter.setdefault('short_forms', [])
+        parameter.setdefault('long_forms', [])
+        parameter.setdefault('description', '')
+        parameter.setdefault('required', False)
+        parameter.setdefault('flag', False)
+        parameter.setdefault('repeated', False)
+
+        parameter['forms'] = (['-' + form for form in parameter['short_forms']] +
+                              ['--' + form for form in parameter['long_forms']])
+        for form in parameter['forms']:
+            if form in ('-', '--') or '=' in form:
+                raise SchemaError('Parameter %s has invalid form %r' % (name, form))
+            if form in forms:
+                raise SchemaError('Duplicate form %s' % form)
+            forms.add(form)
+
+        if parameter['flag'] and parameter['type'] != 'bool':
+            raise SchemaError('Flag %s must be a bool' % name)
+        if parameter['flag'] and not parameter['forms']:
+            raise SchemaError('Flag %s must have a form' % name)
+        if parameter['flag'] and parameter['repeated']:
+            raise SchemaError('Flag %s may not be repeated' % name)
+        if parameter['repeated'] and 'default' in parameter:
+            raise SchemaError('Repeated parameter %s may not have a default' % name)
+        if not parameter['forms']:
+            if repeated_positional:
+                raise SchemaError('Positional %s follows a repeated positional' % name)
+            repeated_positional = parameter['repeated']
+        parameter['initializer'] = default_initializer(parameter)
+
+    if len(parameters) > 0xffff:
+        raise SchemaError('Too many parameters')
+    return parameters
+
+
+def guard(include):
+    return 'AHOY_GENERATED_' + re.sub(r'[^A-Za-z0-9]', '_', include).upper()
+
+
+def open_namespace(namespace):
+    return ''.join('namespace %s {\n' % part for part in namespace.split('::')) if namespace else ''
+
+
+def close_namespace(namespace):
+    if not namespace:
+        return ''
+    return ''.join('} // namespace %s\n' % part for part in reversed(namespace.split('::')))
+
+
+def comment(text, indent):
+    """Wraps |text| as // comment lines."""
+    lines = []
+    line = ''
+    for word in text.split():
+        if line and len(indent) + 3 + len(line) + 1 + len(word) > 100:
+            lines.append(line)
+            line = word
+        else:
+            line = line + ' ' + word if line else word
+    if line:
+        lines.append(line)
+    return ''.join('%s// %s\n' % (indent, line) for line in lines)
+
+
+def generate_header(schema, parameters, source, include):
+    namespace = schema.get('namespace', '')
+    config = schema.get('config', 'Config')
+    function = schema.get('function', 'Parse')
+
+    fields = []
+    for parameter in parameters:
+        cpp_type = TYPES[parameter['type']][0]
+        if parameter['repeated']:
+            cpp_type = 'std::vector<%s>' % cpp_type
+        fields.append(comment(parameter['description'], '    '))
+        fields.append('    %s %s = %s;\n' % (cpp_type, parameter['name'], parameter['initializer']))
+
+    return '''// Generated by ahoy_cc_parser from {source}. Do not edit.
+
+#ifndef {guard}
+#define {guard}
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ahoy/parse_result.h"
+
+{open_namespace}
+// The values of the parameters, initialized to their defaults
+struct {config} {{
+{fields}}};
+
+// Parses the arguments from the main() function into |config|, returning false if they do not
+// match the schema. Forms may be followed by their value or joined to it with '=' and arguments
+// that match no form fill the positional parameters in order. If |result| is set, it is filled in
+// with the details of the parse.
+bool {function}(const int argc, char const * const argv[], {config}* config,
+        std::string* program_name = nullptr, ahoy::ParseResult* result = nullptr);
+
+{close_namespace}
+#endif // {guard}
+'''.format(source=source, guard=guard(include), open_namespace=open_namespace(namespace),
+           config=config, fields=''.join(fields), function=function,
+           close_namespace=close_namespace(namespace))
+
+
+def generate_source(schema, parameters, source, include):
+    namespace = schema.get('namespace', '')
+    config = schema.get('config', 'Config')
+    function = schema.get('function', 'Parse')
+
+    forms = []
+    for index, parameter in enumerate(parameters):
+        for form in parameter['forms']:
+            forms.append((form.encode('utf-8'), index))
+    forms.sort()
+    if forms:
+        form_table = ''.join('    {{ {}, {}, {} }},\n'.format(
+                cpp_string(form.decode('utf-8')), len(form), index) for form, index in forms)
+        form_end = 'kForms + %d' % len(forms)
+    else:
+        # Arrays may not be empty
+        form_table = '    { "", 0, 0 },\n'
+        form_end = 'kForms'
+
+    positionals = [index for index, parameter in enumerate(parameters) if not parameter['forms']]
+    positional_table = ''.join('    %d,\n' % index for index in positionals) or '    0,\n'
+
+    def attributes(parameter):
+        bits = [name for name, key in (('kFlag', 'flag'), ('kRequired', 'required'),
+                                       ('kRepeated', 'repeated')) if parameter[key]]
+        return ' | '.join(bits) or '0'
+
+    attribute_table = ''.join('    %s, // %s\n' % (attributes(parameter), parameter['name'])
+                              for parameter in parameters)
+
+    cases = []
+    for index, parameter in enumerate(parameters):
+        assign = TYPES[parameter['type']][1]
+        field = 'config->' + parameter['name']
+        if parameter['flag']:
+            body = '            return ahoy::internal::%s(&%s, true);\n' % (assign, field)
+        elif parameter['repeated']:
+            body = ('            {field}.emplace_back();\n'
+                    '            if (!ahoy::internal::{assign}(&{field}.back(), value)) {{\n'
+                    '                {field}.pop_back();\n'
+                    '                return false;\n'
+                    '            }}\n'
+                    '            return true;\n').format(field=field, assign=assign)
+        else:
+            body = '            return ahoy::internal::%s(&%s, value);\n' % (assign, field)
+        cases.append('        case %d:\n%s' % (index, body))
+    # Flags take no value, so it goes unused if every parameter is one
+    takes_values = any(not parameter['flag'] for parameter in parameters)
+    value_name = 'value' if takes_values else '/* value */'
+
+    return '''// Generated by ahoy_cc_parser from {source}. Do not edit.
+
+#include "{include}"
+
+#include <cstring>
+#include <string>
+
+#include "ahoy/internal/assign.h"
+#include "ahoy/internal/form_table.h"
+
+namespace {{
+
+using ahoy::internal::FindForm;
+using ahoy::internal::FormEntry;
+
+const std::uint8_t kFlag = 1 << 0;
+const std::uint8_t kRequired = 1 << 1;
+const std::uint8_t kRepeated = 1 << 2;
+
+const std::size_t kParameterCount = {parameter_count};
+const std::size_t kPositionalCount = {positional_count};
+
+// Every form, sorted for FindForm
+const FormEntry kForms[] = {{
+{form_table}}};
+const FormEntry* const kFormsEnd = {form_end};
+
+// The parameters without forms, in the order they are filled
+const std::uint32_t kPositionals[] = {{
+{positional_table}}};
+
+const std::uint8_t kAttributes[] = {{
+{attribute_table}}};
+
+// Converts |value| and stores it in the field of |parameter|. Flags are set without a value.
+bool Store({qualified_config}* const config, const std::uint32_t parameter,
+           const std::string& {value_name}) {{
+    switch (parameter) {{
+{cases}        default:
+            return false;
+    }}
+}}
+
+}} // namespace
+
+{open_namespace}
+bool {function}(const int argc, char const * const argv[], {config}* const config,
+        std::string* const program_name, ahoy::ParseResult* const result) {{
+    bool seen[kParameterCount] = {{}};
+    std::size_t positional = 0;
+    unsigned long long steps = 0;
+    bool success = argc > 0;
+    for (int i = 1; success && i < argc; i++) {{
+        const char* const arg = argv[i];
+        const std::size_t size = std::strlen(arg);
+        steps++;
+
+        std::uint32_t parameter;
+        std::string value;
+        const FormEntry* form = FindForm(kForms, kFormsEnd, arg, size);
+        const char* const equals = static_cast<const char*>(std::memchr(arg, '=', size));
+        if (form != nullptr) {{
+            parameter = form->parameter;
+            if (!(kAttributes[parameter] & kFlag)) {{
+                if (i + 1 >= argc) {{
+                    success = false;
+                    break;
+                }}
+                value = argv[++i];
+            }}
+        }} else if (equals != nullptr &&
+                (form = FindForm(kForms, kFormsEnd, arg, equals - arg)) != nullptr &&
+                !(kAttributes[form->parameter] & kFlag)) {{
+            parameter = form->parameter;
+            value.assign(equals + 1);
+        }} else if (positional < kPositionalCount) {{
+            parameter = kPositionals[positional];
+            if (!(kAttributes[parameter] & kRepeated)) {{
+                positional++;
+            }}
+            value.assign(arg, size);
+        }} else {{
+            success = false;
+            break;
+        }}
+
+        if (seen[parameter] && !(kAttributes[parameter] & kRepeated)) {{
+            success = false;
+            break;
+        }}
+        seen[parameter] = true;
+        success = Store(config, parameter, value);
+    }}
+
+    for (std::size_t i = 0; success && i < kParameterCount; i++) {{
+        success = seen[i] || !(kAttributes[i] & kRequired);
+    }}
+    if (success && program_name != nullptr) {{
+        program_name->assign(argv[0]);
+    }}
+    if (result != nullptr) {{
+        result->error(success ? ahoy::ParseError::NONE : ahoy::ParseError::INVALID_ARGUMENTS);
+        result->steps(steps);
+    }}
+    return success;
+}}
+
+{close_namespace}'''.format(
+        source=source, include=include, parameter_count=len(parameters),
+        positional_count=len(positionals), form_table=form_table, form_end=form_end,
+        positional_table=positional_table, attribute_table=attribute_table,
+        qualified_config=(namespace + '::' + config) if namespace else config,
+        value_name=value_name, cases=''.join(cases), open_namespace=open_namespace(namespace),
+        function=function, config=config, close_namespace=close_namespace(namespace))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--schema', required=True, help='The JSON schema to read')
+    parser.add_argument('--header', required=True, help='Where to write the header')
+    parser.add_argument('--source', required=True, help='Where to write the source')
+    parser.add_argument('--include', required=True, help='How the source includes the header')
+    args = parser.parse_args()
+
+    with open(args.schema) as f:
+        schema = json.load(f)
+    try:
+        parameters = validate(schema)
+    except SchemaError as e:
+        sys.stderr.write('%s: %s\n' % (args.schema, e))
+        return 1
+
+    with open(args.header, 'w') as f:
+        f.write(generate_header(schema, parameters, args.schema, args.include))
+    with open(args.source, 'w') as f:
+        f.write(generate_source(schema, parameters, args.schema, args.include))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Enforces budgets on the heap allocations made while building grammars, parsing and converting
+// values. If a change reduces allocations, lower the budget to lock in the gain. If a change must
+// add allocations, raise the budget in the same change so the cost is visible in review.
+//
+// The budgets are measured against libstdc++ and may differ slightly for other standard libraries.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ahoy/internal/assign.h"
+#include "ahoy/parser.h"
+#include "tst/allocation/allocation_counter.h"
+
+#include <gtest/gtest.h>
+
+// Checks that |statement| makes at most |budget| allocations, reporting the actual count
+#define EXPECT_ALLOCATIONS_LE(budget, statement) \
+    do { \
+        std::size_t allocations; \
+        { \
+            const ::ahoy::testing::AllocationCounter counter; \
+            statement; \
+            allocations = counter.allocations(); \
+        } \
+        EXPECT_LE(allocations, static_cast<std::size_t>(budget)) << #statement; \
+        ::testing::Test::RecordProperty(#statement, static_cast<int>(allocations)); \
+    } while (false)
+
+namespace {
+
+const char kProgram[] = "./program";
+
+// The grammars measured by these tests. Each one represents a common way to use ahoy.
+struct Values {
+    Values() : verbose(false), help(false), iterations(0), name(), file(), file_type(), ratio(0) {}
+
+    bool verbose;
+    bool help;
+    int iterations;
+    std::string name;
+    std::string file;
+    std::string file_type;
+    double ratio;
+};
+
+// Only flags and valued options, e.g. a typical server binary
+ahoy::Parser FlatGrammar(Values* v) {
+    return ahoy::Parser().withOptions(
+            ahoy::Parameter(&v->verbose, ahoy::ShortForms({"v"}), ahoy::LongForms({"verbose"}),
+                    ahoy::Flag()),
+            ahoy::Parameter(&v->iterations, ahoy::ShortForms({"i"}),
+                    ahoy::LongForms({"iterations"})),
+            ahoy::Parameter(&v->name, ahoy::LongForms({"name"})),
+            ahoy::Parameter(&v->ratio, ahoy::LongForms({"ratio"})));
+}
+
+// Options followed by alternative positional branches, like the example in the README
+ahoy::Parser BranchingGrammar(Values* v) {
+    return ahoy::Parser()
+        .withOptions(
+            ahoy::Parameter(&v->iterations, ahoy::ShortForms({"i"}),
+                    ahoy::LongForms({"iterations"})),
+            ahoy::Parameter(&v->verbose, ahoy::ShortForms({"v"}), ahoy::Flag()))
+        .then(
+            ahoy::Parameter(&v->help, ahoy::LongForms({"help"}), ahoy::Flag()),
+            ahoy::Parameter(&v->file).withOptions(ahoy::Parameter(&v->file_type)));
+}
+
+// Several levels of options, each only valid after its parent
+ahoy::Parser NestedGrammar(Values* v) {
+    return ahoy::Parser().then(
+            ahoy::Parameter(&v->file, ahoy::Required()).withOptions(
+                ahoy::Parameter(&v->name, ahoy::LongForms({"name"})).withOptions(
+                    ahoy::Parameter(&v->ratio, ahoy::LongForms({"ratio"})).withOptions(
+                        ahoy::Parameter(&v->verbose, ahoy::LongForms({"verbose"}),
+                                ahoy::Flag())))));
+}
+
+// Holds the arguments for a call to Parse so building them is not measured
+class Argv {
+  public:
+    // |args| excludes the program name
+    explicit Argv(const std::vector<const char*>& args) : argv_(1, kProgram) {
+        argv_.insert(argv_.end(), args.begin(), args.end());
+    }
+
+    bool parse(const ahoy::Parser& parser) const {
+        return parser.Parse(static_cast<int>(argv_.size()), argv_.data());
+    }
+
+  private:
+    std::vector<const char*> argv_;
+};
+
+} // namespace
+
+namespace ahoy {
+
+TEST(AllocationBudget, Counter) {
+    testing::AllocationCounter outer;
+    {
+        testing::AllocationCounter inner;
+        // Called directly, as a new expression whose result is unused may be elided
+        ::operator delete(::operator new(sizeof(int)));
+        EXPECT_EQ(1u, inner.allocations());
+        EXPECT_EQ(1u, inner.deallocations());
+        EXPECT_EQ(sizeof(int), inner.bytes());
+    }
+    EXPECT_EQ(1u, outer.allocations());
+    EXPECT_EQ(1u, outer.deallocations());
+}
+
+TEST(AllocationBudget, GrammarConstruction) {
+    Values v;
+    EXPECT_ALLOCATIONS_LE(5, Parser());
+    EXPECT_ALLOCATIONS_LE(71, FlatGrammar(&v));
+    EXPECT_ALLOCATIONS_LE(73, BranchingGrammar(&v));
+    EXPECT_ALLOCATIONS_LE(88, NestedGrammar(&v));
+}
+
+TEST(AllocationBudget, Parse) {
+    Values v;
+    const Parser empty;
+    const Parser flat = FlatGrammar(&v);
+    const Parser branching = BranchingGrammar(&v);
+    const Parser nested = NestedGrammar(&v);
+
+    const Argv none({});
+    const Argv flat_args({"-v", "--iterations=3", "--name", "n"});
+    const Argv unknown({"--unknown"});
+    const Argv branching_args({"-i", "3", "file", "png"});
+    const Argv help({"--help"});
+    const Argv nested_args({"file", "--name=n", "--ratio=0.5", "--verbose"});
+
+    EXPECT_ALLOCATIONS_LE(1, EXPECT_TRUE(none.parse(empty)));
+    EXPECT_ALLOCATIONS_LE(2, EXPECT_TRUE(none.parse(flat)));
+    EXPECT_ALLOCATIONS_LE(2, EXPECT_TRUE(flat_args.parse(flat)));
+    EXPECT_ALLOCATIONS_LE(2, EXPECT_FALSE(unknown.parse(flat)));
+    EXPECT_ALLOCATIONS_LE(3, EXPECT_TRUE(branching_args.parse(branching)));
+    EXPECT_ALLOCATIONS_LE(2, EXPECT_TRUE(help.parse(branching)));
+    EXPECT_ALLOCATIONS_LE(4, EXPECT_TRUE(nested_args.parse(nested)));
+    EXPECT_ALLOCATIONS_LE(1, EXPECT_FALSE(none.parse(nested)));
+}
+
+namespace internal {
+
+TEST(AllocationBudget, Assign) {
+    const std::string integer = "1234";
+    const std::string decimal = "1.25";
+    const std::string word = "yes";
+    const std::string size = "4GiB";
+    const std::string duration = "1h30m";
+    const std::string invalid = "invalid";
+
+    bool b;
+    char c;
+    int i;
+    unsigned long ul;
+    long long ll;
+    double d;
+    std::string s;
+    std::uint64_t bytes;
+    std::chrono::milliseconds ms;
+
+    EXPECT_ALLOCATIONS_LE(0, AssignBool(&b, word));
+    EXPECT_ALLOCATIONS_LE(0, AssignChar(&c, std::string(1, 'c')));
+    EXPECT_ALLOCATIONS_LE(0, AssignInt(&i, integer));
+    EXPECT_ALLOCATIONS_LE(0, AssignULong(&ul, integer));
+    EXPECT_ALLOCATIONS_LE(0, AssignLongLong(&ll, integer));
+    EXPECT_ALLOCATIONS_LE(0, AssignDouble(&d, decimal));
+    EXPECT_ALLOCATIONS_LE(0, AssignString(&s, word));
+    EXPECT_ALLOCATIONS_LE(0, AssignBytes(&bytes, size));
+    EXPECT_ALLOCATIONS_LE(0, AssignMilliseconds(&ms, duration));
+
+    // Failed conversions of the standard library's numeric parsers allocate their exceptions
+    EXPECT_ALLOCATIONS_LE(1, AssignInt(&i, invalid));
+    EXPECT_ALLOCATIONS_LE(1, AssignDouble(&d, invalid));
+    EXPECT_ALLOCATIONS_LE(0, AssignBytes(&bytes, invalid));
+    EXPECT_ALLOCATIONS_LE(0, AssignMilliseconds(&ms, invalid));
+}
+
+} // namespace internal
+} // namespace ahoy
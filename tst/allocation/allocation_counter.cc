@@ -0,0 +1,122 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "tst/allocation/allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// The innermost counter of the current thread. Counters nest so a budget can be checked for a
+// sub-step of a larger measured operation.
+thread_local ahoy::testing::AllocationCounter* active_counter = nullptr;
+
+void* allocate(std::size_t size) {
+    ahoy::testing::RecordAllocation(size);
+    void* const pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void deallocate(void* pointer) {
+    if (pointer != nullptr) {
+        ahoy::testing::RecordDeallocation();
+        std::free(pointer);
+    }
+}
+
+} // namespace
+
+namespace ahoy {
+namespace testing {
+
+AllocationCounter::AllocationCounter() :
+        previous_(active_counter), allocations_(0), deallocations_(0), bytes_(0) {
+    active_counter = this;
+}
+
+AllocationCounter::~AllocationCounter() {
+    active_counter = previous_;
+}
+
+std::size_t AllocationCounter::allocations() const {
+    return allocations_;
+}
+
+std::size_t AllocationCounter::deallocations() const {
+    return deallocations_;
+}
+
+std::size_t AllocationCounter::bytes() const {
+    return bytes_;
+}
+
+void RecordAllocation(const std::size_t size) {
+    for (AllocationCounter* counter = active_counter; counter; counter = counter->previous_) {
+        counter->allocations_++;
+        counter->bytes_ += size;
+    }
+}
+
+void RecordDeallocation() {
+    for (AllocationCounter* counter = active_counter; counter; counter = counter->previous_) {
+        counter->deallocations_++;
+    }
+}
+
+} // namespace testing
+} // namespace ahoy
+
+// Replacements for the global allocation functions. The sized and nothrow variants must be
+// replaced as well, otherwise the standard library may route around the counters.
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    deallocate(pointer);
+}
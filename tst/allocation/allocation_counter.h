@@ -0,0 +1,56 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#ifndef AHOY_TST_ALLOCATION_ALLOCATION_COUNTER_H
+#define AHOY_TST_ALLOCATION_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+namespace ahoy {
+namespace testing {
+
+// Counts the calls to the global operator new and operator delete made by the current thread while
+// an instance is alive. This relies on the replacement operators defined in
+// allocation_counter.cc and so may only be linked into binaries dedicated to allocation tests.
+//
+// Example usage:
+// AllocationCounter counter;
+// parser.Parse(argc, argv);
+// EXPECT_LE(counter.allocations(), kParseBudget);
+class AllocationCounter {
+  public:
+    AllocationCounter();
+    virtual ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    // The number of calls to operator new since construction
+    std::size_t allocations() const;
+
+    // The number of calls to operator delete with a non-null pointer since construction
+    std::size_t deallocations() const;
+
+    // The number of bytes requested from operator new since construction
+    std::size_t bytes() const;
+
+  private:
+    AllocationCounter* const previous_;
+    std::size_t allocations_;
+    std::size_t deallocations_;
+    std::size_t bytes_;
+
+    friend void RecordAllocation(std::size_t size);
+    friend void RecordDeallocation();
+};
+
+// Records an allocation of |size| bytes with the innermost active counter, if any
+void RecordAllocation(std::size_t size);
+
+// Records a deallocation with the innermost active counter, if any
+void RecordDeallocation();
+
+} // namespace testing
+} // namespace ahoy
+
+#endif // AHOY_TST_ALLOCATION_ALLOCATION_COUNTER_H
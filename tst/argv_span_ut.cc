@@ -0,0 +1,38 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/argv_span.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+
+TEST(ArgvSpan, Empty) {
+    const ArgvSpan span;
+    EXPECT_TRUE(span.empty());
+    EXPECT_EQ(0u, span.size());
+    EXPECT_EQ(span.begin(), span.end());
+    ASSERT_NE(nullptr, span.argv());
+    EXPECT_EQ(nullptr, span.argv()[0]);
+}
+
+TEST(ArgvSpan, View) {
+    const char* argv[] = { "./wrapper", "--", "child", "-x", nullptr };
+    const ArgvSpan span(argv + 2, 2);
+    EXPECT_FALSE(span.empty());
+    ASSERT_EQ(2u, span.size());
+    EXPECT_EQ(argv[2], span[0]);
+    EXPECT_EQ(argv[3], span[1]);
+    EXPECT_EQ(std::vector<std::string>({ "child", "-x" }),
+              std::vector<std::string>(span.begin(), span.end()));
+
+    // The arguments are not copied and stay null-terminated
+    char* const* const forwarded = span.argv();
+    EXPECT_EQ(argv[2], forwarded[0]);
+    EXPECT_EQ(nullptr, forwarded[2]);
+}
+
+} // namespace ahoy
@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/completion.h"
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Gets the string representation of |value|
+template<typename T>
+std::string ToString(const T& value) {
+    std::stringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(Completion, Get) {
+    const Completion completion(CompletionKind::CHOICE, "--mode=fast", "The mode");
+    EXPECT_EQ(CompletionKind::CHOICE, completion.kind());
+    EXPECT_EQ("--mode=fast", completion.value());
+    EXPECT_EQ("The mode", completion.description());
+}
+
+TEST(Completion, Equality) {
+    const Completion completion(CompletionKind::FORM, "--mode", "The mode");
+    EXPECT_EQ(completion, Completion(CompletionKind::FORM, "--mode", "The mode"));
+    EXPECT_NE(completion, Completion(CompletionKind::CHOICE, "--mode", "The mode"));
+    EXPECT_NE(completion, Completion(CompletionKind::FORM, "--mod", "The mode"));
+    EXPECT_NE(completion, Completion(CompletionKind::FORM, "--mode", ""));
+}
+
+TEST(Completion, StreamOperator) {
+    EXPECT_EQ("Form", ToString(CompletionKind::FORM));
+    EXPECT_EQ("Choice", ToString(CompletionKind::CHOICE));
+    EXPECT_EQ("Value", ToString(CompletionKind::VALUE));
+    EXPECT_EQ("Form(--mode)", ToString(Completion(CompletionKind::FORM, "--mode", "")));
+}
+
+} // namespace ahoy
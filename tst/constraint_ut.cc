@@ -0,0 +1,57 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/constraint.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Gets the string representation of |value|
+template<typename T>
+std::string ToString(const T& value) {
+    std::stringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(Constraint, Get) {
+    const Constraint exclusive = Exclusive({ "tcp", "unix" });
+    EXPECT_EQ(ConstraintKind::EXCLUSIVE, exclusive.kind());
+    EXPECT_EQ(std::vector<std::string>({ "tcp", "unix" }), exclusive.names());
+    EXPECT_EQ("", exclusive.dependent());
+
+    const Constraint requires = Requires("tls-key", { "tls-cert" });
+    EXPECT_EQ(ConstraintKind::REQUIRES, requires.kind());
+    EXPECT_EQ(std::vector<std::string>({ "tls-cert" }), requires.names());
+    EXPECT_EQ("tls-key", requires.dependent());
+
+    EXPECT_EQ(ConstraintKind::AT_LEAST_ONE, AtLeastOne({ "a" }).kind());
+}
+
+TEST(Constraint, Equality) {
+    EXPECT_EQ(Exclusive({ "a", "b" }), Constraint(ConstraintKind::EXCLUSIVE, { "a", "b" }));
+    EXPECT_NE(Exclusive({ "a", "b" }), AtLeastOne({ "a", "b" }));
+    EXPECT_NE(Exclusive({ "a", "b" }), Exclusive({ "b", "a" }));
+    EXPECT_NE(Requires("a", { "b" }), Requires("c", { "b" }));
+}
+
+TEST(Constraint, StreamOperator) {
+    EXPECT_EQ("Exclusive", ToString(ConstraintKind::EXCLUSIVE));
+    EXPECT_EQ("AtLeastOne", ToString(ConstraintKind::AT_LEAST_ONE));
+    EXPECT_EQ("Requires", ToString(ConstraintKind::REQUIRES));
+    EXPECT_EQ("Exclusive(tcp, unix)", ToString(Exclusive({ "tcp", "unix" })));
+    EXPECT_EQ("AtLeastOne()", ToString(AtLeastOne({})));
+    EXPECT_EQ("Requires(tls-key; tls-cert, ca)",
+              ToString(Requires("tls-key", { "tls-cert", "ca" })));
+}
+
+} // namespace ahoy
@@ -0,0 +1,115 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/flag.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+AHOY_FLAG(int, test_port, 8080, "The port to listen on");
+AHOY_FLAG(bool, test_verbose, false, "Enables verbose logging");
+AHOY_FLAG(double, test_ratio, 0.5, "A ratio");
+AHOY_FLAG(std::string, test_host, "localhost", "The host to connect to");
+AHOY_FLAG(std::chrono::milliseconds, test_timeout, std::chrono::milliseconds(250), "A timeout");
+
+namespace {
+
+AHOY_DECLARE_FLAG(unsigned int, test_count);
+AHOY_FLAG(unsigned int, test_count, 3, "A flag in a namespace, declared before it is defined");
+
+const char kProgram[] = "./program";
+
+// Flags are constant-initialized, so they must never need a constructor or destructor to run
+static_assert(std::is_trivially_destructible<ahoy::FlagValue<int>>::value,
+              "Flags must not be destroyed");
+static_assert(std::is_trivially_destructible<ahoy::FlagValue<std::string>>::value,
+              "Flags must not be destroyed");
+
+// Whether the flags linked into the program include |name|
+bool IsRegistered(const char* name) {
+    for (const ahoy::internal::FlagDescriptor* descriptor :
+            ahoy::internal::FlagRegistry::Program().descriptors()) {
+        if (std::strcmp(descriptor->name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(Flag, Registered) {
+    EXPECT_TRUE(IsRegistered("test_port"));
+    EXPECT_TRUE(IsRegistered("test_verbose"));
+    EXPECT_TRUE(IsRegistered("test_ratio"));
+    EXPECT_TRUE(IsRegistered("test_host"));
+    EXPECT_TRUE(IsRegistered("test_timeout"));
+    EXPECT_TRUE(IsRegistered("test_count"));
+    EXPECT_FALSE(IsRegistered("test_missing"));
+}
+
+TEST(Flag, ParseFlags) {
+    const char* argv[] = { kProgram, "--test_port=9000", "--test_verbose", "--test_host", "remote",
+                           "--test_timeout", "1s", "--test_count", "7" };
+    std::string program_name;
+    ParseResult result;
+    ASSERT_TRUE(ParseFlags(9, argv, &program_name, &result));
+    EXPECT_TRUE(result.success());
+    EXPECT_EQ(kProgram, program_name);
+    EXPECT_EQ(9000, AHOY_FLAGS_test_port.Get());
+    EXPECT_TRUE(AHOY_FLAGS_test_verbose.Get());
+    EXPECT_EQ("remote", AHOY_FLAGS_test_host.Get());
+    EXPECT_EQ(std::chrono::milliseconds(1000), AHOY_FLAGS_test_timeout.Get());
+    EXPECT_EQ(7u, AHOY_FLAGS_test_count.Get());
+
+    // Flags left out keep their current values
+    const char* ratio_argv[] = { kProgram, "--test_ratio", "0.25" };
+    ASSERT_TRUE(ParseFlags(3, ratio_argv));
+    EXPECT_EQ(0.25, AHOY_FLAGS_test_ratio.Get());
+    EXPECT_EQ(9000, AHOY_FLAGS_test_port.Get());
+    EXPECT_EQ("remote", AHOY_FLAGS_test_host.Get());
+}
+
+TEST(Flag, ParseFlagsFailure) {
+    const char* argv[] = { kProgram, "--test_port", "1234" };
+    ASSERT_TRUE(ParseFlags(3, argv));
+
+    // Nothing is published if any argument is invalid
+    const char* invalid_argv[] = { kProgram, "--test_host", "other", "--test_port", "abc" };
+    EXPECT_FALSE(ParseFlags(5, invalid_argv));
+    EXPECT_EQ(1234, AHOY_FLAGS_test_port.Get());
+    EXPECT_NE("other", AHOY_FLAGS_test_host.Get());
+
+    const char* unmatched_argv[] = { kProgram, "--test_prot", "1" };
+    ParseResult result;
+    EXPECT_FALSE(ParseFlags(3, unmatched_argv, nullptr, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_EQ("--test_prot", result.unmatched());
+}
+
+TEST(Flag, ReadWhileParsing) {
+    std::atomic<bool> done(false);
+    std::thread reader([&done]() {
+        while (!done.load()) {
+            const int port = AHOY_FLAGS_test_port.Get();
+            EXPECT_TRUE(port == 1 || port == 2 || port == 1234 || port == 9000 || port == 8080);
+            EXPECT_FALSE(AHOY_FLAGS_test_host.Get().empty());
+        }
+    });
+    for (int i = 0; i < 100; i++) {
+        const char* argv[] = { kProgram, "--test_port", i % 2 == 0 ? "1" : "2" };
+        EXPECT_TRUE(ParseFlags(3, argv));
+    }
+    done.store(true);
+    reader.join();
+}
+
+} // namespace ahoy
@@ -0,0 +1,173 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// libFuzzer target that builds a random grammar and random arguments from the fuzzer's input and
+// parses them. Besides the usual crashes and sanitizer errors, it reports any input whose parse
+// takes more steps than a fixed polynomial in the size of the grammar and the number of arguments,
+// which indicates the engine can be made to backtrack excessively.
+//
+// Requires clang. Run with: bazel run //tst/fuzz:parser_fuzzer -- -max_total_time=60
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ahoy/parser.h"
+
+namespace {
+
+// Limits on the size of the generated inputs. These keep individual runs fast so the fuzzer
+// explores more shapes rather than larger ones.
+const int kMaxDepth = 4;
+const int kMaxParameters = 24;
+const int kMaxChildren = 3;
+const int kMaxArgs = 24;
+
+// The maximum number of steps allowed is kStepFactor * (parameters + 1)^2 * (args + 1)^2
+const unsigned long long kStepFactor = 16;
+
+const char* const kForms[] = { "a", "b", "long", "x" };
+const char* const kArgs[] = {
+    "-a", "-b", "--long", "-x", "--x", "-a=1", "--long=value", "-b=", "1", "-1", "value", "", "-",
+    "--", "=", "-ak=v",
+};
+
+template<typename T, std::size_t size>
+constexpr std::size_t length(T (&)[size]) {
+    return size;
+}
+
+// Reads values from the fuzzer's input, producing zeros once it is exhausted
+class Reader {
+  public:
+    Reader(const std::uint8_t* data, std::size_t size) : data_(data), end_(data + size) {}
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Gets a value in the range [0, |limit|)
+    std::size_t next(const std::size_t limit) {
+        if (data_ == end_) {
+            return 0;
+        }
+        return *data_++ % limit;
+    }
+
+  private:
+    const std::uint8_t* data_;
+    const std::uint8_t* const end_;
+};
+
+// Holds the values bound to the generated parameters. Deques keep pointers stable as they grow.
+struct Storage {
+    Storage() : strings(), ints(), bools(), properties() {}
+
+    std::deque<std::string> strings;
+    std::deque<int> ints;
+    std::deque<bool> bools;
+    std::deque<ahoy::Properties> properties;
+};
+
+ahoy::Parameter BuildParameter(Reader* reader, Storage* storage, const int depth,
+                               int* parameters);
+
+// Builds up to kMaxChildren parameters at |depth| while there is room for more
+std::vector<ahoy::Parameter> BuildChildren(Reader* reader, Storage* storage, const int depth,
+                                           int* parameters) {
+    std::vector<ahoy::Parameter> children;
+    for (std::size_t n = reader->next(kMaxChildren + 1); n > 0 && *parameters < kMaxParameters;
+            n--) {
+        children.push_back(BuildParameter(reader, storage, depth, parameters));
+    }
+    return children;
+}
+
+ahoy::Parameter BuildParameter(Reader* reader, Storage* storage, const int depth,
+                               int* parameters) {
+    (*parameters)++;
+
+    const std::set<std::string> forms = { kForms[reader->next(length(kForms))] };
+    storage->strings.emplace_back();
+    storage->ints.emplace_back();
+    storage->bools.emplace_back();
+    storage->properties.emplace_back();
+    std::string* const s = &storage->strings.back();
+    int* const i = &storage->ints.back();
+    bool* const b = &storage->bools.back();
+    ahoy::Properties* const p = &storage->properties.back();
+
+    ahoy::Parameter parameter(s);
+    switch (reader->next(8)) {
+        case 0:
+            parameter = ahoy::Parameter(s);
+            break;
+        case 1:
+            parameter = ahoy::Parameter(i, ahoy::Required());
+            break;
+        case 2:
+            parameter = ahoy::Parameter(b, ahoy::ShortForms(forms), ahoy::Flag());
+            break;
+        case 3:
+            parameter = ahoy::Parameter(s, ahoy::LongForms(forms));
+            break;
+        case 4:
+            parameter = ahoy::Parameter(i, ahoy::ShortForms(forms), ahoy::Required());
+            break;
+        case 5:
+            parameter = ahoy::Parameter(s, ahoy::Forms(forms), ahoy::Required());
+            break;
+        case 6:
+            parameter = ahoy::Parameter(p, ahoy::ShortForms(forms), ahoy::BorrowArgv());
+            break;
+        default:
+            parameter = ahoy::Parameter(b, ahoy::Flag());
+            break;
+    }
+
+    if (depth < kMaxDepth) {
+        const std::vector<ahoy::Parameter> options =
+                BuildChildren(reader, storage, depth + 1, parameters);
+        const std::vector<ahoy::Parameter> nexts =
+                BuildChildren(reader, storage, depth + 1, parameters);
+        parameter.withOptions(options).then(nexts);
+    }
+
+    return parameter;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    Reader reader(data, size);
+    Storage storage;
+
+    int parameters = 0;
+    const std::vector<ahoy::Parameter> options = BuildChildren(&reader, &storage, 1, &parameters);
+    const std::vector<ahoy::Parameter> nexts = BuildChildren(&reader, &storage, 1, &parameters);
+
+    std::vector<const char*> argv(1, "./program");
+    for (std::size_t n = reader.next(kMaxArgs + 1); n > 0; n--) {
+        argv.push_back(kArgs[reader.next(length(kArgs))]);
+    }
+
+    const unsigned long long p = parameters + 1;
+    const unsigned long long a = argv.size();
+    const unsigned long long max_steps = kStepFactor * p * p * a * a;
+
+    ahoy::ParseResult result;
+    ahoy::Parser().withOptions(options).then(nexts).withStepBudget(max_steps)
+        .Parse(static_cast<int>(argv.size()), argv.data(), nullptr, &result);
+
+    if (result.error() == ahoy::ParseError::STEP_BUDGET_EXCEEDED) {
+        std::fprintf(stderr, "Parsing %llu arguments with %d parameters took more than %llu steps\n",
+                     a - 1, parameters, max_steps);
+        std::abort();
+    }
+
+    return 0;
+}
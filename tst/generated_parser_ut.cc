@@ -0,0 +1,84 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "tst/test_flags.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const char kProgram[] = "program";
+
+// Parses |args| after the program name into |flags|
+bool Parse(const std::vector<const char*>& args, ahoy::test::TestFlags* flags,
+           ahoy::ParseResult* result = nullptr) {
+    std::vector<const char*> argv{ kProgram };
+    argv.insert(argv.end(), args.begin(), args.end());
+    return ahoy::test::ParseTestFlags(static_cast<int>(argv.size()), argv.data(), flags, nullptr,
+                                      result);
+}
+
+} // namespace
+
+namespace ahoy {
+namespace test {
+
+TEST(GeneratedParser, Defaults) {
+    const TestFlags flags;
+    EXPECT_FALSE(flags.verbose);
+    EXPECT_EQ(3, flags.iterations);
+    EXPECT_EQ("un\"named\"", flags.name);
+    EXPECT_EQ(std::chrono::milliseconds(1500), flags.timeout);
+    EXPECT_EQ(0.5, flags.ratio);
+    EXPECT_TRUE(flags.includes.empty());
+    EXPECT_EQ("", flags.input);
+}
+
+TEST(GeneratedParser, Parse) {
+    TestFlags flags;
+    std::string program_name;
+    ParseResult result;
+    const char* const argv[] = { kProgram, "-v", "-i", "7", "--name=n", "--timeout", "2s",
+                                 "-I", "a", "-I=b", "input", "out1", "out2" };
+    ASSERT_TRUE(ParseTestFlags(13, argv, &flags, &program_name, &result));
+    EXPECT_TRUE(result.success());
+    EXPECT_EQ(9u, result.steps());
+    EXPECT_EQ(kProgram, program_name);
+    EXPECT_TRUE(flags.verbose);
+    EXPECT_EQ(7, flags.iterations);
+    EXPECT_EQ("n", flags.name);
+    EXPECT_EQ(std::chrono::milliseconds(2000), flags.timeout);
+    EXPECT_EQ(0.5, flags.ratio);
+    EXPECT_EQ(std::vector<std::string>({ "a", "b" }), flags.includes);
+    EXPECT_EQ("input", flags.input);
+    EXPECT_EQ(std::vector<std::string>({ "out1", "out2" }), flags.outputs);
+}
+
+TEST(GeneratedParser, Invalid) {
+    TestFlags flags;
+    ParseResult result;
+    EXPECT_FALSE(Parse({}, &flags, &result));
+    EXPECT_EQ(ParseError::INVALID_ARGUMENTS, result.error());
+
+    EXPECT_FALSE(Parse({ "input", "-i", "three" }, &flags));
+    EXPECT_FALSE(Parse({ "input", "-i" }, &flags));
+    EXPECT_FALSE(Parse({ "input", "-i", "1", "-i", "2" }, &flags));
+    EXPECT_FALSE(Parse({ "input", "--timeout=soon" }, &flags));
+    EXPECT_FALSE(ParseTestFlags(0, nullptr, &flags));
+}
+
+TEST(GeneratedParser, Positionals) {
+    TestFlags flags;
+    // Arguments that match no form, including flags given values, are positional
+    ASSERT_TRUE(Parse({ "--unknown", "-v=true" }, &flags));
+    EXPECT_EQ("--unknown", flags.input);
+    EXPECT_EQ(std::vector<std::string>({ "-v=true" }), flags.outputs);
+    EXPECT_FALSE(flags.verbose);
+}
+
+} // namespace test
+} // namespace ahoy
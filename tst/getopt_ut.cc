@@ -0,0 +1,139 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/getopt.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+int flag = 0;
+
+const struct option kOptions[] = {
+    { "verbose", no_argument, nullptr, 'v' },
+    { "version", no_argument, nullptr, 'V' },
+    { "output", required_argument, nullptr, 'o' },
+    { "out-dir", required_argument, nullptr, 'O' },
+    { "level", optional_argument, nullptr, 'l' },
+    { "color", no_argument, &flag, 1 },
+    { "colour", no_argument, &flag, 1 },
+    { "no-color", no_argument, &flag, 2 },
+    { nullptr, 0, nullptr, 0 },
+};
+
+const char kOptstring[] = "ab:c::v";
+
+// Scans |args| with getopt_long, or with ahoy_getopt_long if |ahoy| is set, and describes
+// everything observable about the scan: what each call returned and set, the order argv was left
+// in and the errors printed
+std::string Scan(const bool ahoy, const std::vector<std::string>& args,
+                 const char* const optstring, const struct option* const longopts) {
+    std::vector<std::string> storage(args);
+    std::vector<char*> argv;
+    for (std::string& arg : storage) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    const int argc = static_cast<int>(args.size());
+
+    int& index = ahoy ? ahoy_optind : optind;
+    char*& value = ahoy ? ahoy_optarg : optarg;
+    int& error = ahoy ? ahoy_optopt : optopt;
+    index = 0;
+    flag = 0;
+
+    std::string trace;
+    testing::internal::CaptureStderr();
+    for (int calls = 0; calls < 100; calls++) {
+        int longindex = -1;
+        const int code = ahoy ? ahoy_getopt_long(argc, argv.data(), optstring, longopts, &longindex)
+                              : getopt_long(argc, argv.data(), optstring, longopts, &longindex);
+        trace += std::to_string(code) + " optind=" + std::to_string(index);
+        if (code == -1) {
+            break;
+        }
+        trace += " optarg=" + (value == nullptr ? std::string("null") : std::string(value)) +
+                 " longindex=" + std::to_string(longindex) + " flag=" + std::to_string(flag);
+        if (code == '?' || code == ':') {
+            trace += " optopt=" + std::to_string(error);
+        }
+        trace += "\n";
+    }
+    trace += "\n" + testing::internal::GetCapturedStderr();
+    for (int i = 0; i < argc; i++) {
+        trace += std::string(" ") + argv[static_cast<std::size_t>(i)];
+    }
+    return trace;
+}
+
+// Expects ahoy_getopt_long to scan |args| exactly like getopt_long
+void ExpectSameScan(const std::vector<std::string>& args,
+                    const char* const optstring = kOptstring,
+                    const struct option* const longopts = kOptions) {
+    EXPECT_EQ(Scan(false, args, optstring, longopts), Scan(true, args, optstring, longopts));
+}
+
+} // namespace
+
+TEST(Getopt, ShortOptions) {
+    ExpectSameScan({ "prog", "-a", "-b", "x", "-by", "-c", "-cz", "-abz", "-vac" });
+    ExpectSameScan({ "prog", "-a", "-b" });
+    ExpectSameScan({ "prog", "-x", "-ax", "-" });
+    ExpectSameScan({ "prog" });
+}
+
+TEST(Getopt, LongOptions) {
+    ExpectSameScan({ "prog", "--verbose", "--output=f", "--output", "g", "--out-dir", "d",
+                     "--level", "--level=3", "--color", "--no-color", "--output=" });
+    ExpectSameScan({ "prog", "--verb", "--vers", "--out", "x", "--out-", "y", "--col", "--no" });
+    ExpectSameScan({ "prog", "--ver", "--quiet", "--verbose=1", "--quiet=2", "--", "--output" });
+    ExpectSameScan({ "prog", "--output" });
+    ExpectSameScan({ "prog", "--", "-a" });
+    ExpectSameScan({ "prog", "--level", "3", "---verbose" });
+    ExpectSameScan({ "prog", "--verbose", "--output" }, kOptstring, nullptr);
+}
+
+TEST(Getopt, Ordering) {
+    const std::vector<std::string> args{ "prog", "file1", "-a", "file2", "-b", "x", "file3",
+                                         "--verbose", "--", "-a", "file4" };
+    ExpectSameScan(args);
+    ExpectSameScan(args, "+ab:");
+    ExpectSameScan(args, "-ab:");
+    ExpectSameScan({ "prog", "file1", "file2", "-a" });
+    ExpectSameScan({ "prog", "file1", "-a", "file2" }, ":ab:");
+}
+
+TEST(Getopt, Silent) {
+    ExpectSameScan({ "prog", "-b" }, ":ab:");
+    ExpectSameScan({ "prog", "--output" }, ":ab:");
+    ExpectSameScan({ "prog", "-x", "--quiet" }, ":ab:");
+    ExpectSameScan({ "prog", "-b" }, "+:ab:");
+
+    ahoy_opterr = 0;
+    opterr = 0;
+    ExpectSameScan({ "prog", "-x", "--ver", "--verbose=1", "-b" });
+    ahoy_opterr = 1;
+    opterr = 1;
+}
+
+TEST(Getopt, Random) {
+    const std::vector<std::string> pool{ "-a", "-b", "-c", "-cx", "-bx", "-abc", "-x", "-", "--",
+                                         "--verbose", "--verb", "--ver", "--output", "--output=f",
+                                         "--out", "--out-dir=d", "--level", "--level=2",
+                                         "--color", "--col", "--no", "--quiet", "--verbose=1",
+                                         "file", "other" };
+    const std::vector<const char*> optstrings{ kOptstring, "+ab:c::v", "-ab:c::v", ":ab:c::v" };
+    std::mt19937 random(7);
+    for (int i = 0; i < 2000; i++) {
+        std::vector<std::string> args{ "prog" };
+        const std::size_t size = random() % 8;
+        for (std::size_t j = 0; j < size; j++) {
+            args.push_back(pool[random() % pool.size()]);
+        }
+        ExpectSameScan(args, optstrings[random() % optstrings.size()]);
+    }
+}
@@ -3,6 +3,10 @@
 
 #include "ahoy/internal/assign.h"
 
+#include <climits>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 // The following are helper macros to enable more consistent testing of assignment functions while
@@ -281,5 +285,269 @@ TEST(Assign, String_Success) {
     EXPECT_EQ("false", s);
 }
 
+TEST(Assign, Utf8String) {
+    std::string s("unchanged");
+    EXPECT_TRUE(AssignUtf8String(&s, std::string("caf\xC3\xA9")));
+    EXPECT_EQ("caf\xC3\xA9", s);
+    EXPECT_FALSE(AssignUtf8String(&s, std::string("caf\xC3")));
+    EXPECT_EQ("caf\xC3\xA9", s);
+    EXPECT_TRUE(AssignUtf8String(&s, true));
+    EXPECT_EQ("true", s);
+
+    EXPECT_TRUE(Assign(&s, Type::UTF8_STRING, std::string("a")));
+    EXPECT_FALSE(Assign(&s, Type::UTF8_STRING, std::string("\xFF")));
+}
+
+TEST(Assign, Choice) {
+    short s(0);
+    EXPECT_TRUE(AssignChoice(&s, Type::SHORT, -5));
+    EXPECT_EQ(-5, s);
+    EXPECT_FALSE(AssignChoice(&s, Type::SHORT, 100000));
+    EXPECT_EQ(-5, s);
+
+    unsigned int u(0);
+    EXPECT_TRUE(AssignChoice(&u, Type::U_INT, 7));
+    EXPECT_EQ(7u, u);
+    EXPECT_FALSE(AssignChoice(&u, Type::U_INT, -1));
+
+    long long ll(0);
+    EXPECT_TRUE(AssignChoice(&ll, Type::LONG_LONG, LLONG_MIN));
+    EXPECT_EQ(LLONG_MIN, ll);
+
+    std::string str;
+    EXPECT_FALSE(AssignChoice(&str, Type::STRING, 1));
+    EXPECT_FALSE(AssignChoice(&str, Type::BOOL, 1));
+}
+
+TEST(Assign, Count) {
+    int i(1);
+    EXPECT_TRUE(AssignCount(&i, Type::INT, 3));
+    EXPECT_EQ(4, i);
+
+    unsigned short us(65530);
+    EXPECT_TRUE(AssignCount(&us, Type::U_SHORT, 5));
+    EXPECT_EQ(65535, us);
+    EXPECT_FALSE(AssignCount(&us, Type::U_SHORT, 1));
+    EXPECT_EQ(65535, us);
+
+    unsigned char uc(0);
+    EXPECT_FALSE(AssignCount(&uc, Type::U_CHAR, 1));
+
+    unsigned long long ull(0);
+    EXPECT_TRUE(AssignCount(&ull, Type::U_LONG_LONG, ULLONG_MAX));
+    EXPECT_FALSE(AssignCount(&ull, Type::U_LONG_LONG, 1));
+
+    std::string str;
+    EXPECT_FALSE(AssignCount(&str, Type::STRING, 1));
+}
+
+TEST(Assign, Append) {
+    std::vector<int> ints{ 1 };
+    EXPECT_TRUE(AssignAppend(&ints, Type::INT, "2"));
+    EXPECT_TRUE(AssignAppend(&ints, Type::INT, "-3"));
+    EXPECT_FALSE(AssignAppend(&ints, Type::INT, "four"));
+    EXPECT_EQ(std::vector<int>({ 1, 2, -3 }), ints);
+
+    std::vector<std::string> strings;
+    EXPECT_TRUE(AssignAppend(&strings, Type::STRING, "a"));
+    EXPECT_TRUE(AssignAppend(&strings, Type::STRING, ""));
+    EXPECT_EQ(std::vector<std::string>({ "a", "" }), strings);
+    EXPECT_TRUE(AssignAppend(&strings, Type::UTF8_STRING, "\xC3\xA9"));
+    EXPECT_FALSE(AssignAppend(&strings, Type::UTF8_STRING, "\xC3"));
+    EXPECT_EQ(std::vector<std::string>({ "a", "", "\xC3\xA9" }), strings);
+
+    std::vector<double> doubles;
+    EXPECT_TRUE(AssignAppend(&doubles, Type::DOUBLE, "1.5"));
+    EXPECT_EQ(std::vector<double>({ 1.5 }), doubles);
+
+    EXPECT_FALSE(AssignAppend(&doubles, Type::BOOL, "true"));
+}
+
+TEST(Assign, AssignAppendAll) {
+    std::vector<int> ints{ 1 };
+    const std::vector<std::string> values{ "2", "-3", "4" };
+    EXPECT_TRUE(AssignAppendAll(&ints, Type::INT, values.data(), values.size()));
+    EXPECT_EQ(std::vector<int>({ 1, 2, -3, 4 }), ints);
+    EXPECT_TRUE(AssignAppendAll(&ints, Type::INT, values.data(), 0));
+    EXPECT_EQ(4u, ints.size());
+
+    // Nothing is appended if any value does not convert
+    const std::vector<std::string> invalid{ "5", "six", "7" };
+    EXPECT_FALSE(AssignAppendAll(&ints, Type::INT, invalid.data(), invalid.size()));
+    EXPECT_EQ(std::vector<int>({ 1, 2, -3, 4 }), ints);
+
+    std::vector<std::string> strings;
+    const std::vector<std::string> utf8{ "a", "\xC3\xA9" };
+    EXPECT_TRUE(AssignAppendAll(&strings, Type::UTF8_STRING, utf8.data(), utf8.size()));
+    EXPECT_EQ(utf8, strings);
+    const std::vector<std::string> invalid_utf8{ "b", "\xC3" };
+    EXPECT_FALSE(AssignAppendAll(&strings, Type::UTF8_STRING, invalid_utf8.data(), 2));
+    EXPECT_EQ(utf8, strings);
+
+    std::vector<double> doubles;
+    EXPECT_FALSE(AssignAppendAll(&doubles, Type::BOOL, values.data(), values.size()));
+}
+
+TEST(Assign, AssignAppendAll_Chunked) {
+    // Enough values to be split over several threads where there are cores for them
+    const std::size_t count = 8 * 16384 + 3;
+    std::vector<std::string> values;
+    values.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        values.push_back(std::to_string(i));
+    }
+
+    std::vector<unsigned long> ulongs{ 42 };
+    EXPECT_TRUE(AssignAppendAll(&ulongs, Type::U_LONG, values.data(), values.size()));
+    ASSERT_EQ(count + 1, ulongs.size());
+    EXPECT_EQ(42u, ulongs[0]);
+    for (std::size_t i = 0; i < count; i++) {
+        ASSERT_EQ(i, ulongs[i + 1]);
+    }
+
+    std::vector<std::string> strings;
+    EXPECT_TRUE(AssignAppendAll(&strings, Type::STRING, values.data(), values.size()));
+    EXPECT_EQ(values, strings);
+
+    // A bad value in the last chunk rolls back every chunk
+    values.back() = "-1";
+    EXPECT_FALSE(AssignAppendAll(&ulongs, Type::U_LONG, values.data(), values.size()));
+    EXPECT_EQ(count + 1, ulongs.size());
+}
+
+TEST(Assign, ReserveAppend) {
+    std::vector<std::string> strings{ "a" };
+    ReserveAppend(&strings, Type::STRING, 10);
+    EXPECT_LE(11u, strings.capacity());
+    EXPECT_EQ(1u, strings.size());
+
+    std::vector<unsigned long> ulongs;
+    ReserveAppend(&ulongs, Type::U_LONG, 4);
+    EXPECT_LE(4u, ulongs.capacity());
+
+    // Non-container types are ignored
+    bool b(false);
+    ReserveAppend(&b, Type::BOOL, 4);
+}
+
+TEST(Assign, Validate) {
+    EXPECT_TRUE(Validate(Type::STRING, "anything"));
+    EXPECT_TRUE(Validate(Type::UTF8_STRING, "anything"));
+    EXPECT_FALSE(Validate(Type::UTF8_STRING, "\xC0\xAF"));
+    EXPECT_TRUE(Validate(Type::INT, "-12"));
+    EXPECT_FALSE(Validate(Type::INT, "twelve"));
+    EXPECT_FALSE(Validate(Type::U_CHAR, "256"));
+    EXPECT_TRUE(Validate(Type::LONG_DOUBLE, "1.5"));
+    EXPECT_TRUE(Validate(Type::BYTES, "4GiB"));
+    EXPECT_TRUE(Validate(Type::HOURS, "2h"));
+    EXPECT_FALSE(Validate(Type::HOURS, "2s"));
+    EXPECT_FALSE(Validate(Type::INVALID, "1"));
+}
+
+TEST(Assign, Bytes_Success) {
+    std::uint64_t b(0);
+    EXPECT_TRUE(AssignBytes(&b, std::string("0")));
+    EXPECT_EQ(0u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("512")));
+    EXPECT_EQ(512u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("512B")));
+    EXPECT_EQ(512u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("10k")));
+    EXPECT_EQ(10000u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("10KB")));
+    EXPECT_EQ(10000u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("10Ki")));
+    EXPECT_EQ(10240u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("4GiB")));
+    EXPECT_EQ(4ull << 30, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("3M")));
+    EXPECT_EQ(3000000u, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("15EiB")));
+    EXPECT_EQ(15ull << 60, b);
+    EXPECT_TRUE(AssignBytes(&b, std::string("18446744073709551615")));
+    EXPECT_EQ(UINT64_MAX, b);
+    EXPECT_TRUE(AssignBytes(&b, true));
+    EXPECT_EQ(1u, b);
+    EXPECT_TRUE(AssignBytes(&b, false));
+    EXPECT_EQ(0u, b);
+}
+
+TEST(Assign, Bytes_Failure) {
+    std::uint64_t b(0);
+    EXPECT_ASSIGN_FAILURE(AssignBytes, b);
+    EXPECT_ASSIGN_FAILURE_UNSIGNED(AssignBytes, b);
+    EXPECT_FALSE(AssignBytes(&b, std::string("B")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("k")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("1iB")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("1m")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("1KiBs")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("1 KiB")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("16EiB")));
+    EXPECT_FALSE(AssignBytes(&b, std::string("18446744073709551616")));
+    EXPECT_EQ(0u, b);
+}
+
+TEST(Assign, Duration_Success) {
+    std::chrono::milliseconds ms(0);
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("250")));
+    EXPECT_EQ(250, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("250ms")));
+    EXPECT_EQ(250, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("2s")));
+    EXPECT_EQ(2000, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("1h30m")));
+    EXPECT_EQ(90 * 60 * 1000, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("1s500ms")));
+    EXPECT_EQ(1500, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("3000us")));
+    EXPECT_EQ(3, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, std::string("1d")));
+    EXPECT_EQ(24 * 60 * 60 * 1000, ms.count());
+    EXPECT_TRUE(AssignMilliseconds(&ms, true));
+    EXPECT_EQ(1, ms.count());
+
+    std::chrono::nanoseconds ns(0);
+    EXPECT_TRUE(AssignNanoseconds(&ns, std::string("7ns")));
+    EXPECT_EQ(7, ns.count());
+    EXPECT_TRUE(AssignNanoseconds(&ns, std::string("2\xC2\xB5s")));
+    EXPECT_EQ(2000, ns.count());
+
+    std::chrono::microseconds us(0);
+    EXPECT_TRUE(AssignMicroseconds(&us, std::string("1ms1us")));
+    EXPECT_EQ(1001, us.count());
+
+    std::chrono::seconds s(0);
+    EXPECT_TRUE(AssignSeconds(&s, std::string("1m")));
+    EXPECT_EQ(60, s.count());
+
+    std::chrono::minutes m(0);
+    EXPECT_TRUE(AssignMinutes(&m, std::string("2h")));
+    EXPECT_EQ(120, m.count());
+
+    std::chrono::hours h(0);
+    EXPECT_TRUE(AssignHours(&h, std::string("2d")));
+    EXPECT_EQ(48, h.count());
+    EXPECT_TRUE(AssignHours(&h, false));
+    EXPECT_EQ(0, h.count());
+}
+
+TEST(Assign, Duration_Failure) {
+    std::chrono::milliseconds ms(0);
+    EXPECT_ASSIGN_FAILURE(AssignMilliseconds, ms);
+    EXPECT_ASSIGN_FAILURE_UNSIGNED(AssignMilliseconds, ms);
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("ms")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("1500us")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("1h30")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("1x")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("1u")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("1 s")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("9223372036854775808")));
+    EXPECT_FALSE(AssignMilliseconds(&ms, std::string("9223372036854776s")));
+    EXPECT_EQ(0, ms.count());
+
+    std::chrono::hours h(0);
+    EXPECT_FALSE(AssignHours(&h, std::string("30m")));
+}
+
 } // namespace internal
 } // namespace ahoy
@@ -0,0 +1,132 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/choice_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const std::vector<std::pair<std::string, long long>> kModes = {
+    { "fast", 1 }, { "safe", 2 }, { "Audit", -3 },
+};
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(ChoiceTable, Empty) {
+    const ChoiceTable table({}, false);
+    long long value = 7;
+    EXPECT_EQ(0u, table.size());
+    EXPECT_FALSE(table.find("", &value));
+    EXPECT_FALSE(table.find("fast", &value));
+    EXPECT_EQ(7, value);
+}
+
+TEST(ChoiceTable, Find) {
+    const ChoiceTable table(kModes, false);
+    long long value = 0;
+    EXPECT_EQ(3u, table.size());
+
+    EXPECT_TRUE(table.find("fast", &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(table.find("safe", &value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(table.find("Audit", &value));
+    EXPECT_EQ(-3, value);
+
+    value = 0;
+    EXPECT_FALSE(table.find("audit", &value));
+    EXPECT_FALSE(table.find("FAST", &value));
+    EXPECT_FALSE(table.find("fas", &value));
+    EXPECT_FALSE(table.find("fastt", &value));
+    EXPECT_FALSE(table.find("", &value));
+    EXPECT_FALSE(table.find(std::string("fast\0", 5), &value));
+    EXPECT_EQ(0, value);
+}
+
+TEST(ChoiceTable, CaseInsensitive) {
+    const ChoiceTable table(kModes, true);
+    long long value = 0;
+    EXPECT_TRUE(table.case_insensitive());
+    EXPECT_TRUE(table.find("FAST", &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(table.find("audit", &value));
+    EXPECT_EQ(-3, value);
+    EXPECT_TRUE(table.find("SaFe", &value));
+    EXPECT_EQ(2, value);
+    EXPECT_FALSE(table.find("s@fe", &value));
+
+    // Original spellings are preserved
+    EXPECT_EQ(kModes, table.choices());
+}
+
+TEST(ChoiceTable, Duplicates) {
+    const ChoiceTable sensitive({ { "a", 1 }, { "A", 2 }, { "a", 3 } }, false);
+    long long value = 0;
+    EXPECT_EQ(2u, sensitive.size());
+    EXPECT_TRUE(sensitive.find("a", &value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(sensitive.find("A", &value));
+    EXPECT_EQ(2, value);
+
+    const ChoiceTable insensitive({ { "a", 1 }, { "A", 2 } }, true);
+    EXPECT_EQ(1u, insensitive.size());
+    EXPECT_TRUE(insensitive.find("A", &value));
+    EXPECT_EQ(1, value);
+}
+
+TEST(ChoiceTable, Large) {
+    std::vector<std::pair<std::string, long long>> choices;
+    for (long long i = 0; i < 5000; i++) {
+        choices.emplace_back("codec-" + std::to_string(i), i);
+    }
+
+    const ChoiceTable table(choices, false);
+    EXPECT_EQ(choices.size(), table.size());
+    for (const std::pair<std::string, long long>& choice : choices) {
+        long long value = -1;
+        ASSERT_TRUE(table.find(choice.first, &value)) << choice.first;
+        ASSERT_EQ(choice.second, value);
+    }
+
+    long long value;
+    EXPECT_FALSE(table.find("codec-5000", &value));
+    EXPECT_FALSE(table.find("codec-", &value));
+}
+
+TEST(ChoiceTable, Equality) {
+    EXPECT_EQ(ChoiceTable(kModes, false), ChoiceTable(kModes, false));
+    EXPECT_NE(ChoiceTable(kModes, false), ChoiceTable(kModes, true));
+    EXPECT_NE(ChoiceTable(kModes, false), ChoiceTable({ { "fast", 1 } }, false));
+}
+
+TEST(ChoiceTable, View) {
+    const ChoiceTable table(kModes, true);
+    const ChoiceTable::View view = table.view();
+    EXPECT_EQ(kModes.size(), view.entry_count);
+    EXPECT_TRUE(view.case_insensitive);
+
+    std::size_t names_size = 0;
+    for (std::uint32_t i = 0; i < view.entry_count; i++) {
+        names_size = std::max<std::size_t>(names_size, view.entries[i].offset + view.entries[i].size);
+    }
+    EXPECT_TRUE(view.valid(names_size));
+    EXPECT_FALSE(view.valid(names_size - 1));
+
+    long long value = -1;
+    EXPECT_TRUE(view.find("FAST", 4, &value));
+    EXPECT_EQ(1, value);
+    EXPECT_FALSE(view.find("fas", 3, &value));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,95 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/constraint_set.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+TEST(ConstraintSet, Empty) {
+    const ConstraintSet empty;
+    EXPECT_TRUE(empty.empty());
+    ParseState state;
+    EXPECT_EQ(ConstraintSet::kSatisfied, empty.check(state));
+}
+
+TEST(ConstraintSet, Check) {
+    bool a = false, b = false, c = false;
+    const Grammar grammar({ Parameter(&a, Name("a"), ShortForms({"a"}), Flag()),
+                            Parameter(&b, Name("b"), ShortForms({"b"}), Flag()),
+                            Parameter(&c, Name("c"), ShortForms({"c"}), Flag()),
+                            Parameter(&c, Name("c"), ShortForms({"C"}), Flag()) }, {});
+    const ConstraintSet constraints({ Exclusive({ "a", "b" }),
+                                      Requires("a", { "c", "b" }),
+                                      Requires("b", { "c" }),
+                                      AtLeastOne({ "a", "b" }) }, grammar);
+    EXPECT_FALSE(constraints.empty());
+
+    // Nodes are numbered from the root, so a is 1 and the two c are 3 and 4
+    const auto check = [&constraints](const std::vector<std::size_t>& present) {
+        ParseState state;
+        state.track(5);
+        for (const std::size_t node : present) {
+            state.match(node);
+        }
+        return constraints.check(state);
+    };
+    EXPECT_EQ(0u, check({ 1, 2 }));
+    EXPECT_EQ(1u, check({ 1, 3 }));
+    EXPECT_EQ(2u, check({ 2 }));
+    EXPECT_EQ(ConstraintSet::kSatisfied, check({ 2, 3 }));
+    EXPECT_EQ(ConstraintSet::kSatisfied, check({ 2, 4 }));
+    EXPECT_EQ(3u, check({ 3 }));
+    EXPECT_EQ("", constraints.unknown());
+    EXPECT_EQ(ConstraintSet::kSatisfied, constraints.unknown_constraint());
+}
+
+TEST(ConstraintSet, Unknown) {
+    bool a = false;
+    const Grammar grammar({ Parameter(&a, Name("a"), ShortForms({"a"}), Flag()) }, {});
+    const ConstraintSet constraints({ Exclusive({ "a" }),
+                                      Requires("a", { "unknown", "other" }) }, grammar);
+    EXPECT_EQ("unknown", constraints.unknown());
+    EXPECT_EQ(1u, constraints.unknown_constraint());
+
+    // Violated whatever is present
+    ParseState state;
+    state.track(grammar.size());
+    EXPECT_EQ(1u, constraints.check(state));
+    state.match(1);
+    EXPECT_EQ(1u, constraints.check(state));
+}
+
+TEST(ConstraintSet, ManyNames) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) {
+        names.push_back("name" + std::to_string(i));
+    }
+    std::vector<Parameter> options;
+    bool value = false;
+    for (const std::string& name : names) {
+        options.push_back(Parameter(&value, Name(name), LongForms({name}), Flag()));
+    }
+    const Grammar grammar(options, {});
+    const ConstraintSet constraints({ Exclusive({ "name3", "name99" }),
+                                      Requires("name70", { "name1", "name80" }) }, grammar);
+
+    ParseState state;
+    state.track(grammar.size());
+    state.match(100);
+    state.match(71);
+    EXPECT_EQ(1u, constraints.check(state));
+    state.match(2);
+    state.match(81);
+    EXPECT_EQ(ConstraintSet::kSatisfied, constraints.check(state));
+    state.match(4);
+    EXPECT_EQ(0u, constraints.check(state));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,96 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/edit_distance.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// The distance from |a| to |b| by the textbook dynamic program
+std::size_t Reference(const std::string& a, const std::string& b) {
+    std::vector<std::vector<std::size_t>> d(a.size() + 1, std::vector<std::size_t>(b.size() + 1));
+    for (std::size_t i = 0; i <= a.size(); i++) {
+        d[i][0] = i;
+    }
+    for (std::size_t j = 0; j <= b.size(); j++) {
+        d[0][j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            d[i][j] = std::min({ d[i - 1][j] + 1, d[i][j - 1] + 1,
+                                 d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1) });
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+std::size_t Distance(const std::string& pattern, const std::string& text) {
+    return ahoy::internal::EditDistance(pattern).distance(text.data(), text.size());
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(EditDistance, Examples) {
+    EXPECT_EQ(0u, Distance("", ""));
+    EXPECT_EQ(3u, Distance("", "abc"));
+    EXPECT_EQ(3u, Distance("abc", ""));
+    EXPECT_EQ(0u, Distance("--verbose", "--verbose"));
+    EXPECT_EQ(1u, Distance("--verbos", "--verbose"));
+    EXPECT_EQ(2u, Distance("--vrebose", "--verbose"));
+    EXPECT_EQ(3u, Distance("kitten", "sitting"));
+    EXPECT_EQ(1u, Distance(std::string(64, 'a'), std::string(63, 'a')));
+    EXPECT_EQ(2u, Distance(std::string(70, 'a'), std::string(68, 'a')));
+}
+
+TEST(EditDistance, MatchesReference) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> letter('a', 'd');
+    std::uniform_int_distribution<std::size_t> length(0, 80);
+    for (int i = 0; i < 500; i++) {
+        std::string a(length(random), ' ');
+        std::string b(length(random), ' ');
+        std::generate(a.begin(), a.end(), [&] { return static_cast<char>(letter(random)); });
+        std::generate(b.begin(), b.end(), [&] { return static_cast<char>(letter(random)); });
+        ASSERT_EQ(Reference(a, b), Distance(a, b)) << a << " " << b;
+    }
+}
+
+TEST(EditDistance, Distances) {
+    const std::vector<std::string> texts{ "--verbose", "--version", "-v", "", "--verbosity" };
+    std::vector<const char*> data;
+    std::vector<std::size_t> sizes;
+    for (const std::string& text : texts) {
+        data.push_back(text.data());
+        sizes.push_back(text.size());
+    }
+
+    const std::vector<std::string> patterns{ "--verbos", "", std::string(70, '-') };
+    for (const std::string& pattern : patterns) {
+        const EditDistance distance(pattern);
+        std::vector<std::size_t> results(texts.size());
+        distance.distances(data.data(), sizes.data(), texts.size(), results.data());
+        for (std::size_t i = 0; i < texts.size(); i++) {
+            EXPECT_EQ(Reference(pattern, texts[i]), results[i]) << pattern << " " << texts[i];
+            EXPECT_LE(distance.lower_bound(data[i], sizes[i]), results[i]);
+        }
+    }
+}
+
+TEST(EditDistance, LowerBound) {
+    const EditDistance distance("--name");
+    EXPECT_EQ(0u, distance.lower_bound("--mane", 6));
+    EXPECT_EQ(3u, distance.lower_bound("--nxyz", 6));
+    EXPECT_EQ(0u, distance.lower_bound("", 0));
+}
+
+} // namespace internal
+} // namespace ahoy
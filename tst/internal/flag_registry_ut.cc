@@ -0,0 +1,91 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/flag_registry.h"
+
+#include <string>
+#include <vector>
+
+#include "ahoy/flag.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const char kProgram[] = "./program";
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(FlagRegistry, SortedByName) {
+    FlagValue<int> zebra(1);
+    FlagValue<int> apple(2);
+    const FlagDescriptor zebra_descriptor = FlagValue<int>::Describe("zebra", "", &zebra);
+    const FlagDescriptor apple_descriptor = FlagValue<int>::Describe("apple", "", &apple);
+    FlagRegistry registry({ &zebra_descriptor, &apple_descriptor });
+
+    ASSERT_EQ(2u, registry.descriptors().size());
+    EXPECT_EQ(&apple_descriptor, registry.descriptors()[0]);
+    EXPECT_EQ(&zebra_descriptor, registry.descriptors()[1]);
+}
+
+TEST(FlagRegistry, Parse) {
+    FlagValue<long> number(1);
+    FlagValue<bool> enabled(false);
+    FlagValue<std::string> text("default");
+    const FlagDescriptor number_descriptor = FlagValue<long>::Describe("number", "", &number);
+    const FlagDescriptor enabled_descriptor = FlagValue<bool>::Describe("enabled", "", &enabled);
+    const FlagDescriptor text_descriptor = FlagValue<std::string>::Describe("text", "", &text);
+    FlagRegistry registry({ &number_descriptor, &enabled_descriptor, &text_descriptor });
+
+    EXPECT_EQ("default", text.Get());
+
+    const char* argv[] = { kProgram, "--number", "-5", "--enabled" };
+    ParseResult result;
+    EXPECT_TRUE(registry.Parse(4, argv, nullptr, &result));
+    EXPECT_TRUE(result.success());
+    EXPECT_EQ(-5, number.Get());
+    EXPECT_TRUE(enabled.Get());
+    EXPECT_EQ("default", text.Get());
+
+    // References to replaced strings stay valid
+    const std::string& previous = text.Get();
+    const char* text_argv[] = { kProgram, "--text=changed" };
+    EXPECT_TRUE(registry.Parse(2, text_argv, nullptr, nullptr));
+    EXPECT_EQ("changed", text.Get());
+    EXPECT_EQ("default", previous);
+    EXPECT_EQ(-5, number.Get());
+
+    // Bool flags take no value
+    const char* flag_argv[] = { kProgram, "--enabled", "false" };
+    EXPECT_FALSE(registry.Parse(3, flag_argv, nullptr, nullptr));
+}
+
+TEST(FlagRegistry, Empty) {
+    FlagRegistry registry({});
+    const char* argv[] = { kProgram };
+    EXPECT_TRUE(registry.Parse(1, argv, nullptr, nullptr));
+
+    const char* extra_argv[] = { kProgram, "--anything" };
+    EXPECT_FALSE(registry.Parse(2, extra_argv, nullptr, nullptr));
+}
+
+TEST(FlagRegistry, DuplicateNames) {
+    FlagValue<int> first(1);
+    FlagValue<int> second(2);
+    const FlagDescriptor first_descriptor = FlagValue<int>::Describe("same", "", &first);
+    const FlagDescriptor second_descriptor = FlagValue<int>::Describe("same", "", &second);
+    FlagRegistry registry({ &first_descriptor, &second_descriptor });
+
+    const char* argv[] = { kProgram, "--same", "3" };
+    ParseResult result;
+    EXPECT_FALSE(registry.Parse(3, argv, nullptr, &result));
+    EXPECT_EQ(ParseError::INVALID_ARGUMENTS, result.error());
+    EXPECT_EQ(1, first.Get());
+    EXPECT_EQ(2, second.Get());
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,43 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/form_table.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const ahoy::internal::FormEntry kForms[] = {
+    { "--name", 6, 2 },
+    { "--name-prefix", 13, 3 },
+    { "--verbose", 9, 0 },
+    { "-n", 2, 2 },
+    { "-v", 2, 0 },
+};
+
+const ahoy::internal::FormEntry* const kEnd = kForms + sizeof(kForms) / sizeof(kForms[0]);
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(FormTable, Found) {
+    for (const FormEntry& entry : kForms) {
+        EXPECT_EQ(&entry, FindForm(kForms, kEnd, entry.form, entry.size)) << entry.form;
+    }
+    EXPECT_EQ(kForms + 1, FindForm(kForms, kEnd, "--name-prefix=value", 13));
+    EXPECT_EQ(kForms, FindForm(kForms, kEnd, "--name=value", 6));
+}
+
+TEST(FormTable, NotFound) {
+    EXPECT_EQ(nullptr, FindForm(kForms, kEnd, "--nam", 5));
+    EXPECT_EQ(nullptr, FindForm(kForms, kEnd, "--name-", 7));
+    EXPECT_EQ(nullptr, FindForm(kForms, kEnd, "-", 1));
+    EXPECT_EQ(nullptr, FindForm(kForms, kEnd, "", 0));
+    EXPECT_EQ(nullptr, FindForm(kForms, kEnd, "-z", 2));
+    EXPECT_EQ(nullptr, FindForm(kForms, kForms, "-v", 2));
+}
+
+} // namespace internal
+} // namespace ahoy
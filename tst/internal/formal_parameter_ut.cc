@@ -117,6 +117,84 @@ TEST(FormalParameter, GetSet) {
         fp.type(kType);
         EXPECT_EQ(kType, fp.type());
     }
+
+    {
+        FormalParameter fp;
+        EXPECT_EQ(nullptr, fp.choices());
+        fp.choices({ { "a", 1 }, { "b", 2 } });
+        ASSERT_NE(nullptr, fp.choices());
+        EXPECT_EQ(2u, fp.choices()->size());
+        EXPECT_FALSE(fp.case_insensitive());
+        EXPECT_FALSE(fp.choices()->case_insensitive());
+        fp.case_insensitive(true);
+        EXPECT_TRUE(fp.case_insensitive());
+        EXPECT_TRUE(fp.choices()->case_insensitive());
+        EXPECT_EQ(2u, fp.choices()->size());
+    }
+
+    {
+        FormalParameter fp;
+        fp.type(Type::U_LONG);
+        fp.byte_size(false);
+        EXPECT_EQ(Type::U_LONG, fp.type());
+        fp.byte_size(true);
+        EXPECT_EQ(Type::BYTES, fp.type());
+    }
+
+    {
+        FormalParameter fp;
+        fp.type(Type::STRING);
+        fp.validate_utf8(false);
+        EXPECT_EQ(Type::STRING, fp.type());
+        fp.validate_utf8(true);
+        EXPECT_EQ(Type::UTF8_STRING, fp.type());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_FALSE(fp.repeated());
+        fp.repeated(true);
+        EXPECT_TRUE(fp.repeated());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_FALSE(fp.count());
+        fp.count(true);
+        EXPECT_TRUE(fp.count());
+        EXPECT_TRUE(fp.flag());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_EQ("", fp.env_var());
+        fp.env_var("APP_PORT");
+        EXPECT_EQ("APP_PORT", fp.env_var());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_EQ(DuplicateKeyPolicy::LAST_WINS, fp.duplicate_key_policy());
+        fp.duplicate_key_policy(DuplicateKeyPolicy::REJECT);
+        EXPECT_EQ(DuplicateKeyPolicy::REJECT, fp.duplicate_key_policy());
+        EXPECT_FALSE(fp.borrow_argv());
+        fp.borrow_argv(true);
+        EXPECT_TRUE(fp.borrow_argv());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_EQ(PathKind::ANY, fp.path_kind());
+        fp.path_kind(PathKind::CREATABLE);
+        EXPECT_EQ(PathKind::CREATABLE, fp.path_kind());
+    }
+
+    {
+        FormalParameter fp;
+        EXPECT_FALSE(fp.variadic());
+        fp.variadic(true);
+        EXPECT_TRUE(fp.variadic());
+    }
 }
 
 TEST(FormalParameter, Equality) {
@@ -151,6 +229,48 @@ TEST(FormalParameter, Equality) {
     fp1.type(Type::STRING);
 
     ASSERT_EQ(fp1, fp2);
+
+    fp1.choices({ { "a", 1 } });
+    ASSERT_NE(fp1, fp2);
+    fp2.choices({ { "a", 1 } });
+    ASSERT_EQ(fp1, fp2);
+    fp2.case_insensitive(true);
+    ASSERT_NE(fp1, fp2);
+    fp1.case_insensitive(true);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.repeated(true);
+    ASSERT_NE(fp1, fp2);
+    fp2.repeated(true);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.env_var("APP_PORT");
+    ASSERT_NE(fp1, fp2);
+    fp2.env_var("APP_PORT");
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.duplicate_key_policy(DuplicateKeyPolicy::FIRST_WINS);
+    ASSERT_NE(fp1, fp2);
+    fp2.duplicate_key_policy(DuplicateKeyPolicy::FIRST_WINS);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.borrow_argv(true);
+    ASSERT_NE(fp1, fp2);
+    fp2.borrow_argv(true);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.path_kind(PathKind::EXISTING_FILE);
+    ASSERT_NE(fp1, fp2);
+    fp2.path_kind(PathKind::EXISTING_FILE);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.variadic(true);
+    ASSERT_NE(fp1, fp2);
+    fp2.variadic(true);
+    ASSERT_EQ(fp1, fp2);
+
+    fp1.count(true);
+    ASSERT_NE(fp1, fp2);
 }
 
 } // namespace internal
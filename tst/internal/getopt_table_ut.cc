@@ -0,0 +1,108 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/getopt_table.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+namespace {
+
+int flag = 0;
+
+const struct option kOptions[] = {
+    { "verbose", no_argument, nullptr, 'v' },
+    { "version", no_argument, nullptr, 'V' },
+    { "output", required_argument, nullptr, 'o' },
+    { "out-dir", required_argument, nullptr, 'o' },
+    { "color", optional_argument, &flag, 1 },
+    { "colour", optional_argument, &flag, 1 },
+    { "verbose", required_argument, nullptr, 'x' },
+    { nullptr, 0, nullptr, 0 },
+};
+
+} // namespace
+
+TEST(GetoptTable, ShortOptions) {
+    const GetoptTable table("ab:c::a:", nullptr);
+    EXPECT_EQ(GetoptTable::Ordering::PERMUTE, table.ordering());
+    EXPECT_FALSE(table.silent());
+    EXPECT_EQ(GetoptTable::Argument::NO_ARGUMENT, table.short_option('a'));
+    EXPECT_EQ(GetoptTable::Argument::REQUIRED, table.short_option('b'));
+    EXPECT_EQ(GetoptTable::Argument::OPTIONAL, table.short_option('c'));
+    EXPECT_EQ(GetoptTable::Argument::NONE, table.short_option('d'));
+    EXPECT_EQ(GetoptTable::Argument::NONE, table.short_option(':'));
+    EXPECT_EQ(GetoptTable::kNotFound, table.find("a", 1, nullptr));
+}
+
+TEST(GetoptTable, Prefixes) {
+    EXPECT_EQ(GetoptTable::Ordering::PERMUTE, GetoptTable(":a", nullptr).ordering());
+    EXPECT_TRUE(GetoptTable(":a", nullptr).silent());
+    EXPECT_EQ(GetoptTable::Ordering::REQUIRE_ORDER, GetoptTable("+a", nullptr).ordering());
+    EXPECT_FALSE(GetoptTable("+a", nullptr).silent());
+    EXPECT_EQ(GetoptTable::Ordering::RETURN_IN_ORDER, GetoptTable("-:a", nullptr).ordering());
+    EXPECT_TRUE(GetoptTable("-:a", nullptr).silent());
+    EXPECT_EQ(GetoptTable::Argument::NO_ARGUMENT,
+              GetoptTable("-:a", nullptr).short_option('a'));
+    EXPECT_EQ(GetoptTable::Argument::NONE, GetoptTable("-:a", nullptr).short_option('-'));
+}
+
+TEST(GetoptTable, Find) {
+    const GetoptTable table("", kOptions);
+    std::vector<int> ambiguities;
+    EXPECT_EQ(0, table.find("verbose", 7, &ambiguities));
+    EXPECT_EQ(1, table.find("version", 7, &ambiguities));
+    EXPECT_EQ(2, table.find("output=x", 6, &ambiguities));
+    EXPECT_EQ(3, table.find("out-", 4, &ambiguities));
+    EXPECT_EQ(1, table.find("versi", 5, &ambiguities));
+    // Abbreviating options that do the same thing picks the first
+    EXPECT_EQ(4, table.find("col", 3, &ambiguities));
+    EXPECT_EQ(GetoptTable::kNotFound, table.find("colors", 6, &ambiguities));
+    EXPECT_EQ(GetoptTable::kNotFound, table.find("quiet", 5, &ambiguities));
+    EXPECT_TRUE(ambiguities.empty());
+
+    EXPECT_EQ(GetoptTable::kAmbiguous, table.find("ver", 3, &ambiguities));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 6 }), ambiguities);
+    EXPECT_EQ(2, table.find("out", 3, nullptr));
+    EXPECT_EQ(GetoptTable::kAmbiguous, table.find("", 0, &ambiguities));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6 }), ambiguities);
+
+    EXPECT_STREQ("out-dir", table.long_option(3).name);
+    EXPECT_EQ(required_argument, table.long_option(3).has_arg);
+    EXPECT_EQ(&flag, table.long_option(5).flag);
+    EXPECT_EQ(1, table.long_option(5).val);
+}
+
+TEST(GetoptTable, Find_Cached) {
+    // Tables are cached by address, so the optstring must be the same array each time
+    static const char optstring[] = "ab:";
+    const std::shared_ptr<const GetoptTable> table = GetoptTable::Find(optstring, kOptions);
+    EXPECT_EQ(table, GetoptTable::Find(optstring, kOptions));
+    EXPECT_TRUE(table->matches(optstring, kOptions));
+    EXPECT_TRUE(table->matches("ab:", kOptions));
+    EXPECT_FALSE(table->matches("ab", kOptions));
+    EXPECT_FALSE(table->matches(optstring, nullptr));
+    EXPECT_FALSE(table->matches(optstring, kOptions + 1));
+    EXPECT_NE(table, GetoptTable::Find(optstring, nullptr));
+
+    // A different table at the same address is compiled again
+    struct option options[] = {
+        { "first", no_argument, nullptr, 1 },
+        { nullptr, 0, nullptr, 0 },
+    };
+    const std::shared_ptr<const GetoptTable> first = GetoptTable::Find(optstring, options);
+    EXPECT_EQ(0, first->find("first", 5, nullptr));
+    options[0].name = "second";
+    const std::shared_ptr<const GetoptTable> second = GetoptTable::Find(optstring, options);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(GetoptTable::kNotFound, second->find("first", 5, nullptr));
+    EXPECT_EQ(0, second->find("second", 6, nullptr));
+    EXPECT_EQ(second, GetoptTable::Find(optstring, options));
+}
+
+} // namespace internal
+} // namespace ahoy
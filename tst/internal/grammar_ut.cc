@@ -0,0 +1,570 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/grammar.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ahoy/internal/hash.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const char kProgram[] = "program";
+const char kValue[] = "value";
+
+// Copies |snapshot| into memory aligned for loading
+std::vector<std::uint64_t> Aligned(const std::string& snapshot) {
+    std::vector<std::uint64_t> aligned((snapshot.size() + 7) / 8, 0);
+    std::memcpy(aligned.data(), snapshot.data(), snapshot.size());
+    return aligned;
+}
+
+// Where the variadic byte of |node| is in a snapshot, given that nodes are 28 bytes long and
+// start at the offset stored 52 bytes into the header
+std::size_t VariadicOffset(const char* const bytes, const std::size_t node) {
+    std::uint32_t nodes;
+    std::memcpy(&nodes, bytes + 52, sizeof(nodes));
+    return nodes + node * 28 + 27;
+}
+
+// Recomputes the fingerprint of the snapshot at |bytes| after it was changed, so only the checks
+// on its contents can reject it
+void Refingerprint(char* const bytes, const std::size_t size) {
+    const std::uint64_t fingerprint = ahoy::internal::HashBytes(bytes + 24, size - 24);
+    std::memcpy(bytes + 16, &fingerprint, sizeof(fingerprint));
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(Grammar, Empty) {
+    const Grammar grammar;
+    std::string value;
+    EXPECT_EQ(0u, grammar.size());
+    EXPECT_EQ(-1, grammar.consume({ kValue }, 0, &value, nullptr));
+    EXPECT_LT(0u, grammar.memory_footprint());
+}
+
+TEST(Grammar, BreadthFirstOrder) {
+    std::string root_value, a, b, c, d;
+    Parameter root(&root_value, Name("root"));
+    root.withOptions(Parameter(&a, Name("a")).withOptions(Parameter(&c, Name("c"))),
+                     Parameter(&b, Name("b"), Description("second")))
+        .then(Parameter(&d, Name("d")));
+
+    const Grammar grammar(root);
+    ASSERT_EQ(5u, grammar.size());
+    EXPECT_EQ("root", grammar.name(0));
+    EXPECT_EQ("a", grammar.name(1));
+    EXPECT_EQ("b", grammar.name(2));
+    EXPECT_EQ("d", grammar.name(3));
+    EXPECT_EQ("c", grammar.name(4));
+    EXPECT_EQ("second", grammar.description(2));
+    EXPECT_EQ("", grammar.description(1));
+    EXPECT_EQ("", grammar.marker(1));
+}
+
+TEST(Grammar, RootStorage) {
+    std::string built_with, program, value;
+    Parameter root(&built_with);
+    root.withOptions(Parameter(&value, LongForms({"value"})));
+    const Grammar grammar(root);
+
+    EXPECT_EQ(3, grammar.consume({ kProgram, "--value", kValue }, 0, &program, nullptr));
+    EXPECT_EQ(kProgram, program);
+    EXPECT_EQ(kValue, value);
+    EXPECT_EQ("", built_with);
+
+    const Grammar options({ Parameter(&value, LongForms({"value"})) }, {});
+    ASSERT_EQ(2u, options.size());
+    EXPECT_EQ(2, options.consume({ kProgram, "--value=other" }, 0, &program, nullptr));
+    EXPECT_EQ("other", value);
+}
+
+TEST(Grammar, MultipleRequiredNexts) {
+    std::string value;
+    Parameter root(&value);
+    root.then(Parameter(&value, Required()), Parameter(&value, Required()));
+    EXPECT_EQ(-1, Grammar(root).consume({ kValue, kValue }, 0, &value, nullptr));
+}
+
+TEST(Grammar, InternsStrings) {
+    std::string value;
+    std::vector<Parameter> distinct;
+    std::vector<Parameter> shared;
+    for (int i = 0; i < 50; i++) {
+        const std::string suffix = std::to_string(i);
+        distinct.push_back(Parameter(&value, LongForms({"form" + suffix}),
+                Description("A parameter with its own description " + suffix)));
+        shared.push_back(Parameter(&value, LongForms({"form" + suffix}),
+                Description("A parameter with the same description as the others")));
+    }
+
+    const Grammar distinct_grammar(distinct, {});
+    const Grammar shared_grammar(shared, {});
+    EXPECT_EQ(distinct_grammar.size(), shared_grammar.size());
+    EXPECT_GT(distinct_grammar.memory_footprint(), shared_grammar.memory_footprint());
+    EXPECT_GT(shared_grammar.memory_footprint(), Grammar().memory_footprint());
+}
+
+TEST(Grammar, Reserve) {
+    std::string program;
+    std::vector<int> numbers;
+    const Grammar grammar({ Parameter(&numbers, ShortForms({"n"})) }, {});
+
+    const std::vector<std::string> args{ kProgram, "-n", "1", "-n=2", "-nn", "-n" };
+    grammar.reserve(args, &program);
+    EXPECT_LE(3u, numbers.capacity());
+    EXPECT_TRUE(numbers.empty());
+}
+
+TEST(Grammar, Suggest) {
+    std::string value;
+    const Grammar grammar({ Parameter(&value, LongForms({"port", "sort"})),
+                            Parameter(&value, LongForms({"part", "portal"})),
+                            Parameter(&value, LongForms({"port"}), ShortForms({"p"})) }, {});
+
+    EXPECT_EQ(std::vector<std::string>({ "--part", "--port", "--sort" }),
+              grammar.suggest("--prt", 5));
+    EXPECT_EQ(std::vector<std::string>({ "--part", "--port" }), grammar.suggest("--prt=1", 2));
+    EXPECT_EQ(std::vector<std::string>({ "--part", "--sort", "--portal" }),
+              grammar.suggest("--port", 5));
+    EXPECT_EQ(std::vector<std::string>({ "-p" }), grammar.suggest("-q", 5));
+    EXPECT_TRUE(grammar.suggest("--unrelated", 5).empty());
+    EXPECT_TRUE(grammar.suggest("--prt", 0).empty());
+    EXPECT_TRUE(Grammar().suggest("--prt", 5).empty());
+}
+
+TEST(Grammar, Flat) {
+    std::string program, name;
+    int verbosity = 0, number = 0;
+    bool quiet = false;
+    std::vector<std::string> items;
+    const std::vector<Parameter> options{
+        Parameter(&verbosity, ShortForms({"v"}), LongForms({"verbose"}), Count()),
+        Parameter(&name, ShortForms({"n"}), LongForms({"name"}), Required()),
+        Parameter(&quiet, ShortForms({"q"}), Flag()),
+        Parameter(&items, LongForms({"item", "i"})),
+        Parameter(&number),
+        Parameter(&name, LongForms({"name", "alias"})),
+    };
+    const Grammar flat(options, {});
+    // An optional next that never matches leaves the grammar's behavior as is but stops it being
+    // flat, so it is consumed by the generic engine
+    bool never = false;
+    const Grammar generic(options, { Parameter(&never, LongForms({"never"}), Flag()) });
+
+    const std::vector<std::string> tokens{ "-v", "-vv", "-vxv", "--verbose", "-n", "--name",
+                                           "--name=a", "--alias", "--alias=b=c", "-q", "-q=1",
+                                           "--item", "--item=x", "--i", "--i=", "1", "-2", "x" };
+    std::mt19937 random(7);
+    for (int run = 0; run < 2000; run++) {
+        std::vector<std::string> args{ kProgram };
+        const int size = random() % 8;
+        for (int i = 0; i < size; i++) {
+            args.push_back(tokens[random() % tokens.size()]);
+        }
+
+        const auto consume = [&](const Grammar& grammar) {
+            name.clear();
+            verbosity = 0;
+            number = 0;
+            quiet = false;
+            items.clear();
+            ParseState state;
+            const size_t consumed = grammar.consume(args, 0, &program, &state);
+            std::ostringstream values;
+            values << consumed << ' ' << program << ' ' << name << ' ' << verbosity << ' '
+                   << number << ' ' << quiet << ' ' << items.size() << ' ' << state.reached();
+            for (const std::string& item : items) {
+                values << ' ' << item;
+            }
+            return values.str();
+        };
+        EXPECT_EQ(consume(generic), consume(flat));
+    }
+
+    // Only the options an argument can match are tried
+    const std::vector<std::string> args{ kProgram, "-n", "a", "-q", "--item", "x", "--item=y" };
+    ParseState flat_state, generic_state;
+    EXPECT_EQ(7, flat.consume(args, 0, &program, &flat_state));
+    EXPECT_EQ(7, generic.consume(args, 0, &program, &generic_state));
+    EXPECT_LT(flat_state.steps(), generic_state.steps());
+}
+
+TEST(Grammar, Reorder) {
+    std::string program, name, mode;
+    int number = 0;
+    bool quiet = false, force = false;
+    std::vector<std::string> items;
+    // Every option matches by its forms alone, so any order of them parses alike, and the next
+    // keeps the grammar from being flat
+    const std::vector<Parameter> options{
+        Parameter(&name, ShortForms({"n"}), LongForms({"name"}), Required()),
+        Parameter(&quiet, ShortForms({"q"}), Flag()),
+        Parameter(&items, LongForms({"item", "i"})),
+        Parameter(&number, LongForms({"number"})),
+        Parameter(&force, ShortForms({"f"}), LongForms({"force"}), Flag()),
+    };
+    const std::vector<Parameter> nexts{ Parameter(&mode, LongForms({"mode"})) };
+    const Grammar original(options, nexts);
+
+    const std::vector<std::string> tokens{ "-n", "--name", "--name=a", "-q", "-q=1", "--item",
+                                           "--item=x", "--i", "--i=", "--number", "--number=3",
+                                           "-f", "--force", "--mode", "--mode=m", "1", "x" };
+    std::mt19937 random(11);
+    for (int run = 0; run < 500; run++) {
+        std::vector<unsigned long long> hits(original.size());
+        for (unsigned long long& count : hits) {
+            count = random() % 4;
+        }
+        Grammar reordered = original;
+        reordered.reorder(hits);
+
+        std::vector<std::string> args{ kProgram };
+        const int size = random() % 8;
+        for (int i = 0; i < size; i++) {
+            args.push_back(tokens[random() % tokens.size()]);
+        }
+
+        const auto consume = [&](const Grammar& grammar) {
+            name.clear();
+            mode.clear();
+            number = 0;
+            quiet = false;
+            force = false;
+            items.clear();
+            ParseState state;
+            const size_t consumed = grammar.consume(args, 0, &program, &state);
+            std::ostringstream values;
+            values << consumed << ' ' << program << ' ' << name << ' ' << mode << ' ' << number
+                   << ' ' << quiet << ' ' << force << ' ' << items.size() << ' '
+                   << state.reached();
+            for (const std::string& item : items) {
+                values << ' ' << item;
+            }
+            return values.str();
+        };
+        EXPECT_EQ(consume(original), consume(reordered));
+    }
+
+    // The option that matched most is tried first
+    std::vector<unsigned long long> hits(original.size(), 0);
+    hits[5] = 10;
+    Grammar reordered = original;
+    reordered.reorder(hits);
+    const std::vector<std::string> args{ kProgram, "-n", "a", "--force" };
+    ParseState original_state, reordered_state;
+    EXPECT_EQ(4, original.consume(args, 0, &program, &original_state));
+    EXPECT_EQ(4, reordered.consume(args, 0, &program, &reordered_state));
+    EXPECT_LT(reordered_state.steps(), original_state.steps());
+    EXPECT_TRUE(force);
+
+    // The order is not part of the snapshot, so loading it restores the order of the parameters
+    const std::vector<std::uint64_t> image = Aligned(reordered.snapshot());
+    Grammar loaded;
+    ASSERT_TRUE(loaded.load(image.data(), image.size() * 8));
+    EXPECT_EQ(original.fingerprint(), loaded.fingerprint());
+    ParseState loaded_state;
+    EXPECT_EQ(4, loaded.consume(args, 0, &program, &loaded_state));
+    EXPECT_EQ(original_state.steps(), loaded_state.steps());
+}
+
+TEST(Grammar, ReorderUnsafeSiblings) {
+    std::string program, a, b, value;
+    // A positional option could take an argument meant for a later option, so none of these move
+    const Grammar original({ Parameter(&a, LongForms({"a"})),
+                             Parameter(&value),
+                             Parameter(&b, LongForms({"b"})) },
+                           { Parameter(&value, LongForms({"c"})) });
+    Grammar reordered = original;
+    std::vector<unsigned long long> hits(original.size(), 0);
+    hits[3] = 10;
+    reordered.reorder(hits);
+
+    const std::vector<std::string> args{ kProgram, "--b", "1", "--a", "2", "x" };
+    ParseState original_state, reordered_state;
+    const size_t consumed = original.consume(args, 0, &program, &original_state);
+    const std::string values = a + ' ' + b + ' ' + value;
+    a.clear();
+    b.clear();
+    value.clear();
+    EXPECT_EQ(consumed, reordered.consume(args, 0, &program, &reordered_state));
+    EXPECT_EQ(values, a + ' ' + b + ' ' + value);
+    EXPECT_EQ(original_state.steps(), reordered_state.steps());
+}
+
+TEST(Grammar, Environment) {
+    std::string program, a, b, c;
+    const Grammar grammar({ Parameter(&a, LongForms({"a"}), EnvVar("A")),
+                            Parameter(&b, LongForms({"b"}), EnvVar("B")),
+                            Parameter(&c, LongForms({"c"}), EnvVar("A")) }, {});
+    EXPECT_TRUE(Grammar({ Parameter(&a) }, {}).environment(nullptr).empty());
+    const char* no_variables[] = { nullptr };
+    EXPECT_EQ(std::vector<const char*>(4, nullptr), grammar.environment(no_variables));
+
+    const char* variables[] = { "AB=1", "B", "A=x", "B=y=z", "A=w", "=v", nullptr };
+    const std::vector<const char*> values = grammar.environment(variables);
+    ASSERT_EQ(4u, values.size());
+    EXPECT_EQ(nullptr, values[0]);
+    EXPECT_STREQ("x", values[1]);
+    EXPECT_STREQ("y=z", values[2]);
+    EXPECT_STREQ("x", values[3]);
+
+    ParseState state;
+    state.environment(&values);
+    EXPECT_EQ(3, grammar.consume({ kProgram, "--b", kValue }, 0, &program, &state));
+    EXPECT_EQ("x", a);
+    EXPECT_EQ(kValue, b);
+    EXPECT_EQ("x", c);
+}
+
+TEST(Grammar, Paths) {
+    std::string program, input, output, plain;
+    std::vector<std::string> dirs;
+    const Grammar grammar({ Parameter(&input, Name("input"), LongForms({"in"}),
+                                      Path(PathKind::EXISTING_FILE)),
+                            Parameter(&output, Name("output"), LongForms({"out"}),
+                                      Path(PathKind::CREATABLE)),
+                            Parameter(&plain, LongForms({"plain"})),
+                            Parameter(&dirs, Name("dirs"), LongForms({"dir"}),
+                                      Path(PathKind::EXISTING_DIRECTORY)) }, {});
+    EXPECT_TRUE(grammar.has_paths());
+    EXPECT_FALSE(Grammar({ Parameter(&plain) }, {}).has_paths());
+
+    // Only matched parameters are checked
+    ParseState state;
+    state.track(grammar.size());
+    EXPECT_EQ(6, grammar.consume({ kProgram, "--in=a", "--dir", "b", "--dir=c", "--plain=d" }, 0,
+                                 &program, &state));
+    const std::vector<PathRequest> requests = grammar.paths(state);
+    ASSERT_EQ(3u, requests.size());
+    EXPECT_EQ(1u, requests[0].node);
+    EXPECT_EQ(PathKind::EXISTING_FILE, requests[0].kind);
+    EXPECT_EQ("a", requests[0].path);
+    EXPECT_EQ(4u, requests[1].node);
+    EXPECT_EQ(PathKind::EXISTING_DIRECTORY, requests[1].kind);
+    EXPECT_EQ("b", requests[1].path);
+    EXPECT_EQ("c", requests[2].path);
+
+    // Snapshots keep the kinds, and unbound parameters are skipped
+    const std::string snapshot = grammar.snapshot();
+    const std::vector<std::uint64_t> image = Aligned(snapshot);
+    Grammar loaded;
+    ASSERT_TRUE(loaded.load(image.data(), snapshot.size()));
+    EXPECT_TRUE(loaded.has_paths());
+    std::string loaded_output;
+    EXPECT_TRUE(loaded.bind("output", &loaded_output));
+    ParseState loaded_state;
+    loaded_state.track(loaded.size());
+    EXPECT_EQ(5, loaded.consume({ kProgram, "--in", "a", "--out", "e" }, 0, &program,
+                                &loaded_state));
+    const std::vector<PathRequest> loaded_requests = loaded.paths(loaded_state);
+    ASSERT_EQ(1u, loaded_requests.size());
+    EXPECT_EQ(PathKind::CREATABLE, loaded_requests[0].kind);
+    EXPECT_EQ("e", loaded_requests[0].path);
+}
+
+TEST(Grammar, Replay) {
+    std::string program, name;
+    double ratio = 0;
+    int verbosity = 0;
+    bool flag = false;
+    std::vector<int> numbers;
+    Properties properties;
+    enum class Mode : int { FAST = 1, SLOW = 2 };
+    Mode mode = Mode::FAST;
+    const Grammar grammar({ Parameter(&name, LongForms({"name"})),
+                            Parameter(&ratio, LongForms({"ratio"})),
+                            Parameter(&verbosity, ShortForms({"v"}), Count()),
+                            Parameter(&flag, LongForms({"flag"}), Flag()),
+                            Parameter(&numbers, ShortForms({"n"})),
+                            Parameter(&properties, ShortForms({"D"})),
+                            Parameter(&mode, LongForms({"mode"}),
+                                      Choices({ { "fast", Mode::FAST }, { "slow", Mode::SLOW } })) },
+                          {});
+    const std::vector<std::string> args{ kProgram, "--name", kValue, "--ratio=0.5", "-vv", "--flag",
+                                         "-n", "1", "-n", "2", "-Da=b", "--mode=slow" };
+
+    StoreLog log;
+    ParseState state;
+    state.log(&log);
+    EXPECT_EQ(12, grammar.consume(args, 0, &program, &state));
+    EXPECT_EQ(9u, log.stores().size());
+
+    // Replays onto the values left by the parse, so appends and counts add up again
+    name.clear();
+    ratio = 0;
+    flag = false;
+    mode = Mode::FAST;
+    std::string replayed_program;
+    ParseState replay_state;
+    EXPECT_TRUE(grammar.replay(log, &replayed_program, &replay_state));
+    EXPECT_EQ(kProgram, replayed_program);
+    EXPECT_EQ(kValue, name);
+    EXPECT_EQ(0.5, ratio);
+    EXPECT_EQ(4, verbosity);
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 1, 2 }), numbers);
+    EXPECT_EQ("b", properties.get("a"));
+    EXPECT_EQ(Mode::SLOW, mode);
+
+    // Nothing is recorded without a log
+    ParseState unlogged;
+    EXPECT_EQ(12, grammar.consume(args, 0, &program, &unlogged));
+    EXPECT_EQ(9u, log.stores().size());
+}
+
+TEST(Grammar, Snapshot) {
+    std::string program, name;
+    int count = 0;
+    std::vector<int> numbers;
+    enum class Mode : int { FAST = 1, SLOW = 2 };
+    Mode mode = Mode::FAST;
+    const Grammar built({ Parameter(&name, Name("name"), LongForms({"name"})),
+                          Parameter(&count, Name("count"), ShortForms({"c"}), Required()),
+                          Parameter(&numbers, Name("numbers"), ShortForms({"n"})),
+                          Parameter(&mode, Name("mode"), LongForms({"mode"}),
+                                    Choices({ { "fast", Mode::FAST }, { "slow", Mode::SLOW } })) },
+                        {});
+    const std::string snapshot = built.snapshot();
+    ASSERT_FALSE(snapshot.empty());
+    EXPECT_EQ(0u, snapshot.size() % 8);
+    EXPECT_EQ(snapshot, Grammar(built).snapshot());
+
+    const std::vector<std::uint64_t> image = Aligned(snapshot);
+    Grammar loaded;
+    ASSERT_TRUE(loaded.load(image.data(), snapshot.size()));
+    EXPECT_EQ(built.fingerprint(), loaded.fingerprint());
+    EXPECT_EQ(built.size(), loaded.size());
+    EXPECT_EQ("count", loaded.name(2));
+
+    const std::vector<std::string> args{ kProgram, "--name", kValue, "-c", "3", "-n", "1",
+                                         "-n", "2", "--mode=slow" };
+    // Values of unbound parameters are checked but dropped
+    EXPECT_EQ(10, loaded.consume(args, 0, &program, nullptr));
+    EXPECT_EQ(-1, loaded.consume({ kProgram, "-c", "three" }, 0, &program, nullptr));
+    // Stops before the unknown choice
+    EXPECT_EQ(3, loaded.consume({ kProgram, "-c", "3", "--mode=medium" }, 0, &program, nullptr));
+    EXPECT_EQ("", name);
+
+    std::string loaded_name;
+    int loaded_count = 0;
+    std::vector<int> loaded_numbers;
+    Mode loaded_mode = Mode::FAST;
+    EXPECT_TRUE(loaded.bind("name", &loaded_name));
+    EXPECT_TRUE(loaded.bind("count", &loaded_count));
+    EXPECT_TRUE(loaded.bind("numbers", &loaded_numbers));
+    EXPECT_TRUE(loaded.bind("mode", &loaded_mode));
+    EXPECT_EQ(10, loaded.consume(args, 0, &program, nullptr));
+    EXPECT_EQ(kProgram, program);
+    EXPECT_EQ(kValue, loaded_name);
+    EXPECT_EQ(3, loaded_count);
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), loaded_numbers);
+    EXPECT_EQ(Mode::SLOW, loaded_mode);
+    EXPECT_TRUE(numbers.empty());
+    EXPECT_EQ(Mode::FAST, mode);
+}
+
+TEST(Grammar, SnapshotFingerprint) {
+    std::string value;
+    const Grammar first({ Parameter(&value, LongForms({"value"})) }, {});
+    const Grammar second({ Parameter(&value, LongForms({"value"})) }, {});
+    const Grammar changed({ Parameter(&value, LongForms({"values"})) }, {});
+    EXPECT_NE(0u, first.fingerprint());
+    EXPECT_EQ(first.fingerprint(), second.fingerprint());
+    EXPECT_NE(first.fingerprint(), changed.fingerprint());
+    EXPECT_EQ(0u, Grammar().fingerprint());
+    EXPECT_EQ("", Grammar().snapshot());
+}
+
+TEST(Grammar, SnapshotRejected) {
+    std::string value;
+    Grammar grammar({ Parameter(&value, LongForms({"value"})) }, {});
+    const std::string snapshot = grammar.snapshot();
+    const std::uint64_t fingerprint = grammar.fingerprint();
+
+    std::vector<std::uint64_t> image = Aligned(snapshot);
+    EXPECT_FALSE(grammar.load(nullptr, 0));
+    EXPECT_FALSE(grammar.load(image.data(), snapshot.size() - 8));
+    EXPECT_FALSE(grammar.load(image.data(), 16));
+    // Misaligned
+    std::vector<std::uint64_t> shifted(image.size() + 1, 0);
+    std::memcpy(reinterpret_cast<char*>(shifted.data()) + 1, snapshot.data(), snapshot.size());
+    EXPECT_FALSE(grammar.load(reinterpret_cast<char*>(shifted.data()) + 1, snapshot.size()));
+
+    // Every flipped byte is caught by the checks on the header or by the fingerprint
+    char* const bytes = reinterpret_cast<char*>(image.data());
+    for (std::size_t i = 0; i < snapshot.size(); i++) {
+        bytes[i] ^= 0x40;
+        EXPECT_FALSE(grammar.load(image.data(), snapshot.size())) << i;
+        bytes[i] ^= 0x40;
+    }
+
+    // A different version
+    std::uint32_t version;
+    std::memcpy(&version, bytes + 12, sizeof(version));
+    EXPECT_EQ(Grammar::kSnapshotVersion, version);
+    version++;
+    std::memcpy(bytes + 12, &version, sizeof(version));
+    EXPECT_FALSE(grammar.load(image.data(), snapshot.size()));
+
+    EXPECT_EQ(fingerprint, grammar.fingerprint());
+    EXPECT_EQ(snapshot, grammar.snapshot());
+}
+
+TEST(Grammar, SnapshotRejectedVariadic) {
+    std::string value;
+    std::vector<std::string> values, named;
+    const Grammar grammar({ Parameter(&value, Name("value")),
+                            Parameter(&named, LongForms({"named"})),
+                            Parameter(&values, Name("values"), Variadic()) }, {});
+    const std::string snapshot = grammar.snapshot();
+    std::vector<std::uint64_t> image = Aligned(snapshot);
+    char* const bytes = reinterpret_cast<char*>(image.data());
+    Grammar loaded;
+    Refingerprint(bytes, snapshot.size());
+    ASSERT_TRUE(loaded.load(image.data(), snapshot.size()));
+    ASSERT_EQ(1, bytes[VariadicOffset(bytes, 3)]);
+
+    // Neither a single value, a repeated option with forms, nor any other byte may be variadic
+    for (const std::size_t node : { 1, 2 }) {
+        bytes[VariadicOffset(bytes, node)] = 1;
+        Refingerprint(bytes, snapshot.size());
+        EXPECT_FALSE(loaded.load(image.data(), snapshot.size())) << node;
+        bytes[VariadicOffset(bytes, node)] = 0;
+    }
+    bytes[VariadicOffset(bytes, 3)] = 2;
+    Refingerprint(bytes, snapshot.size());
+    EXPECT_FALSE(loaded.load(image.data(), snapshot.size()));
+}
+
+TEST(Grammar, BindMismatch) {
+    std::string program, value;
+    std::vector<std::string> values;
+    const Grammar built({ Parameter(&value, Name("value")),
+                          Parameter(&values, Name("values"), ShortForms({"v"})) }, {});
+    const std::string snapshot = built.snapshot();
+    const std::vector<std::uint64_t> image = Aligned(snapshot);
+    Grammar loaded;
+    ASSERT_TRUE(loaded.load(image.data(), snapshot.size()));
+
+    int number;
+    EXPECT_FALSE(loaded.bind("unknown", &value));
+    EXPECT_FALSE(loaded.bind("value", &number));
+    EXPECT_FALSE(loaded.bind("value", &values));
+    EXPECT_FALSE(loaded.bind("values", &value));
+    EXPECT_TRUE(loaded.bind("values", &values));
+}
+
+} // namespace internal
+} // namespace ahoy
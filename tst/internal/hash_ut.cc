@@ -0,0 +1,50 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/hash.h"
+
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+TEST(Hash, HashBytes) {
+    const std::string value = "Value";
+    EXPECT_EQ(HashBytes(value.data(), value.size()), HashBytes("Value", 5));
+    EXPECT_NE(HashBytes("Value", 5), HashBytes("value", 5));
+    EXPECT_NE(HashBytes("Value", 5), HashBytes("Value", 4));
+    EXPECT_NE(HashBytes("", 0), HashBytes("\0", 1));
+
+    std::set<std::uint64_t> hashes;
+    for (int i = 0; i < 1000; i++) {
+        const std::string s = std::to_string(i);
+        hashes.insert(HashBytes(s.data(), s.size()));
+    }
+    EXPECT_EQ(1000u, hashes.size());
+}
+
+TEST(Hash, HashBytes_CaseInsensitive) {
+    EXPECT_EQ(HashBytes("VaLuE-1", 7, true), HashBytes("value-1", 7, true));
+    EXPECT_EQ(HashBytes("value-1", 7, false), HashBytes("value-1", 7, true));
+    EXPECT_NE(HashBytes("value-1", 7, true), HashBytes("value_1", 7, true));
+}
+
+TEST(Hash, Mix64) {
+    EXPECT_EQ(0u, Mix64(0));
+    EXPECT_NE(Mix64(1), Mix64(2));
+    EXPECT_NE(1u, Mix64(1));
+}
+
+TEST(Hash, ToLowerAscii) {
+    EXPECT_EQ('a', ToLowerAscii('A'));
+    EXPECT_EQ('z', ToLowerAscii('Z'));
+    EXPECT_EQ('a', ToLowerAscii('a'));
+    EXPECT_EQ('-', ToLowerAscii('-'));
+    EXPECT_EQ('\xC3', ToLowerAscii('\xC3'));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,74 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/hit_counters.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+TEST(HitCounters, Hit) {
+    HitCounters counters(3);
+    EXPECT_FALSE(counters.disabled());
+    EXPECT_EQ(3u, counters.size());
+
+    counters.hit(0);
+    counters.hit(2);
+    counters.hit(2);
+    // Nodes past the end are ignored
+    counters.hit(3);
+    EXPECT_EQ(1u, counters.hits(0));
+    EXPECT_EQ(0u, counters.hits(1));
+    EXPECT_EQ(2u, counters.hits(2));
+    EXPECT_EQ(0u, counters.hits(3));
+    EXPECT_EQ(std::vector<unsigned long long>({ 1, 0, 2 }), counters.counts());
+
+    counters.clear();
+    EXPECT_EQ(std::vector<unsigned long long>({ 0, 0, 0 }), counters.counts());
+}
+
+TEST(HitCounters, Disabled) {
+    HitCounters counters;
+    EXPECT_TRUE(counters.disabled());
+    counters.hit(0);
+    EXPECT_EQ(0u, counters.hits(0));
+    EXPECT_TRUE(counters.counts().empty());
+}
+
+TEST(HitCounters, Copy) {
+    HitCounters counters(2);
+    counters.hit(1);
+
+    const HitCounters copy(counters);
+    EXPECT_EQ(2u, copy.size());
+    EXPECT_EQ(0u, copy.hits(1));
+
+    HitCounters assigned;
+    assigned = counters;
+    EXPECT_EQ(2u, assigned.size());
+    EXPECT_EQ(0u, assigned.hits(1));
+    EXPECT_EQ(1u, counters.hits(1));
+}
+
+TEST(HitCounters, Threads) {
+    HitCounters counters(1);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&counters]() {
+            for (int j = 0; j < 1000; j++) {
+                counters.hit(0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(4000u, counters.hits(0));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,104 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/parse_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+namespace {
+
+// A log holding a single value for node 0
+std::shared_ptr<const StoreLog> Log(const std::string& value) {
+    std::shared_ptr<StoreLog> log = std::make_shared<StoreLog>();
+    log->value(0, value);
+    return log;
+}
+
+} // namespace
+
+TEST(ParseCache, Key) {
+    const char* const a[] = { "program", "ab", "c" };
+    const char* const b[] = { "program", "a", "bc" };
+    const std::vector<const char*> none;
+    EXPECT_EQ(ParseCache::Key(3, a, none), ParseCache::Key(3, a, none));
+    EXPECT_NE(ParseCache::Key(3, a, none), ParseCache::Key(3, b, none));
+    EXPECT_NE(ParseCache::Key(3, a, none), ParseCache::Key(2, a, none));
+
+    // Environment variables are part of the key, but only those that are set
+    const std::vector<const char*> unset(3, nullptr);
+    const std::vector<const char*> first{ nullptr, "1", nullptr };
+    const std::vector<const char*> second{ nullptr, nullptr, "1" };
+    EXPECT_EQ(ParseCache::Key(3, a, none), ParseCache::Key(3, a, unset));
+    EXPECT_NE(ParseCache::Key(3, a, first), ParseCache::Key(3, a, second));
+    EXPECT_NE(ParseCache::Key(3, a, none), ParseCache::Key(3, a, first));
+}
+
+TEST(ParseCache, FindAndInsert) {
+    ParseCache cache(2);
+    EXPECT_FALSE(cache.disabled());
+    EXPECT_EQ(nullptr, cache.find("a"));
+    cache.insert("a", Log("1"));
+    cache.insert("b", Log("2"));
+    ASSERT_NE(nullptr, cache.find("a"));
+    EXPECT_EQ("1", cache.find("a")->stores()[0].data);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(2u, cache.hits());
+    EXPECT_EQ(1u, cache.misses());
+
+    // Replaces the entry for a key already present
+    cache.insert("a", Log("3"));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ("3", cache.find("a")->stores()[0].data);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(nullptr, cache.find("a"));
+    EXPECT_EQ(3u, cache.hits());
+    EXPECT_EQ(2u, cache.misses());
+}
+
+TEST(ParseCache, EvictsLeastRecentlyUsed) {
+    ParseCache cache(2);
+    cache.insert("a", Log("1"));
+    cache.insert("b", Log("2"));
+    EXPECT_NE(nullptr, cache.find("a"));
+    cache.insert("c", Log("3"));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_NE(nullptr, cache.find("a"));
+    EXPECT_EQ(nullptr, cache.find("b"));
+    EXPECT_NE(nullptr, cache.find("c"));
+}
+
+TEST(ParseCache, Disabled) {
+    ParseCache cache;
+    EXPECT_TRUE(cache.disabled());
+    cache.insert("a", Log("1"));
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(nullptr, cache.find("a"));
+}
+
+TEST(ParseCache, Copy) {
+    ParseCache cache(4);
+    cache.insert("a", Log("1"));
+    EXPECT_NE(nullptr, cache.find("a"));
+
+    const ParseCache copy(cache);
+    EXPECT_EQ(4u, copy.capacity());
+    EXPECT_EQ(0u, copy.size());
+    EXPECT_EQ(0u, copy.hits());
+
+    ParseCache assigned;
+    assigned = cache;
+    EXPECT_EQ(4u, assigned.capacity());
+    EXPECT_EQ(0u, assigned.size());
+}
+
+} // namespace internal
+} // namespace ahoy
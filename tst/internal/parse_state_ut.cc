@@ -0,0 +1,155 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/parse_state.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "ahoy/internal/hit_counters.h"
+#include "ahoy/internal/store_log.h"
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+TEST(ParseState, Unlimited) {
+    ParseState state;
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(state.step());
+    }
+    EXPECT_FALSE(state.aborted());
+    EXPECT_EQ(ParseError::NONE, state.error());
+    EXPECT_EQ(1000u, state.steps());
+}
+
+TEST(ParseState, StepBudget) {
+    ParseState state(3, std::chrono::nanoseconds::zero(), nullptr);
+    EXPECT_TRUE(state.step());
+    EXPECT_TRUE(state.step());
+    EXPECT_TRUE(state.step());
+    EXPECT_FALSE(state.aborted());
+    EXPECT_FALSE(state.step());
+    EXPECT_TRUE(state.aborted());
+    EXPECT_EQ(ParseError::STEP_BUDGET_EXCEEDED, state.error());
+
+    // Once aborted, steps are no longer counted
+    EXPECT_FALSE(state.step());
+    EXPECT_EQ(4u, state.steps());
+}
+
+TEST(ParseState, Deadline) {
+    ParseState expired(0, std::chrono::nanoseconds(1), nullptr);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() == start) {}
+    EXPECT_FALSE(expired.step());
+    EXPECT_EQ(ParseError::DEADLINE_EXCEEDED, expired.error());
+
+    ParseState unexpired(0, std::chrono::hours(1), nullptr);
+    EXPECT_TRUE(unexpired.step());
+}
+
+TEST(ParseState, Cancellation) {
+    std::atomic<bool> cancelled(false);
+    ParseState state(0, std::chrono::nanoseconds::zero(), &cancelled);
+    EXPECT_TRUE(state.step());
+
+    // The flag is polled periodically so it may take some steps to notice
+    cancelled = true;
+    int steps = 0;
+    while (state.step()) {
+        steps++;
+        ASSERT_LT(steps, 1000);
+    }
+    EXPECT_EQ(ParseError::CANCELLED, state.error());
+}
+
+TEST(ParseState, Probe) {
+    ParseState state;
+    EXPECT_EQ(nullptr, state.probes());
+
+    std::vector<std::uint8_t> probes(3, 0);
+    state.probe(2, &probes);
+    EXPECT_EQ(&probes, state.probes());
+    EXPECT_EQ(2u, state.probe_position());
+    EXPECT_TRUE(state.step());
+}
+
+TEST(ParseState, Reach) {
+    ParseState state;
+    EXPECT_EQ(0u, state.reached());
+    state.reach(3);
+    state.reach(1);
+    EXPECT_EQ(3u, state.reached());
+}
+
+TEST(ParseState, Environment) {
+    ParseState state;
+    state.match(0);
+    EXPECT_EQ(nullptr, state.variable(0));
+    EXPECT_FALSE(state.matched(0));
+
+    const std::vector<const char*> values{ nullptr, "8080" };
+    state.environment(&values);
+    EXPECT_EQ(nullptr, state.variable(0));
+    EXPECT_STREQ("8080", state.variable(1));
+    EXPECT_EQ(nullptr, state.variable(2));
+
+    state.match(1);
+    state.match(2);
+    EXPECT_FALSE(state.matched(0));
+    EXPECT_TRUE(state.matched(1));
+    EXPECT_FALSE(state.matched(2));
+}
+
+TEST(ParseState, Track) {
+    ParseState state;
+    state.match(1);
+    EXPECT_FALSE(state.matched(1));
+
+    state.track(3);
+    state.match(1);
+    state.match(3);
+    EXPECT_FALSE(state.matched(0));
+    EXPECT_TRUE(state.matched(1));
+    EXPECT_FALSE(state.matched(3));
+}
+
+TEST(ParseState, Argv) {
+    const char* const argv[] = { "./program", "-Da=b" };
+    ParseState state;
+    EXPECT_EQ(nullptr, state.argv());
+    state.argv(argv);
+    EXPECT_EQ(argv, state.argv());
+}
+
+TEST(ParseState, Log) {
+    StoreLog log;
+    ParseState state;
+    EXPECT_EQ(nullptr, state.log());
+    state.log(&log);
+    EXPECT_EQ(&log, state.log());
+    state.log(nullptr);
+    EXPECT_EQ(nullptr, state.log());
+}
+
+TEST(ParseState, Hit) {
+    HitCounters counters(2);
+    ParseState state;
+    state.hit(1);
+    state.counters(&counters);
+    state.hit(1);
+    EXPECT_EQ(1u, counters.hits(1));
+
+    // Dry runs are not counted
+    std::vector<std::uint8_t> probes(2, 0);
+    state.probe(0, &probes);
+    state.hit(1);
+    EXPECT_EQ(1u, counters.hits(1));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,111 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/path_check.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+namespace {
+
+// Creates a directory holding a file named "file", a directory named "dir" and a directory named
+// "locked" that cannot be written to, and removes them all once the test is done
+class PathCheckTest : public ::testing::Test {
+  protected:
+    PathCheckTest() : root_() {}
+
+    void SetUp() override {
+        const char* const tmp = std::getenv("TEST_TMPDIR");
+        std::string path = std::string(tmp != nullptr ? tmp : "/tmp") + "/path_check_XXXXXX";
+        ASSERT_NE(nullptr, ::mkdtemp(&path[0]));
+        root_ = path;
+
+        std::FILE* const file = std::fopen(in("file").c_str(), "w");
+        ASSERT_NE(nullptr, file);
+        std::fclose(file);
+        ASSERT_EQ(0, ::mkdir(in("dir").c_str(), 0700));
+        ASSERT_EQ(0, ::mkdir(in("locked").c_str(), 0500));
+    }
+
+    void TearDown() override {
+        ::unlink(in("file").c_str());
+        ::rmdir(in("dir").c_str());
+        ::rmdir(in("locked").c_str());
+        ::rmdir(root_.c_str());
+    }
+
+    // The path of |name| in the directory
+    std::string in(const std::string& name) const {
+        return root_ + "/" + name;
+    }
+
+    std::string root_;
+};
+
+} // namespace
+
+TEST_F(PathCheckTest, Any) {
+    EXPECT_EQ("", CheckPath(in("missing"), PathKind::ANY));
+    EXPECT_EQ("", CheckPath("", PathKind::ANY));
+}
+
+TEST_F(PathCheckTest, ExistingFile) {
+    EXPECT_EQ("", CheckPath(in("file"), PathKind::EXISTING_FILE));
+    EXPECT_EQ("is a directory", CheckPath(in("dir"), PathKind::EXISTING_FILE));
+    EXPECT_EQ("does not exist", CheckPath(in("missing"), PathKind::EXISTING_FILE));
+    EXPECT_EQ("does not exist", CheckPath(in("file/child"), PathKind::EXISTING_FILE));
+    EXPECT_EQ("is empty", CheckPath("", PathKind::EXISTING_FILE));
+}
+
+TEST_F(PathCheckTest, ExistingDirectory) {
+    EXPECT_EQ("", CheckPath(in("dir"), PathKind::EXISTING_DIRECTORY));
+    EXPECT_EQ("", CheckPath(in("dir/"), PathKind::EXISTING_DIRECTORY));
+    EXPECT_EQ("is not a directory", CheckPath(in("file"), PathKind::EXISTING_DIRECTORY));
+    EXPECT_EQ("does not exist", CheckPath(in("missing"), PathKind::EXISTING_DIRECTORY));
+}
+
+TEST_F(PathCheckTest, Creatable) {
+    EXPECT_EQ("", CheckPath(in("file"), PathKind::CREATABLE));
+    EXPECT_EQ("", CheckPath(in("new"), PathKind::CREATABLE));
+    EXPECT_EQ("", CheckPath(in("dir/new"), PathKind::CREATABLE));
+    EXPECT_EQ("is a directory", CheckPath(in("dir"), PathKind::CREATABLE));
+    EXPECT_EQ("is in a directory that does not exist",
+              CheckPath(in("missing/new"), PathKind::CREATABLE));
+    EXPECT_EQ("does not exist", CheckPath(in("file/new"), PathKind::CREATABLE));
+    // Permissions do not apply to root
+    if (::geteuid() != 0) {
+        EXPECT_EQ("is in a directory that is not writable",
+                  CheckPath(in("locked/new"), PathKind::CREATABLE));
+    }
+}
+
+TEST_F(PathCheckTest, CheckPaths) {
+    std::vector<PathRequest> requests;
+    std::vector<std::string> expected;
+    for (std::uint32_t i = 0; i < 50; i++) {
+        const bool missing = i % 3 == 0;
+        requests.push_back(PathRequest{ i, PathKind::EXISTING_FILE,
+                                        in(missing ? "missing" : "file") });
+        expected.push_back(missing ? "does not exist" : "");
+    }
+
+    EXPECT_EQ(expected, CheckPaths(requests, 1));
+    EXPECT_EQ(expected, CheckPaths(requests, 4));
+    EXPECT_EQ(expected, CheckPaths(requests, 100));
+    EXPECT_EQ(std::vector<std::string>(), CheckPaths({}, 4));
+    EXPECT_EQ(std::vector<std::string>({ "is not a directory" }),
+              CheckPaths({ PathRequest{ 0, PathKind::EXISTING_DIRECTORY, in("file") } }, 0));
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -0,0 +1,35 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/store_log.h"
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+namespace internal {
+
+TEST(StoreLog, Record) {
+    StoreLog log;
+    EXPECT_TRUE(log.stores().empty());
+    log.value(1, "abc");
+    log.append(2, "12");
+    log.count(3, 4);
+    log.property(4, "-Dkey=value", 2, 7);
+
+    const std::vector<StoreLog::Store>& stores = log.stores();
+    ASSERT_EQ(4u, stores.size());
+    EXPECT_EQ(1u, stores[0].node);
+    EXPECT_EQ(StoreLog::Kind::VALUE, stores[0].kind);
+    EXPECT_EQ("abc", stores[0].data);
+    EXPECT_EQ(StoreLog::Kind::APPEND, stores[1].kind);
+    EXPECT_EQ("12", stores[1].data);
+    EXPECT_EQ(StoreLog::Kind::COUNT, stores[2].kind);
+    EXPECT_EQ(4u, stores[2].occurrences);
+    EXPECT_EQ(StoreLog::Kind::PROPERTY, stores[3].kind);
+    EXPECT_EQ("-Dkey=value", stores[3].data);
+    EXPECT_EQ(2u, stores[3].offset);
+    EXPECT_EQ(7u, stores[3].position);
+}
+
+} // namespace internal
+} // namespace ahoy
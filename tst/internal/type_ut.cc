@@ -1,6 +1,7 @@
 // Copyright (c) 2016, 2018 Dustin Toff
 // Licensed under Apache License v2.0
 
+#include <cstdint>
 #include <sstream>
 
 #include "ahoy/internal/type.h"
@@ -26,6 +27,21 @@ TEST(Type, StreamOperator) {
     EXPECT_EQ("Unsigned Character", TypeToString(Type::U_CHAR));
     EXPECT_EQ("Long", TypeToString(Type::LONG));
     EXPECT_EQ("String", TypeToString(Type::STRING));
+    EXPECT_EQ("Bytes", TypeToString(Type::BYTES));
+    EXPECT_EQ("Milliseconds", TypeToString(Type::MILLISECONDS));
+    EXPECT_EQ("Properties", TypeToString(Type::PROPERTIES));
+    EXPECT_EQ("UTF-8 String", TypeToString(Type::UTF8_STRING));
+}
+
+TEST(Type, SizeOf) {
+    EXPECT_EQ(sizeof(bool), SizeOf(Type::BOOL));
+    EXPECT_EQ(sizeof(long double), SizeOf(Type::LONG_DOUBLE));
+    EXPECT_EQ(sizeof(std::uint64_t), SizeOf(Type::BYTES));
+    EXPECT_EQ(sizeof(std::chrono::hours), SizeOf(Type::HOURS));
+    EXPECT_EQ(0u, SizeOf(Type::INVALID));
+    EXPECT_EQ(0u, SizeOf(Type::STRING));
+    EXPECT_EQ(0u, SizeOf(Type::UTF8_STRING));
+    EXPECT_EQ(0u, SizeOf(Type::PROPERTIES));
 }
 
 } // namespace internal
@@ -0,0 +1,120 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/internal/utf8.h"
+
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+bool Valid(const std::string& text) {
+    return ahoy::internal::ValidUtf8(text.data(), text.size());
+}
+
+// Validates |text| byte by byte by decoding each code point
+bool Reference(const std::string& text) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char lead = static_cast<unsigned char>(text[i]);
+        std::size_t length;
+        unsigned long code_point;
+        if (lead < 0x80) {
+            length = 1;
+            code_point = lead;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            code_point = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            code_point = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            code_point = lead & 0x07;
+        } else {
+            return false;
+        }
+        if (i + length > text.size()) {
+            return false;
+        }
+        for (std::size_t j = 1; j < length; j++) {
+            const unsigned char continuation = static_cast<unsigned char>(text[i + j]);
+            if ((continuation & 0xC0) != 0x80) {
+                return false;
+            }
+            code_point = (code_point << 6) | (continuation & 0x3F);
+        }
+        const unsigned long minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+        if (code_point < minimum[length] || code_point > 0x10FFFF ||
+                (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace ahoy {
+namespace internal {
+
+TEST(Utf8, Valid) {
+    EXPECT_TRUE(Valid(""));
+    EXPECT_TRUE(Valid("plain ascii"));
+    EXPECT_TRUE(Valid("caf\xC3\xA9"));
+    EXPECT_TRUE(Valid("\xE2\x82\xAC 100"));
+    EXPECT_TRUE(Valid("\xF0\x9F\x98\x80"));
+    EXPECT_TRUE(Valid("\xED\x9F\xBF"));
+    EXPECT_TRUE(Valid("\xF4\x8F\xBF\xBF"));
+    EXPECT_TRUE(Valid(std::string("nul\0byte", 8)));
+}
+
+TEST(Utf8, Invalid) {
+    // Stray continuation and invalid lead bytes
+    EXPECT_FALSE(Valid("\x80"));
+    EXPECT_FALSE(Valid("\xFF"));
+    // Overlong encodings
+    EXPECT_FALSE(Valid("\xC0\xAF"));
+    EXPECT_FALSE(Valid("\xE0\x80\xAF"));
+    EXPECT_FALSE(Valid("\xF0\x80\x80\xAF"));
+    // Surrogates and code points past U+10FFFF
+    EXPECT_FALSE(Valid("\xED\xA0\x80"));
+    EXPECT_FALSE(Valid("\xF4\x90\x80\x80"));
+    // Truncated sequences
+    EXPECT_FALSE(Valid("caf\xC3"));
+    EXPECT_FALSE(Valid("\xE2\x82"));
+}
+
+TEST(Utf8, Blocks) {
+    // Malformed bytes are found at every position within and across the vectorized blocks
+    const std::string ascii(70, 'a');
+    for (std::size_t i = 0; i <= ascii.size(); i++) {
+        std::string text = ascii;
+        text.insert(i, "\xC3\xA9");
+        EXPECT_TRUE(Valid(text)) << i;
+        text[i] = '\xC3';
+        text[i + 1] = 'a';
+        EXPECT_FALSE(Valid(text)) << i;
+    }
+}
+
+TEST(Utf8, MatchesReference) {
+    // Mostly ASCII with a few high bytes, so that both valid and invalid texts are common
+    std::mt19937 random(43);
+    std::uniform_int_distribution<int> size(0, 40);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> choice(0, 3);
+    for (int n = 0; n < 20000; n++) {
+        std::string text;
+        for (int i = size(random); i > 0; i--) {
+            text.push_back(static_cast<char>(choice(random) == 0 ? byte(random) : 'a'));
+        }
+        EXPECT_EQ(Reference(text), Valid(text)) << testing::PrintToString(text);
+    }
+}
+
+} // namespace internal
+} // namespace ahoy
@@ -50,6 +50,13 @@ TEST(Parameter, Types) {
     TYPE_TEST(size_t);
 
     TYPE_TEST(std::string);
+
+    TYPE_TEST(std::chrono::nanoseconds);
+    TYPE_TEST(std::chrono::microseconds);
+    TYPE_TEST(std::chrono::milliseconds);
+    TYPE_TEST(std::chrono::seconds);
+    TYPE_TEST(std::chrono::minutes);
+    TYPE_TEST(std::chrono::hours);
 }
 
 TEST(Parameter, Empty) {
@@ -260,6 +267,98 @@ TEST(Parameter, TypeMismatch) {
     EXPECT_FALSE(consume(Parameter(&b), {"01"}));
 }
 
+TEST(Parameter, UnitTypes) {
+    std::uint64_t size(0);
+    std::chrono::milliseconds timeout(0);
+
+    EXPECT_TRUE(consume(Parameter(&size, ByteSize()), {"4GiB"}));
+    EXPECT_EQ(4ull << 30, size);
+    EXPECT_FALSE(consume(Parameter(&size, ByteSize()), {"4GiBs"}));
+    EXPECT_TRUE(consume(Parameter(&size), {"123"}));
+    EXPECT_EQ(123u, size);
+    EXPECT_FALSE(consume(Parameter(&size), {"4GiB"}));
+
+    EXPECT_TRUE(consume(Parameter(&timeout, LongForms({"timeout"})), {"--timeout=250ms"}));
+    EXPECT_EQ(250, timeout.count());
+    EXPECT_FALSE(consume(Parameter(&timeout, LongForms({"timeout"})), {"--timeout=250us"}));
+}
+
+enum class Mode { FAST, SAFE, AUDIT };
+
+TEST(Parameter, Choices) {
+    Mode mode = Mode::SAFE;
+    const Parameter p(&mode, LongForms({"mode"}),
+            Choices({ { "fast", Mode::FAST }, { "safe", Mode::SAFE }, { "audit", Mode::AUDIT } }));
+
+    EXPECT_TRUE(consume(p, { "--mode=fast" }));
+    EXPECT_EQ(Mode::FAST, mode);
+    EXPECT_TRUE(consume(p, { "--mode", "audit" }));
+    EXPECT_EQ(Mode::AUDIT, mode);
+    EXPECT_FALSE(consume(p, { "--mode=Audit" }));
+    EXPECT_FALSE(consume(p, { "--mode=2" }));
+    EXPECT_FALSE(consume(p, { "--mode=" }));
+    EXPECT_EQ(Mode::AUDIT, mode);
+
+    const Parameter insensitive(&mode, LongForms({"mode"}), CaseInsensitive(),
+            Choices({ { "fast", Mode::FAST }, { "safe", Mode::SAFE } }));
+    EXPECT_TRUE(consume(insensitive, { "--mode=SAFE" }));
+    EXPECT_EQ(Mode::SAFE, mode);
+    EXPECT_FALSE(consume(insensitive, { "--mode=audit" }));
+
+    unsigned char level = 0;
+    const Parameter integer(&level, Choices({ { "low", 1 }, { "high", 200 }, { "huge", 1000 },
+            { "negative", -1 } }));
+    EXPECT_TRUE(consume(integer, { "high" }));
+    EXPECT_EQ(200, level);
+    EXPECT_FALSE(consume(integer, { "huge" }));
+    EXPECT_FALSE(consume(integer, { "negative" }));
+    EXPECT_FALSE(consume(integer, { "1" }));
+    EXPECT_EQ(200, level);
+}
+
+TEST(Parameter, Count) {
+    int verbosity = 0;
+    const Parameter p(&verbosity, ShortForms({"v"}), LongForms({"verbose"}), Count());
+
+    EXPECT_TRUE(consume(p, { "-v" }));
+    EXPECT_EQ(1, verbosity);
+    EXPECT_TRUE(consume(p, { "--verbose" }));
+    EXPECT_EQ(2, verbosity);
+    EXPECT_TRUE(consume(p, { "-vvv" }));
+    EXPECT_EQ(5, verbosity);
+    EXPECT_FALSE(consume(p, { "-vxv" }));
+    EXPECT_FALSE(consume(p, { "--vv" }));
+    EXPECT_EQ(5, verbosity);
+
+    verbosity = 0;
+    std::string program;
+    Parameter root(&program);
+    root.withOptions(Parameter(p));
+    EXPECT_TRUE(consume(root, { "program", "-v", "--verbose", "-vv" }));
+    EXPECT_EQ(4, verbosity);
+}
+
+TEST(Parameter, Repeated) {
+    std::vector<std::string> includes{ "existing" };
+    std::string program;
+    Parameter root(&program);
+    root.withOptions(Parameter(&includes, ShortForms({"I"}), Required()));
+
+    const std::vector<std::string> args{ "program", "-I", "a", "-I=b", "-I", "c" };
+    root.reserve(args);
+    EXPECT_LE(4u, includes.capacity());
+    EXPECT_TRUE(consume(root, args));
+    EXPECT_EQ(std::vector<std::string>({ "existing", "a", "b", "c" }), includes);
+
+    EXPECT_FALSE(consume(root, { "program" }));
+
+    std::vector<int> numbers;
+    const Parameter positional(&numbers);
+    EXPECT_TRUE(consume(positional, { "12" }));
+    EXPECT_FALSE(consume(positional, { "twelve" }));
+    EXPECT_EQ(std::vector<int>({ 12 }), numbers);
+}
+
 TEST(Parameter, Equality) {
     char c, c2;
     Parameter p1(&c), p2(&c), p3(&c);
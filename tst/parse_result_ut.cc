@@ -0,0 +1,70 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/parse_result.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Gets the string representation of |error|
+std::string ErrorToString(const ahoy::ParseError& error) {
+    std::stringstream ss;
+    ss << error;
+    return ss.str();
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(ParseResult, DefaultValues) {
+    const ParseResult result;
+    EXPECT_TRUE(result.success());
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_EQ(0u, result.steps());
+    EXPECT_EQ("", result.unmatched());
+    EXPECT_TRUE(result.suggestions().empty());
+    EXPECT_EQ("", result.violation());
+    EXPECT_TRUE(result.path_failures().empty());
+}
+
+TEST(ParseResult, GetSet) {
+    ParseResult result;
+    result.error(ParseError::CANCELLED);
+    EXPECT_FALSE(result.success());
+    EXPECT_EQ(ParseError::CANCELLED, result.error());
+
+    result.steps(12);
+    EXPECT_EQ(12u, result.steps());
+
+    result.unmatched("--verbos");
+    EXPECT_EQ("--verbos", result.unmatched());
+
+    result.suggestions({ "--verbose" });
+    EXPECT_EQ(std::vector<std::string>({ "--verbose" }), result.suggestions());
+
+    result.violation("Exclusive(a, b)");
+    EXPECT_EQ("Exclusive(a, b)", result.violation());
+
+    const PathFailure failure("input", "in.txt", PathKind::EXISTING_FILE, "does not exist");
+    result.path_failures({ failure });
+    EXPECT_EQ(std::vector<PathFailure>({ failure }), result.path_failures());
+}
+
+TEST(ParseResult, StreamOperator) {
+    EXPECT_EQ("None", ErrorToString(ParseError::NONE));
+    EXPECT_EQ("Invalid Arguments", ErrorToString(ParseError::INVALID_ARGUMENTS));
+    EXPECT_EQ("Unmatched Argument", ErrorToString(ParseError::UNMATCHED_ARGUMENT));
+    EXPECT_EQ("Step Budget Exceeded", ErrorToString(ParseError::STEP_BUDGET_EXCEEDED));
+    EXPECT_EQ("Deadline Exceeded", ErrorToString(ParseError::DEADLINE_EXCEEDED));
+    EXPECT_EQ("Cancelled", ErrorToString(ParseError::CANCELLED));
+    EXPECT_EQ("Constraint Violation", ErrorToString(ParseError::CONSTRAINT_VIOLATION));
+    EXPECT_EQ("Invalid Path", ErrorToString(ParseError::INVALID_PATH));
+}
+
+} // namespace ahoy
@@ -3,6 +3,9 @@
 
 #include "ahoy/parser.h"
 
+#include <cstdint>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 // These tests require manual intervention to run.
@@ -28,4 +31,19 @@ TEST(Parser_ManualTest, FlagRequired_StaticAssertFailure) {
     // Parser().AddNamedParam(&param, Required(), Name(kName), Flag());
 }
 
+// To test, uncomment each line individually to verify static_asserts will cause build errors
+TEST(Parser_ManualTest, RepeatedOptions_StaticAssertFailure) {
+    std::vector<int> modes;
+    std::vector<std::uint64_t> sizes;
+
+    // Required to avoid compiler warnings
+    EXPECT_TRUE(modes.empty());
+    EXPECT_TRUE(sizes.empty());
+
+    // Parameter(&modes, LongForms({"mode"}), Choices({{"fast", 1}}));
+    // Parameter(&modes, LongForms({"mode"}), Choices({{"fast", 1}}), CaseInsensitive());
+    // Parameter(&modes, LongForms({"mode"}), CaseInsensitive());
+    // Parameter(&sizes, LongForms({"size"}), ByteSize());
+}
+
 } // namespace ahoy
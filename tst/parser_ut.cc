@@ -3,9 +3,17 @@
 
 #include "ahoy/parser.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 namespace {
@@ -14,7 +22,8 @@ const char kProgram[] = "./program";
 const char kValue[] = "value";
 const char kValue2[] = "value 2";
 
-bool parse(const ahoy::Parser& parser, const std::vector<std::string>& args) {
+bool parse(const ahoy::Parser& parser, const std::vector<std::string>& args,
+           ahoy::ParseResult* result = nullptr) {
     const uint arg_len = args.size() + 1;
 
     const std::unique_ptr<const char*[]> array(new const char*[arg_len]);
@@ -25,7 +34,17 @@ bool parse(const ahoy::Parser& parser, const std::vector<std::string>& args) {
         array[i + 1] = args[i].c_str();
     }
 
-    return parser.Parse(arg_len, array.get());
+    return parser.Parse(arg_len, array.get(), nullptr, result);
+}
+
+// Builds a grammar of nested positional parameters that takes many steps to reject more values than
+// it can hold
+ahoy::Parser BacktrackingParser(std::string* value) {
+    ahoy::Parameter node(value);
+    for (int depth = 0; depth < 4; depth++) {
+        node = ahoy::Parameter(value).withOptions(node, node, node).then(node, node);
+    }
+    return ahoy::Parser().then(node);
 }
 
 } // namespace
@@ -80,6 +99,828 @@ TEST(Parser, ProgramName) {
     EXPECT_EQ(kProgram, program_name);
 }
 
+TEST(Parser, Result) {
+    std::string param;
+    ParseResult result;
+
+    const Parser p = Parser().withOptions(Parameter(&param));
+    EXPECT_TRUE(parse(p, { kValue }, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_LT(0u, result.steps());
+
+    EXPECT_FALSE(parse(p, { kValue, kValue2 }, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_EQ(kValue2, result.unmatched());
+
+    const Parser required =
+            Parser().withOptions(Parameter(&param, LongForms({"param"}), Required()));
+    EXPECT_FALSE(parse(required, {}, &result));
+    EXPECT_EQ(ParseError::INVALID_ARGUMENTS, result.error());
+    EXPECT_EQ("", result.unmatched());
+}
+
+TEST(Parser, Suggestions) {
+    std::string name;
+    bool verbose = false;
+    int count = 0;
+    const Parser p = Parser().withOptions(
+            Parameter(&name, LongForms({"name"}), Required()),
+            Parameter(&verbose, ShortForms({"v"}), LongForms({"verbose", "version"}), Flag()),
+            Parameter(&count, LongForms({"count"})));
+    ParseResult result;
+
+    EXPECT_FALSE(parse(p, { "--name", kValue, "--verbos" }, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_EQ("--verbos", result.unmatched());
+    EXPECT_EQ(std::vector<std::string>({ "--verbose" }), result.suggestions());
+
+    // Reported even though the required parameter is missing, since parsing stopped first
+    EXPECT_FALSE(parse(p, { "--nmae=n" }, &result));
+    EXPECT_EQ("--nmae=n", result.unmatched());
+    EXPECT_EQ(std::vector<std::string>({ "--name" }), result.suggestions());
+
+    EXPECT_FALSE(parse(p, { "--name", kValue, "--completely-different" }, &result));
+    EXPECT_EQ("--completely-different", result.unmatched());
+    EXPECT_TRUE(result.suggestions().empty());
+
+    // A form with a bad value is reported, but not suggested as a fix for itself
+    EXPECT_FALSE(parse(p, { "--name", kValue, "--count", "many" }, &result));
+    EXPECT_EQ("--count", result.unmatched());
+    EXPECT_TRUE(result.suggestions().empty());
+
+    EXPECT_TRUE(parse(p, { "--name", kValue }, &result));
+    EXPECT_EQ("", result.unmatched());
+    EXPECT_TRUE(result.suggestions().empty());
+}
+
+TEST(Parser, StepBudget) {
+    std::string value;
+    const std::vector<std::string> args(2000, kValue);
+    ParseResult result;
+
+    Parser p = BacktrackingParser(&value);
+    EXPECT_FALSE(parse(p, args, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    const unsigned long long unlimited_steps = result.steps();
+
+    p.withStepBudget(unlimited_steps / 2);
+    EXPECT_FALSE(parse(p, args, &result));
+    EXPECT_EQ(ParseError::STEP_BUDGET_EXCEEDED, result.error());
+    EXPECT_EQ(unlimited_steps / 2 + 1, result.steps());
+
+    // Small inputs are unaffected by the budget
+    EXPECT_TRUE(parse(p, { kValue }, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+
+    p.withStepBudget(0);
+    EXPECT_FALSE(parse(p, args, &result));
+    EXPECT_EQ(unlimited_steps, result.steps());
+}
+
+TEST(Parser, Timeout) {
+    std::string value;
+    ParseResult result;
+
+    Parser p = BacktrackingParser(&value).withTimeout(std::chrono::hours(1));
+    EXPECT_TRUE(parse(p, { kValue }, &result));
+
+    p.withTimeout(std::chrono::nanoseconds(1));
+    EXPECT_FALSE(parse(p, std::vector<std::string>(20, kValue), &result));
+    EXPECT_EQ(ParseError::DEADLINE_EXCEEDED, result.error());
+}
+
+TEST(Parser, Cancellation) {
+    std::string value;
+    std::atomic<bool> cancelled(false);
+    ParseResult result;
+
+    const Parser p = Parser().withOptions(Parameter(&value)).withCancellation(&cancelled);
+    EXPECT_TRUE(parse(p, { kValue }, &result));
+
+    cancelled = true;
+    EXPECT_FALSE(parse(p, { kValue }, &result));
+    EXPECT_EQ(ParseError::CANCELLED, result.error());
+}
+
+TEST(Parser, Complete) {
+    enum class Mode { FAST, SAFE };
+    Mode mode = Mode::FAST;
+    bool verbose = false;
+    std::string file;
+    const Parser p = Parser()
+            .withOptions(
+                    Parameter(&verbose, ShortForms({"v"}), LongForms({"verbose"}), Flag(),
+                            Description("Talk more")),
+                    Parameter(&mode, LongForms({"mode"}),
+                            Choices({ { "fast", Mode::FAST }, { "safe", Mode::SAFE } })))
+            .then(Parameter(&file, Name("file"), Required()));
+
+    const char* const none[] = { kProgram };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::FORM, "--verbose", "Talk more"),
+                Completion(CompletionKind::FORM, "-v", "Talk more"),
+                Completion(CompletionKind::FORM, "--mode", ""),
+                Completion(CompletionKind::VALUE, "file", ""),
+            }), p.Complete(1, none, 1));
+
+    const char* const partial_form[] = { kProgram, "--v" };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::FORM, "--verbose", "Talk more"),
+                Completion(CompletionKind::VALUE, "file", ""),
+            }), p.Complete(2, partial_form, 1));
+
+    const char* const used[] = { kProgram, "-v", "--" };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::FORM, "--mode", ""),
+                Completion(CompletionKind::VALUE, "file", ""),
+            }), p.Complete(3, used, 2));
+
+    const char* const value[] = { kProgram, "--mode", "s" };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::CHOICE, "safe", ""),
+            }), p.Complete(3, value, 2));
+
+    const char* const equals[] = { kProgram, "--mode=" };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::CHOICE, "--mode=fast", ""),
+                Completion(CompletionKind::CHOICE, "--mode=safe", ""),
+                Completion(CompletionKind::VALUE, "file", ""),
+            }), p.Complete(2, equals, 1));
+
+    const char* const done[] = { kProgram, "--mode", "safe", "file.txt" };
+    EXPECT_EQ(std::vector<Completion>({
+                Completion(CompletionKind::FORM, "--verbose", "Talk more"),
+                Completion(CompletionKind::FORM, "-v", "Talk more"),
+            }), p.Complete(4, done, 4));
+
+    // Completing never stores values
+    EXPECT_EQ(Mode::FAST, mode);
+    EXPECT_FALSE(verbose);
+    EXPECT_EQ("", file);
+}
+
+TEST(Parser, CompleteStepBudget) {
+    std::string value;
+    const char* const args[] = { kProgram, "a", "b" };
+    EXPECT_FALSE(BacktrackingParser(&value).Complete(3, args, 3).empty());
+    EXPECT_TRUE(BacktrackingParser(&value).withStepBudget(1).Complete(3, args, 3).empty());
+}
+
+TEST(Parser, MemoryFootprint) {
+    std::string value;
+    Parser parser;
+    const std::size_t empty = parser.memory_footprint();
+    EXPECT_LT(0u, empty);
+
+    parser.withOptions(Parameter(&value, LongForms({"value"}), Description("A value")));
+    const std::size_t one = parser.memory_footprint();
+    EXPECT_LT(empty, one);
+
+    parser.then(Parameter(&value, Required()));
+    EXPECT_LT(one, parser.memory_footprint());
+    EXPECT_TRUE(parse(parser, { "--value", kValue, kValue2 }));
+    EXPECT_EQ(kValue2, value);
+}
+
+TEST(Parser, Snapshot) {
+    std::string value;
+    bool flag = false;
+    Parser built;
+    built.withOptions(Parameter(&flag, Name("flag"), ShortForms({"f"}), Flag()),
+                      Parameter(&value, Name("value"), LongForms({"value"}), Required()));
+    const std::string snapshot = built.Snapshot();
+    std::vector<std::uint64_t> image((snapshot.size() + 7) / 8);
+    std::memcpy(image.data(), snapshot.data(), snapshot.size());
+
+    Parser loaded;
+    EXPECT_FALSE(loaded.LoadSnapshot(image.data(), snapshot.size() - 1));
+    ASSERT_TRUE(loaded.LoadSnapshot(image.data(), snapshot.size()));
+    EXPECT_EQ(built.fingerprint(), loaded.fingerprint());
+    EXPECT_TRUE(loaded.current_options().empty());
+
+    std::string loaded_value;
+    bool loaded_flag = false;
+    EXPECT_TRUE(loaded.Bind("value", &loaded_value));
+    EXPECT_TRUE(loaded.Bind("flag", &loaded_flag));
+    EXPECT_FALSE(loaded.Bind("value", &loaded_flag));
+    EXPECT_FALSE(parse(loaded, { "-f" }));
+    EXPECT_TRUE(parse(loaded, { "-f", "--value", kValue }));
+    EXPECT_TRUE(loaded_flag);
+    EXPECT_EQ(kValue, loaded_value);
+    EXPECT_FALSE(flag);
+    EXPECT_EQ("", value);
+}
+
+TEST(Parser, Environment) {
+    int port = 80;
+    bool verbose = false;
+    std::string host;
+    std::vector<std::string> tags;
+    const char* environment[] = { "PATH=/bin", "APP_PORT=8080", "APP_VERBOSE=true",
+                                  "APP_HOST=localhost", "APP_PORT=9090", "APP_TAG=a", nullptr };
+    Parser parser;
+    parser.withOptions(Parameter(&port, LongForms({"port"}), EnvVar("APP_PORT")),
+                       Parameter(&verbose, ShortForms({"v"}), Flag(), EnvVar("APP_VERBOSE")),
+                       Parameter(&host, LongForms({"host"}), Required(), EnvVar("APP_HOST")),
+                       Parameter(&tags, LongForms({"tag"}), EnvVar("APP_TAG")))
+          .withEnvironment(environment);
+
+    // The environment fills in what the arguments leave out, including required parameters, and
+    // the first definition of a variable is used
+    EXPECT_TRUE(parse(parser, {}));
+    EXPECT_EQ(8080, port);
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("localhost", host);
+    EXPECT_EQ(std::vector<std::string>({ "a" }), tags);
+
+    // Arguments take precedence
+    tags.clear();
+    EXPECT_TRUE(parse(parser, { "--port", "1", "--host=remote", "--tag", "b", "--tag", "c" }));
+    EXPECT_EQ(1, port);
+    EXPECT_EQ("remote", host);
+    EXPECT_EQ(std::vector<std::string>({ "b", "c" }), tags);
+
+    // Values from the environment are converted like arguments
+    const char* invalid[] = { "APP_PORT=eighty", "APP_HOST=localhost", nullptr };
+    parser.withEnvironment(invalid);
+    EXPECT_FALSE(parse(parser, {}));
+    EXPECT_TRUE(parse(parser, { "--port", "2" }));
+    EXPECT_EQ(2, port);
+
+    const char* empty[] = { nullptr };
+    parser.withEnvironment(empty);
+    EXPECT_FALSE(parse(parser, {}));
+    EXPECT_TRUE(parse(parser, { "--host", "h" }));
+}
+
+TEST(Parser, EnvironmentUntakenBranch) {
+    bool help = false;
+    std::string file;
+    int t = 0;
+    const char* environment[] = { "APP_T=7", nullptr };
+    Parser parser;
+    parser.then(Parameter(&help, LongForms({"help"}), Flag()),
+                Parameter(&file).withOptions(Parameter(&t, LongForms({"t"}), EnvVar("APP_T"))))
+          .withEnvironment(environment);
+
+    // The options of a next that was not taken do not read the environment
+    EXPECT_TRUE(parse(parser, { "--help" }));
+    EXPECT_TRUE(help);
+    EXPECT_EQ(0, t);
+
+    EXPECT_TRUE(parse(parser, { "input" }));
+    EXPECT_EQ("input", file);
+    EXPECT_EQ(7, t);
+
+    // Nor can their invalid values fail the parse
+    const char* invalid[] = { "APP_T=seven", nullptr };
+    parser.withEnvironment(invalid);
+    t = 0;
+    EXPECT_TRUE(parse(parser, { "--help" }));
+    EXPECT_EQ(0, t);
+    EXPECT_FALSE(parse(parser, { "input" }));
+}
+
+TEST(Parser, EnvironmentAbandonedBranch) {
+    std::string a, b, host;
+    int port = 0;
+    const char* environment[] = { "APP_PORT=bad", nullptr };
+    Parser parser;
+    parser.then(Parameter(&a).withOptions(Parameter(&port, LongForms({"port"}), EnvVar("APP_PORT")),
+                                          Parameter(&host, LongForms({"host"}), Required())),
+                Parameter(&b))
+          .withEnvironment(environment);
+
+    // The first next matches before failing for want of --host, so its options are not taken
+    EXPECT_TRUE(parse(parser, { "x" }));
+    EXPECT_EQ("x", b);
+    EXPECT_EQ(0, port);
+
+    EXPECT_FALSE(parse(parser, { "x", "--host", "h" }));
+}
+
+TEST(Parser, Passthrough) {
+    bool verbose = false;
+    ArgvSpan rest;
+    Parser parser;
+    parser.withOptions(Parameter(&verbose, ShortForms({"v"}), Flag())).withPassthrough(&rest);
+
+    const char* argv[] = { kProgram, "-v", "--", "child", "--", "-x", nullptr };
+    EXPECT_TRUE(parser.Parse(6, argv));
+    EXPECT_TRUE(verbose);
+    ASSERT_EQ(3u, rest.size());
+    EXPECT_EQ(argv + 3, rest.begin());
+    EXPECT_EQ(argv[3], rest.argv()[0]);
+    EXPECT_EQ(nullptr, rest.argv()[3]);
+
+    // Without "--" the rest is empty but still null-terminated
+    EXPECT_TRUE(parser.Parse(2, argv));
+    EXPECT_TRUE(rest.empty());
+    EXPECT_EQ(argv + 2, rest.begin());
+
+    const char* trailing[] = { kProgram, "--", nullptr };
+    EXPECT_TRUE(parser.Parse(2, trailing));
+    EXPECT_TRUE(rest.empty());
+    EXPECT_EQ(nullptr, rest.argv()[0]);
+
+    // Unknown arguments before "--" still fail
+    const char* unknown[] = { kProgram, "child", "--", nullptr };
+    EXPECT_FALSE(parser.Parse(3, unknown));
+
+    // Nothing after "--" is completed
+    EXPECT_EQ(std::vector<Completion>({ Completion(CompletionKind::FORM, "-v", "") }),
+              parser.Complete(2, argv, 1));
+    EXPECT_TRUE(parser.Complete(6, argv, 3).empty());
+
+    // Without passthrough, "--" is an argument like any other
+    parser.withPassthrough(nullptr);
+    EXPECT_FALSE(parser.Parse(3, argv));
+}
+
+TEST(Parser, ValidateUtf8) {
+    std::string name, raw;
+    std::vector<std::string> tags;
+    Parser parser;
+    parser.withOptions(Parameter(&name, LongForms({"name"}), ValidateUtf8()),
+                       Parameter(&raw, LongForms({"raw"})),
+                       Parameter(&tags, LongForms({"tag"}), ValidateUtf8()));
+
+    EXPECT_TRUE(parse(parser, { "--name", "caf\xC3\xA9", "--raw", "\xFF", "--tag=\xE2\x82\xAC" }));
+    EXPECT_EQ("caf\xC3\xA9", name);
+    EXPECT_EQ("\xFF", raw);
+    EXPECT_EQ(std::vector<std::string>({ "\xE2\x82\xAC" }), tags);
+
+    ParseResult result;
+    EXPECT_FALSE(parse(parser, { "--name", "caf\xC3" }, &result));
+    EXPECT_NE(ParseError::NONE, result.error());
+    EXPECT_EQ("caf\xC3\xA9", name);
+    EXPECT_FALSE(parse(parser, { "--tag=\xED\xA0\x80" }));
+}
+
+TEST(Parser, Paths) {
+    const char* const tmp = std::getenv("TEST_TMPDIR");
+    std::string dir = std::string(tmp != nullptr ? tmp : "/tmp") + "/parser_paths_XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(&dir[0]));
+    const std::string file = dir + "/file";
+    std::FILE* const handle = std::fopen(file.c_str(), "w");
+    ASSERT_NE(nullptr, handle);
+    std::fclose(handle);
+
+    std::string input, output;
+    std::vector<std::string> includes;
+    int count = 0;
+    Parser parser;
+    parser.withOptions(Parameter(&input, Name("input"), LongForms({"in"}),
+                                 Path(PathKind::EXISTING_FILE)),
+                       Parameter(&output, Name("output"), LongForms({"out"}),
+                                 Path(PathKind::CREATABLE)),
+                       Parameter(&includes, Name("include"), ShortForms({"I"}),
+                                 Path(PathKind::EXISTING_DIRECTORY)),
+                       Parameter(&count, LongForms({"count"})));
+
+    ParseResult result;
+    for (const std::size_t threads : { 1, 4 }) {
+        parser.withPathCheckThreads(threads);
+        includes.clear();
+        EXPECT_TRUE(parse(parser, { "--in", file, "--out", dir + "/out", "-I", dir, "-I", dir },
+                          &result));
+        EXPECT_EQ(ParseError::NONE, result.error());
+        EXPECT_TRUE(result.path_failures().empty());
+
+        // Every bad path is reported, not just the first
+        includes.clear();
+        EXPECT_FALSE(parse(parser, { "--in", dir, "--out", dir + "/missing/out", "-I", dir, "-I",
+                                     file, "--count=1" }, &result));
+        EXPECT_EQ(ParseError::INVALID_PATH, result.error());
+        EXPECT_EQ(std::vector<PathFailure>({
+                      PathFailure("input", dir, PathKind::EXISTING_FILE, "is a directory"),
+                      PathFailure("output", dir + "/missing/out", PathKind::CREATABLE,
+                                  "is in a directory that does not exist"),
+                      PathFailure("include", file, PathKind::EXISTING_DIRECTORY,
+                                  "is not a directory") }),
+                  result.path_failures());
+    }
+
+    // Paths are not checked unless the arguments parse
+    EXPECT_FALSE(parse(parser, { "--in", dir, "--count=one" }, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_TRUE(result.path_failures().empty());
+
+    ::unlink(file.c_str());
+    ::rmdir(dir.c_str());
+}
+
+TEST(Parser, PathsAbandonedBranch) {
+    std::string a, b, input, name;
+    int port = 0;
+    Parser parser;
+    parser.then(Parameter(&a).withOptions(Parameter(&input, Name("input"), LongForms({"in"}),
+                                                    Path(PathKind::EXISTING_FILE)),
+                                          Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b).withOptions(Parameter(&name, LongForms({"in"}))));
+
+    // The first next stores the path before failing for want of --port, so it is not checked
+    ParseResult result;
+    EXPECT_TRUE(parse(parser, { "x", "--in=/nonexistent" }, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_TRUE(result.path_failures().empty());
+    EXPECT_EQ("/nonexistent", name);
+
+    EXPECT_FALSE(parse(parser, { "x", "--in=/nonexistent", "--port", "80" }, &result));
+    EXPECT_EQ(ParseError::INVALID_PATH, result.error());
+}
+
+TEST(Parser, ParseCache) {
+    std::string name, program;
+    int port = 0;
+    std::vector<std::string> tags;
+    Properties properties;
+    const char* environment[] = { "PORT=8080", nullptr };
+    Parser parser;
+    parser.withOptions(Parameter(&name, Name("name"), LongForms({"name"})),
+                       Parameter(&port, Name("port"), LongForms({"port"}), EnvVar("PORT")),
+                       Parameter(&tags, LongForms({"tag"})),
+                       Parameter(&properties, ShortForms({"D"}), BorrowArgv()))
+          .withEnvironment(environment)
+          .withParseCache(2);
+
+    std::string arg = "-Dkey=value";
+    const char* argv[] = { kProgram, "--name", kValue, "--tag=a", arg.c_str() };
+    ParseResult result;
+    EXPECT_TRUE(parser.Parse(5, argv, &program, &result));
+    EXPECT_LT(0u, result.steps());
+    EXPECT_EQ(0u, parser.cache_hits());
+    EXPECT_EQ(1u, parser.cache_misses());
+
+    name.clear();
+    port = 0;
+    program.clear();
+    properties.clear();
+    std::string copy = arg;
+    argv[4] = copy.c_str();
+    EXPECT_TRUE(parser.Parse(5, argv, &program, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_EQ(0u, result.steps());
+    EXPECT_EQ(1u, parser.cache_hits());
+    EXPECT_EQ(kProgram, program);
+    EXPECT_EQ(kValue, name);
+    EXPECT_EQ(8080, port);
+    EXPECT_EQ(std::vector<std::string>({ "a", "a" }), tags);
+    // Borrowed values point into the arguments of the parse that replayed them
+    EXPECT_EQ(copy.c_str() + 6, properties.find("key"));
+
+    // The environment is part of the key
+    environment[0] = "PORT=9090";
+    EXPECT_TRUE(parse(parser, { "--name", kValue, "--tag=a", arg }));
+    EXPECT_EQ(9090, port);
+    EXPECT_EQ(2u, parser.cache_misses());
+
+    // Failed parses are not cached
+    EXPECT_FALSE(parse(parser, { "--port", "x" }));
+    EXPECT_FALSE(parse(parser, { "--port", "x" }));
+    EXPECT_EQ(1u, parser.cache_hits());
+    EXPECT_EQ(4u, parser.cache_misses());
+
+    // Changing the constraints may change the outcome, so it empties the cache
+    parser.withConstraints(Requires("name", {"port"}));
+    environment[0] = nullptr;
+    EXPECT_FALSE(parse(parser, { "--name", kValue, "--tag=a", arg }));
+    EXPECT_EQ(1u, parser.cache_hits());
+
+    // Copies start empty
+    const Parser copied = parser;
+    EXPECT_EQ(0u, copied.cache_hits());
+    EXPECT_EQ(0u, copied.cache_misses());
+}
+
+TEST(Parser, Properties) {
+    Properties properties;
+    bool verbose = false;
+    Parser parser;
+    parser.withOptions(Parameter(&properties, ShortForms({"D"}), LongForms({"define"})),
+                       Parameter(&verbose, ShortForms({"v"}), Flag()));
+
+    // Keys may follow the form directly, after an '=' or in the next argument, and are split from
+    // their values once
+    EXPECT_TRUE(parse(parser, { "-Da=1", "-v", "--define=b=2=3", "-D", "c", "-Dd=" }));
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ(4u, properties.size());
+    EXPECT_EQ("1", properties.get("a"));
+    EXPECT_EQ("2=3", properties.get("b"));
+    EXPECT_TRUE(properties.contains("c"));
+    EXPECT_EQ("", properties.get("c", "fallback"));
+    EXPECT_EQ("", properties.get("d", "fallback"));
+
+    // Keys may not be empty
+    EXPECT_FALSE(parse(parser, { "-D=" }));
+    EXPECT_FALSE(parse(parser, { "--define==1" }));
+
+    // By default later values win
+    properties.clear();
+    EXPECT_TRUE(parse(parser, { "-Da=1", "-Da=2" }));
+    EXPECT_EQ("2", properties.get("a"));
+
+    Properties first, strict;
+    Parser first_parser, strict_parser;
+    first_parser.withOptions(Parameter(&first, ShortForms({"D"}),
+                                       OnDuplicateKey(DuplicateKeyPolicy::FIRST_WINS)));
+    strict_parser.withOptions(Parameter(&strict, ShortForms({"D"}),
+                                        OnDuplicateKey(DuplicateKeyPolicy::REJECT)));
+    EXPECT_TRUE(parse(first_parser, { "-Da=1", "-Da=2" }));
+    EXPECT_EQ("1", first.get("a"));
+    EXPECT_TRUE(parse(strict_parser, { "-Da=1", "-Db=2" }));
+    strict.clear();
+    EXPECT_FALSE(parse(strict_parser, { "-Da=1", "-Da=2" }));
+}
+
+TEST(Parser, PropertiesAbandonedBranch) {
+    std::string a, b;
+    Properties properties, others;
+    int port = 0;
+    Parser parser;
+    parser.then(Parameter(&a).withOptions(Parameter(&properties, ShortForms({"D"}),
+                                                    OnDuplicateKey(DuplicateKeyPolicy::REJECT)),
+                                          Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b).withOptions(Parameter(&properties, ShortForms({"D"}),
+                                                    OnDuplicateKey(DuplicateKeyPolicy::REJECT))));
+
+    // The first next inserts before failing for want of --port, which is undone rather than left
+    // to be rejected as a duplicate
+    EXPECT_TRUE(parse(parser, { "x", "-Da=1", "-Db=2" }));
+    EXPECT_EQ("x", b);
+    EXPECT_EQ(2u, properties.size());
+    EXPECT_EQ("1", properties.get("a"));
+    EXPECT_EQ("2", properties.get("b"));
+
+    // Values that replaced earlier ones are put back
+    properties.clear();
+    properties.insert("a", "0");
+    parser.then(Parameter(&a).withOptions(Parameter(&properties, ShortForms({"D"})),
+                                          Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b).withOptions(Parameter(&others, ShortForms({"D"}))));
+    EXPECT_TRUE(parse(parser, { "x", "-Da=1", "-Dc=3" }));
+    EXPECT_EQ(1u, properties.size());
+    EXPECT_EQ("0", properties.get("a"));
+    EXPECT_FALSE(properties.contains("c"));
+    EXPECT_EQ("1", others.get("a"));
+    EXPECT_EQ("3", others.get("c"));
+}
+
+TEST(Parser, PropertiesBorrowArgv) {
+    Properties copied, borrowed;
+    Parser copying, borrowing;
+    copying.withOptions(Parameter(&copied, ShortForms({"D"})));
+    borrowing.withOptions(Parameter(&borrowed, ShortForms({"D"}), BorrowArgv()));
+
+    const char* argv[] = { kProgram, "-Dname=value", "-D", "other=x", nullptr };
+    EXPECT_TRUE(copying.Parse(4, argv));
+    EXPECT_TRUE(borrowing.Parse(4, argv));
+    EXPECT_EQ(copied, borrowed);
+
+    // Borrowed keys and values point into argv
+    EXPECT_EQ(argv[1] + 2, borrowed.begin()->key);
+    EXPECT_EQ(argv[1] + 7, borrowed.find("name"));
+    EXPECT_EQ(argv[3] + 6, borrowed.find("other"));
+    EXPECT_NE(argv[1] + 7, copied.find("name"));
+}
+
+TEST(Parser, Variadic) {
+    bool verbose = false;
+    std::string mode;
+    std::vector<int> values;
+    Parser parser;
+    parser.withOptions(Parameter(&verbose, ShortForms({"v"}), Flag()),
+                       Parameter(&mode, LongForms({"mode"})),
+                       Parameter(&values, Name("values"), Variadic()));
+
+    // Options come first, and everything from the first positional on is a value
+    EXPECT_TRUE(parse(parser, { "-v", "--mode", "sum", "1", "-2", "3" }));
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("sum", mode);
+    EXPECT_EQ(std::vector<int>({ 1, -2, 3 }), values);
+
+    values.clear();
+    EXPECT_FALSE(parse(parser, { "1", "-v" }));
+    EXPECT_FALSE(parse(parser, { "1", "two" }));
+
+    // Many values are converted at once, into the vector's existing contents
+    std::vector<std::string> args;
+    for (int i = 0; i < 100000; i++) {
+        args.push_back(std::to_string(i));
+    }
+    values.assign({ -1 });
+    EXPECT_TRUE(parse(parser, args));
+    ASSERT_EQ(100001u, values.size());
+    EXPECT_EQ(-1, values[0]);
+    EXPECT_EQ(99999, values.back());
+
+    // They are replayed from the parse cache like any repeated values
+    values.clear();
+    parser.withParseCache(1);
+    EXPECT_TRUE(parse(parser, { "4", "5" }));
+    EXPECT_TRUE(parse(parser, { "4", "5" }));
+    EXPECT_EQ(1u, parser.cache_hits());
+    EXPECT_EQ(std::vector<int>({ 4, 5, 4, 5 }), values);
+}
+
+TEST(Parser, RepeatedAbandonedBranch) {
+    std::string a, b;
+    std::vector<std::string> includes;
+    int port = 0;
+    Parser parser;
+    parser.then(Parameter(&a).withOptions(Parameter(&includes, LongForms({"include"})),
+                                          Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b).withOptions(Parameter(&includes, LongForms({"include"}))));
+
+    // The first next appends before failing for want of --port, which is undone
+    EXPECT_TRUE(parse(parser, { "x", "--include=a" }));
+    EXPECT_EQ("x", b);
+    EXPECT_EQ(std::vector<std::string>({ "a" }), includes);
+
+    // Including what the cache replays
+    includes.clear();
+    parser.withParseCache(1);
+    EXPECT_TRUE(parse(parser, { "x", "--include=a" }));
+    EXPECT_TRUE(parse(parser, { "x", "--include=a" }));
+    EXPECT_EQ(1u, parser.cache_hits());
+    EXPECT_EQ(std::vector<std::string>({ "a", "a" }), includes);
+}
+
+TEST(Parser, CountAbandonedBranch) {
+    std::string a, b;
+    int verbosity = 0;
+    int port = 0;
+    Parser parser;
+    parser.then(Parameter(&a).withOptions(Parameter(&verbosity, ShortForms({"v"}), Count()),
+                                          Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b).withOptions(Parameter(&verbosity, ShortForms({"v"}), Count())));
+
+    // The first next counts before failing for want of --port, which is undone
+    EXPECT_TRUE(parse(parser, { "x", "-vv" }));
+    EXPECT_EQ("x", b);
+    EXPECT_EQ(2, verbosity);
+
+    EXPECT_TRUE(parse(parser, { "y", "-v", "--port", "80" }));
+    EXPECT_EQ("y", a);
+    EXPECT_EQ(3, verbosity);
+}
+
+TEST(Parser, HitCounters) {
+    std::string input, output, command;
+    bool verbose = false, force = false;
+    Parser parser;
+    parser.withOptions(Parameter(&input, LongForms({"input"})),
+                       Parameter(&output, LongForms({"output"})),
+                       Parameter(&verbose, ShortForms({"v"}), Flag()),
+                       Parameter(&force, ShortForms({"f"}), Flag()))
+          .then(Parameter(&command, Name("command")));
+
+    ParseResult before;
+    EXPECT_TRUE(parse(parser, { "-f", "-v", "run" }, &before));
+
+    // Nothing is counted until asked for
+    EXPECT_EQ(std::string::npos, parser.Profile().find('\n', parser.Profile().find('\n') + 1));
+    parser.withHitCounters(true);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(parse(parser, { "-f", "-v", "run" }));
+    }
+    EXPECT_TRUE(parse(parser, { "--input", kValue, "run" }));
+    const std::string profile = parser.Profile();
+
+    // The flags are tried first from now on, which takes fewer steps for the same values
+    parser.Reorder();
+    ParseResult after;
+    force = false;
+    verbose = false;
+    command.clear();
+    EXPECT_TRUE(parse(parser, { "-f", "-v", "run" }, &after));
+    EXPECT_TRUE(force);
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("run", command);
+    EXPECT_LT(after.steps(), before.steps());
+
+    // A profile reorders another parser built from the same options
+    Parser other = parser;
+    other.withOptions(parser.current_options());
+    ParseResult unordered;
+    EXPECT_TRUE(parse(other, { "-f", "-v", "run" }, &unordered));
+    EXPECT_EQ(before.steps(), unordered.steps());
+    EXPECT_TRUE(other.LoadProfile(profile));
+    ParseResult loaded;
+    EXPECT_TRUE(parse(other, { "-f", "-v", "run" }, &loaded));
+    EXPECT_EQ(after.steps(), loaded.steps());
+
+    // Stale and malformed profiles are rejected
+    other.withOptions(Parameter(&input, LongForms({"input"})));
+    EXPECT_FALSE(other.LoadProfile(profile));
+    EXPECT_FALSE(parser.LoadProfile(""));
+    EXPECT_FALSE(parser.LoadProfile(profile + "x 1\n"));
+    EXPECT_FALSE(parser.LoadProfile(profile + "100 1\n"));
+
+    // Changing the options resets the counts
+    parser.then(Parameter(&command, Name("command")));
+    EXPECT_EQ(parser.Profile().find('\n') + 1, parser.Profile().size());
+}
+
+TEST(Parser, Constraints) {
+    bool tcp = false, unix_socket = false;
+    std::string key, cert;
+    const char* environment[] = { "APP_CERT=cert.pem", nullptr };
+    Parser parser;
+    parser.withOptions(Parameter(&tcp, Name("tcp"), LongForms({"tcp"}), Flag()),
+                       Parameter(&unix_socket, Name("unix"), LongForms({"unix"}), Flag()),
+                       Parameter(&key, Name("key"), LongForms({"tls-key"})),
+                       Parameter(&cert, Name("cert"), LongForms({"tls-cert"}), EnvVar("APP_CERT")))
+          .withConstraints(Exclusive({ "tcp", "unix" }),
+                           AtLeastOne({ "tcp", "unix" }),
+                           Requires("key", { "cert" }));
+
+    ParseResult result;
+    EXPECT_TRUE(parse(parser, { "--tcp" }, &result));
+    EXPECT_TRUE(parse(parser, { "--unix", "--tls-key", "k", "--tls-cert", "c" }, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_EQ("", result.violation());
+
+    EXPECT_FALSE(parse(parser, { "--tcp", "--unix" }, &result));
+    EXPECT_EQ(ParseError::CONSTRAINT_VIOLATION, result.error());
+    EXPECT_EQ("Exclusive(tcp, unix)", result.violation());
+
+    EXPECT_FALSE(parse(parser, {}, &result));
+    EXPECT_EQ("AtLeastOne(tcp, unix)", result.violation());
+
+    EXPECT_FALSE(parse(parser, { "--tcp", "--tls-key", "k" }, &result));
+    EXPECT_EQ("Requires(key; cert)", result.violation());
+
+    // Values from the environment count as present
+    parser.withEnvironment(environment);
+    EXPECT_TRUE(parse(parser, { "--tcp", "--tls-key", "k" }, &result));
+    EXPECT_EQ("cert.pem", cert);
+
+    // Failing to match takes precedence
+    EXPECT_FALSE(parse(parser, { "--tcp", "--unix", "--other" }, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_EQ("", result.violation());
+
+    // Constraints are resolved again when the options change, and names of no parameter are
+    // reported whatever the arguments
+    parser.withOptions(Parameter(&tcp, Name("tcp"), LongForms({"tcp"}), Flag()));
+    tcp = false;
+    EXPECT_FALSE(parse(parser, { "--tcp" }, &result));
+    EXPECT_FALSE(tcp);
+    EXPECT_EQ(ParseError::CONSTRAINT_VIOLATION, result.error());
+    EXPECT_EQ("Exclusive(tcp, unix): unknown name unix", result.violation());
+    parser.withConstraints(AtLeastOne({ "tcp" }));
+    EXPECT_TRUE(parse(parser, { "--tcp" }));
+    EXPECT_FALSE(parse(parser, {}));
+}
+
+TEST(Parser, ConstraintsAbandonedBranch) {
+    std::string a, b;
+    bool tcp = false, b_tcp = false, unix_socket = false;
+    int port = 0;
+    Parser parser;
+    parser.then(Parameter(&a, Name("a"))
+                        .withOptions(Parameter(&tcp, Name("tcp"), LongForms({"tcp"}), Flag()),
+                                     Parameter(&port, LongForms({"port"}), Required())),
+                Parameter(&b, Name("b"))
+                        .withOptions(Parameter(&b_tcp, LongForms({"tcp"}), Flag()),
+                                     Parameter(&unix_socket, Name("unix"), LongForms({"unix"}),
+                                               Flag())))
+          .withConstraints(Exclusive({ "tcp", "unix" }));
+
+    // The first next matches --tcp before failing for want of --port, which must not count
+    ParseResult result;
+    EXPECT_TRUE(parse(parser, { "x", "--tcp", "--unix" }, &result));
+    EXPECT_EQ(ParseError::NONE, result.error());
+    EXPECT_EQ("x", b);
+    EXPECT_TRUE(b_tcp);
+    EXPECT_TRUE(unix_socket);
+
+    EXPECT_TRUE(parse(parser, { "y", "--tcp", "--port", "80" }, &result));
+    EXPECT_EQ("y", a);
+    EXPECT_EQ(80, port);
+}
+
+TEST(Parser, ConstraintsMisspelledName) {
+    bool tcp = false;
+    int port = 0;
+    Parser parser;
+    parser.withOptions(Parameter(&tcp, Name("tcp"), LongForms({"tcp"}), Flag()),
+                       Parameter(&port, Name("port"), LongForms({"port"})))
+          .withConstraints(Requires("port", { "tpc" }));
+
+    ParseResult result;
+    EXPECT_FALSE(parse(parser, { "--tcp" }, &result));
+    EXPECT_EQ(ParseError::CONSTRAINT_VIOLATION, result.error());
+    EXPECT_EQ("Requires(port; tpc): unknown name tpc", result.violation());
+    EXPECT_FALSE(tcp);
+
+    // Even constraints that could never be broken by it, like an Exclusive
+    parser.withConstraints(Exclusive({ "tcp", "prot" }));
+    EXPECT_FALSE(parse(parser, { "--tcp" }, &result));
+    EXPECT_EQ("Exclusive(tcp, prot): unknown name prot", result.violation());
+}
+
 TEST(Parser, GetCurrentOptions) {
     Parser parser;
     ASSERT_EQ(0, parser.current_options().size());
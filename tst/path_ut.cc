@@ -0,0 +1,51 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/path.h"
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Gets the string representation of |value|
+template<typename T>
+std::string ToString(const T& value) {
+    std::stringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(PathFailure, Get) {
+    const PathFailure failure("input", "in.txt", PathKind::EXISTING_FILE, "does not exist");
+    EXPECT_EQ("input", failure.name());
+    EXPECT_EQ("in.txt", failure.path());
+    EXPECT_EQ(PathKind::EXISTING_FILE, failure.kind());
+    EXPECT_EQ("does not exist", failure.reason());
+}
+
+TEST(PathFailure, Equality) {
+    const PathFailure failure("input", "in.txt", PathKind::EXISTING_FILE, "does not exist");
+    EXPECT_EQ(failure, PathFailure("input", "in.txt", PathKind::EXISTING_FILE, "does not exist"));
+    EXPECT_NE(failure, PathFailure("output", "in.txt", PathKind::EXISTING_FILE, "does not exist"));
+    EXPECT_NE(failure, PathFailure("input", "in", PathKind::EXISTING_FILE, "does not exist"));
+    EXPECT_NE(failure, PathFailure("input", "in.txt", PathKind::CREATABLE, "does not exist"));
+    EXPECT_NE(failure, PathFailure("input", "in.txt", PathKind::EXISTING_FILE, "is empty"));
+}
+
+TEST(PathFailure, StreamOperator) {
+    EXPECT_EQ("Any", ToString(PathKind::ANY));
+    EXPECT_EQ("Existing File", ToString(PathKind::EXISTING_FILE));
+    EXPECT_EQ("Existing Directory", ToString(PathKind::EXISTING_DIRECTORY));
+    EXPECT_EQ("Creatable", ToString(PathKind::CREATABLE));
+    EXPECT_EQ("input: in.txt does not exist",
+              ToString(PathFailure("input", "in.txt", PathKind::EXISTING_FILE, "does not exist")));
+}
+
+} // namespace ahoy
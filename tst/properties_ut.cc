@@ -0,0 +1,107 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/properties.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace ahoy {
+
+TEST(Properties, InsertAndFind) {
+    Properties properties;
+    EXPECT_TRUE(properties.empty());
+    EXPECT_EQ(nullptr, properties.find("a"));
+    EXPECT_EQ("fallback", properties.get("a", "fallback"));
+
+    EXPECT_TRUE(properties.insert("a", "1"));
+    EXPECT_TRUE(properties.insert("b", ""));
+    EXPECT_EQ(2u, properties.size());
+    EXPECT_STREQ("1", properties.find("a"));
+    EXPECT_STREQ("", properties.find("b"));
+    EXPECT_TRUE(properties.contains("b"));
+    EXPECT_FALSE(properties.contains("c"));
+    EXPECT_EQ("1", properties.get("a", "fallback"));
+}
+
+TEST(Properties, DuplicateKeys) {
+    Properties properties;
+    EXPECT_TRUE(properties.insert("a", "1"));
+    EXPECT_TRUE(properties.insert("a", "2"));
+    EXPECT_EQ("2", properties.get("a"));
+
+    EXPECT_TRUE(properties.insert("a", "3", DuplicateKeyPolicy::FIRST_WINS));
+    EXPECT_EQ("2", properties.get("a"));
+
+    EXPECT_FALSE(properties.insert("a", "4", DuplicateKeyPolicy::REJECT));
+    EXPECT_EQ("2", properties.get("a"));
+    EXPECT_TRUE(properties.insert("b", "5", DuplicateKeyPolicy::REJECT));
+    EXPECT_EQ(2u, properties.size());
+}
+
+TEST(Properties, Borrow) {
+    const char arg[] = "name=value";
+    Properties properties;
+    EXPECT_TRUE(properties.borrow(arg, 4, arg + 5, 5));
+    EXPECT_EQ(arg + 5, properties.find("name"));
+    EXPECT_EQ(arg, properties.begin()->key);
+
+    // Copies own their strings
+    const Properties copy = properties;
+    EXPECT_EQ(properties, copy);
+    EXPECT_NE(arg + 5, copy.find("name"));
+}
+
+TEST(Properties, InsertionOrder) {
+    Properties properties;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back("key." + std::to_string(i));
+        properties.insert(keys.back(), std::to_string(i));
+    }
+    properties.insert("key.0", "replaced");
+    ASSERT_EQ(1000u, properties.size());
+
+    std::size_t i = 0;
+    for (const Properties::Entry& entry : properties) {
+        EXPECT_EQ(keys[i], entry.key_str());
+        i++;
+    }
+    EXPECT_EQ("replaced", properties.begin()->value_str());
+    EXPECT_EQ("999", properties.get("key.999"));
+}
+
+TEST(Properties, ReserveAndClear) {
+    Properties properties;
+    properties.reserve(100);
+    properties.insert("a", "1");
+    properties.clear();
+    EXPECT_TRUE(properties.empty());
+    EXPECT_FALSE(properties.contains("a"));
+    properties.insert("a", "2");
+    EXPECT_EQ("2", properties.get("a"));
+}
+
+TEST(Properties, Equality) {
+    Properties a, b;
+    EXPECT_EQ(a, b);
+    a.insert("x", "1");
+    a.insert("y", "2");
+    EXPECT_NE(a, b);
+    b.insert("y", "2");
+    b.insert("x", "1");
+    EXPECT_EQ(a, b);
+    b.insert("x", "3");
+    EXPECT_NE(a, b);
+}
+
+TEST(Properties, StreamOperator) {
+    std::ostringstream os;
+    os << DuplicateKeyPolicy::LAST_WINS << ", " << DuplicateKeyPolicy::REJECT;
+    EXPECT_EQ("Last Wins, Reject", os.str());
+}
+
+} // namespace ahoy
@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+#include "ahoy/reloader.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const char kProgram[] = "./program";
+
+struct Config {
+    Config() : port(80), host("localhost") {}
+
+    int port;
+    std::string host;
+};
+
+ahoy::Parser ConfigParser(Config* config) {
+    return ahoy::Parser().withOptions(
+            ahoy::Parameter(&config->port, ahoy::LongForms({"port"})),
+            ahoy::Parameter(&config->host, ahoy::LongForms({"host"})));
+}
+
+} // namespace
+
+namespace ahoy {
+
+TEST(Reloader, Reload) {
+    Reloader<Config> reloader(&ConfigParser);
+    const Config& initial = reloader.Get();
+    EXPECT_EQ(80, initial.port);
+    EXPECT_EQ(0u, reloader.version());
+
+    EXPECT_TRUE(reloader.Reload({ kProgram, "--port", "8080", "--host", "remote" }));
+    EXPECT_EQ(8080, reloader.Get().port);
+    EXPECT_EQ("remote", reloader.Get().host);
+    EXPECT_EQ(1u, reloader.version());
+
+    // Replaced snapshots are left untouched
+    EXPECT_EQ(80, initial.port);
+
+    // Parameters left out go back to their defaults
+    const char* argv[] = { kProgram, "--port", "9090" };
+    EXPECT_TRUE(reloader.Reload(3, argv));
+    EXPECT_EQ(9090, reloader.Get().port);
+    EXPECT_EQ("localhost", reloader.Get().host);
+    EXPECT_EQ(2u, reloader.version());
+}
+
+TEST(Reloader, InvalidKeepsSnapshot) {
+    Config defaults;
+    defaults.port = 1;
+    Reloader<Config> reloader(&ConfigParser, defaults);
+    EXPECT_TRUE(reloader.Reload({ kProgram, "--port", "2" }));
+
+    ParseResult result;
+    EXPECT_FALSE(reloader.Reload({ kProgram, "--port", "two" }, &result));
+    EXPECT_EQ(ParseError::UNMATCHED_ARGUMENT, result.error());
+    EXPECT_EQ(2, reloader.Get().port);
+    EXPECT_EQ(1u, reloader.version());
+
+    EXPECT_TRUE(reloader.Reload({ kProgram }));
+    EXPECT_EQ(1, reloader.Get().port);
+}
+
+TEST(Reloader, Reclaim) {
+    Reloader<Config> reloader(&ConfigParser);
+    EXPECT_EQ(1u, reloader.retained());
+    EXPECT_TRUE(reloader.Reload({ kProgram, "--port", "1" }));
+    EXPECT_TRUE(reloader.Reload({ kProgram, "--port", "2" }));
+    EXPECT_EQ(3u, reloader.retained());
+
+    reloader.Reclaim();
+    EXPECT_EQ(1u, reloader.retained());
+    EXPECT_EQ(2, reloader.Get().port);
+}
+
+TEST(Reloader, ConcurrentReaders) {
+    Reloader<Config> reloader(&ConfigParser);
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&reloader, &done, &torn]() {
+            while (!done.load()) {
+                // Each reload sets both members from the same number, so a reader sees them differ
+                // only if a snapshot was published before it was complete
+                const Config& config = reloader.Get();
+                const std::string expected =
+                        config.port == 80 ? "localhost" : std::to_string(config.port);
+                if (config.host != expected) {
+                    torn++;
+                }
+            }
+        });
+    }
+
+    for (int i = 1; i <= 200; i++) {
+        const std::string value = std::to_string(1000 + i);
+        EXPECT_TRUE(reloader.Reload({ kProgram, "--port", value, "--host", value }));
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(200u, reloader.version());
+    EXPECT_EQ(1200, reloader.Get().port);
+}
+
+} // namespace ahoy
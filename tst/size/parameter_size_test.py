@@ -0,0 +1,68 @@
+# Copyright (c) 2018 Dustin Toff
+# Licensed under Apache License v2.0
+
+"""Reports the bytes of machine code that 1,000 Parameter constructions compile to.
+
+Compares the executable sections of two builds of parameters.cc that construct different numbers of
+parameters, and fails if the difference per 1,000 parameters exceeds a budget:
+
+    python tst/size/parameter_size_test.py --baseline parameters_20 --baseline-parameters 20 \\
+        --measured parameters_1020 --measured-parameters 1020 --budget 300000
+"""
+
+import argparse
+import struct
+import sys
+
+# Section header flag of sections that hold machine code
+SHF_EXECINSTR = 0x4
+
+
+def text_bytes(path):
+    """Sums the sizes of the executable sections of the ELF file at path."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        raise ValueError('%s is not an ELF file' % path)
+    is_64 = elf[4] == 2
+    order = '<' if elf[5] == 1 else '>'
+    if is_64:
+        shoff, = struct.unpack_from(order + 'Q', elf, 0x28)
+        shentsize, shnum = struct.unpack_from(order + 'HH', elf, 0x3A)
+        header = order + 'IIQQQQ'
+    else:
+        shoff, = struct.unpack_from(order + 'I', elf, 0x20)
+        shentsize, shnum = struct.unpack_from(order + 'HH', elf, 0x2E)
+        header = order + 'IIIIII'
+
+    total = 0
+    for i in range(shnum):
+        _, _, flags, _, _, size = struct.unpack_from(header, elf, shoff + i * shentsize)
+        if flags & SHF_EXECINSTR:
+            total += size
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--baseline', required=True)
+    parser.add_argument('--baseline-parameters', type=int, required=True)
+    parser.add_argument('--measured', required=True)
+    parser.add_argument('--measured-parameters', type=int, required=True)
+    parser.add_argument('--budget', type=int, required=True,
+                        help='Most text bytes allowed per 1,000 parameters')
+    args = parser.parse_args()
+
+    parameters = args.measured_parameters - args.baseline_parameters
+    growth = text_bytes(args.measured) - text_bytes(args.baseline)
+    per_thousand = growth * 1000 // parameters
+    print('Text bytes per 1,000 parameters: %d (budget %d)' % (per_thousand, args.budget))
+    if per_thousand > args.budget:
+        print('Parameter construction grew past its budget')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
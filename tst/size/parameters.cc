@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Dustin Toff
+// Licensed under Apache License v2.0
+
+// Constructs AHOY_SIZE_PARAMETERS parameters, a multiple of 20, from twenty combinations of storage
+// types and options in different orders, each at its own call site like in a program with that many
+// parameters. Comparing the code of builds with different counts measures the code the Parameter
+// constructors compile to, apart from the library itself.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ahoy/ahoy_all.h"
+
+#ifndef AHOY_SIZE_PARAMETERS
+#error "AHOY_SIZE_PARAMETERS must be defined"
+#endif
+
+namespace {
+
+enum class Mode { FAST, SLOW };
+
+// The storage of the parameters of one copy of AddParameters. Every copy has its own, like every
+// parameter of a program would, which keeps the compiler from folding the copies together.
+template<int Copy>
+struct Storage {
+    static bool flag;
+    static int number;
+    static unsigned int count;
+    static double ratio;
+    static std::uint64_t bytes;
+    static std::string text;
+    static std::chrono::milliseconds timeout;
+    static Mode mode;
+    static std::vector<int> numbers;
+    static std::vector<std::string> texts;
+    static ahoy::Properties properties;
+};
+
+template<int Copy> bool Storage<Copy>::flag;
+template<int Copy> int Storage<Copy>::number;
+template<int Copy> unsigned int Storage<Copy>::count;
+template<int Copy> double Storage<Copy>::ratio;
+template<int Copy> std::uint64_t Storage<Copy>::bytes;
+template<int Copy> std::string Storage<Copy>::text;
+template<int Copy> std::chrono::milliseconds Storage<Copy>::timeout;
+template<int Copy> Mode Storage<Copy>::mode;
+template<int Copy> std::vector<int> Storage<Copy>::numbers;
+template<int Copy> std::vector<std::string> Storage<Copy>::texts;
+template<int Copy> ahoy::Properties Storage<Copy>::properties;
+
+// Adds twenty parameters to |parameters|, one of each combination, at call sites of their own
+template<int Copy>
+void AddParameters(std::vector<ahoy::Parameter>* parameters) {
+    typedef Storage<Copy> S;
+    parameters->push_back(ahoy::Parameter(&S::flag, ahoy::Name("flag"), ahoy::Flag()));
+    parameters->push_back(ahoy::Parameter(&S::flag, ahoy::ShortForms({"f"}),
+                                          ahoy::LongForms({"flag"}), ahoy::Description("A flag"),
+                                          ahoy::Flag()));
+    parameters->push_back(ahoy::Parameter(&S::flag, ahoy::Flag(), ahoy::LongForms({"flag"}),
+                                          ahoy::EnvVar("FLAG")));
+    parameters->push_back(ahoy::Parameter(&S::number, ahoy::Name("number"),
+                                          ahoy::LongForms({"number"})));
+    parameters->push_back(ahoy::Parameter(&S::number, ahoy::LongForms({"number"}),
+                                          ahoy::Name("number"), ahoy::Required()));
+    parameters->push_back(ahoy::Parameter(&S::number, ahoy::ShortForms({"n"}),
+                                          ahoy::LongForms({"number"}), ahoy::Name("number"),
+                                          ahoy::Description("A number"), ahoy::Required()));
+    parameters->push_back(ahoy::Parameter(&S::number, ahoy::Choices({ { "one", 1 }, { "two", 2 } }),
+                                          ahoy::LongForms({"choice"}), ahoy::CaseInsensitive()));
+    parameters->push_back(ahoy::Parameter(&S::count, ahoy::ShortForms({"v"}), ahoy::Count()));
+    parameters->push_back(ahoy::Parameter(&S::ratio, ahoy::LongForms({"ratio"}),
+                                          ahoy::Description("A ratio")));
+    parameters->push_back(ahoy::Parameter(&S::bytes, ahoy::LongForms({"bytes"}), ahoy::ByteSize(),
+                                          ahoy::EnvVar("BYTES")));
+    parameters->push_back(ahoy::Parameter(&S::text, ahoy::Name("text")));
+    parameters->push_back(ahoy::Parameter(&S::text, ahoy::LongForms({"text"}), ahoy::ValidateUtf8(),
+                                          ahoy::Description("Some text")));
+    parameters->push_back(ahoy::Parameter(&S::text, ahoy::Name("path"), ahoy::LongForms({"path"}),
+                                          ahoy::Path(ahoy::PathKind::EXISTING_FILE)));
+    parameters->push_back(ahoy::Parameter(&S::text, ahoy::Forms({"+text"}), ahoy::Name("text"),
+                                          ahoy::EnvVar("TEXT"), ahoy::Required()));
+    parameters->push_back(ahoy::Parameter(&S::timeout, ahoy::LongForms({"timeout"}),
+                                          ahoy::Name("timeout")));
+    parameters->push_back(ahoy::Parameter(&S::mode, ahoy::LongForms({"mode"}),
+                                          ahoy::Choices({ { "fast", Mode::FAST },
+                                                          { "slow", Mode::SLOW } })));
+    parameters->push_back(ahoy::Parameter(&S::numbers, ahoy::ShortForms({"i"}),
+                                          ahoy::Name("numbers")));
+    parameters->push_back(ahoy::Parameter(&S::texts, ahoy::LongForms({"text"}), ahoy::Name("texts"),
+                                          ahoy::Description("Some texts")));
+    parameters->push_back(ahoy::Parameter(&S::properties, ahoy::ShortForms({"D"})));
+    parameters->push_back(ahoy::Parameter(&S::properties, ahoy::ShortForms({"D"}),
+                                          ahoy::OnDuplicateKey(ahoy::DuplicateKeyPolicy::REJECT),
+                                          ahoy::BorrowArgv()));
+}
+
+// Adds the parameters of |Copies| copies of AddParameters
+template<int Copies>
+struct AddCopies {
+    static void Add(std::vector<ahoy::Parameter>* parameters) {
+        AddCopies<Copies - 1>::Add(parameters);
+        AddParameters<Copies>(parameters);
+    }
+};
+
+template<>
+struct AddCopies<0> {
+    static void Add(std::vector<ahoy::Parameter>*) {}
+};
+
+} // namespace
+
+int main() {
+    std::vector<ahoy::Parameter> parameters;
+    AddCopies<AHOY_SIZE_PARAMETERS / 20>::Add(&parameters);
+    return parameters.size() == AHOY_SIZE_PARAMETERS ? 0 : 1;
+}